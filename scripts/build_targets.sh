@@ -131,4 +131,21 @@ do
     then
         exit 1
     fi
+
+    #sparse preset storage requires RAM copy of the active preset:
+    #test that variant as well on all targets which support it
+    if [[ "$TYPE" == "tests" ]]
+    then
+        if [[ $(make --no-print-directory print-DEFINES_COMMON TARGETNAME="${targets[$i]}") == *DATABASE_CONFIG_CACHE* ]]
+        then
+            make TARGETNAME="${targets[$i]}" SPARSE_PRESETS=1
+
+            result=$?
+
+            if [[ ($result -ne 0) ]]
+            then
+                exit 1
+            fi
+        fi
+    fi
 done
\ No newline at end of file
@@ -11,6 +11,11 @@ else
     DEFINES += NDEBUG
 endif
 
+ifeq ($(PROFILE), 1)
+    #measure execution time of main loop stages and interrupts
+    DEFINES += PROFILING
+endif
+
 BOARD_DIR := $(TARGETNAME)
 
 #determine the architecture, mcu and mcu family by directory in which the board dir is located
@@ -126,6 +131,20 @@ else ifeq ($(ARCH),stm32)
     DEVICE_FS=0 \
     DEVICE_HS=1 \
     EEPROM_RAM_CACHE
+else ifeq ($(ARCH),native)
+    DEFINES += \
+    __NATIVE__
+endif
+
+#keep decoded copy of the active preset in RAM only on targets which can afford it
+ifneq ($(filter $(MCU), atmega2560 at90usb1286 stm32f405 stm32f407 host), )
+    DEFINES += DATABASE_CONFIG_CACHE
+endif
+
+ifeq ($(SPARSE_PRESETS), 1)
+    #store only the values which differ from defaults in each preset
+    #requires RAM copy of the active preset
+    DEFINES += DATABASE_SPARSE_PRESETS
 endif
 
 DEFINES += OD_BOARD_$(shell echo $(BOARD_DIR) | tr 'a-z' 'A-Z')
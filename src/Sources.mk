@@ -47,15 +47,20 @@ else ifeq ($(ARCH),stm32)
     SOURCES += $(shell $(FIND) ./board/stm32/gen/$(MCU_FAMILY)/$(MCU) -regex '.*\.\(s\|c\)')
     SOURCES += $(shell $(FIND) ./board/stm32/variants/$(MCU_FAMILY) -maxdepth 1 -name "*.cpp")
     SOURCES += $(shell $(FIND) ./board/stm32/variants/$(MCU_FAMILY)/eeprom -name "*.cpp")
-    SOURCES += modules/EmuEEPROM/src/EmuEEPROM.cpp
 
     INCLUDE_DIRS += $(addprefix -I,$(shell $(FIND) ./board/stm32/gen/$(MCU_FAMILY)/common -type d -not -path "*Src*"))
     INCLUDE_DIRS += $(addprefix -I,$(shell $(FIND) ./board/stm32/gen/$(MCU_FAMILY)/$(MCU)/Drivers -type d -not -path "*Src*"))
     INCLUDE_DIRS += -I"./board/stm32/variants/$(MCU_FAMILY)/$(MCU)"
+else ifeq ($(ARCH),native)
+    #no linker script - firmware is linked as regular host executable
+    LINKER_FILE :=
 endif
 
 #common for both bootloader and application
-SOURCES += $(shell $(FIND) ./board/common -maxdepth 1 -type f -name "*.cpp")
+ifneq ($(ARCH),native)
+    SOURCES += $(shell $(FIND) ./board/common -maxdepth 1 -type f -name "*.cpp")
+endif
+
 SOURCES += $(shell $(FIND) ./board/$(ARCH)/variants/$(MCU_FAMILY)/$(MCU)/$(BOARD_DIR) -type f -name "*.cpp")
 
 ifeq ($(BOOT),1)
@@ -99,14 +104,19 @@ else
 
     ifneq ($(shell cat board/$(ARCH)/variants/$(MCU_FAMILY)/$(MCU)/$(BOARD_DIR)/Hardware.h | grep USB_MIDI_SUPPORTED), )
         SOURCES += $(shell $(FIND) ./board/$(ARCH)/usb/midi -type f -name "*.cpp")
-        SOURCES += $(shell $(FIND) ./board/common/usb/descriptors/midi -type f -name "*.cpp")
-        SOURCES += $(shell $(FIND) ./board/common/usb/descriptors/midi -type f -name "*.c")
+
+        ifneq ($(ARCH),native)
+            SOURCES += $(shell $(FIND) ./board/common/usb/descriptors/midi -type f -name "*.cpp")
+            SOURCES += $(shell $(FIND) ./board/common/usb/descriptors/midi -type f -name "*.c")
+        endif
     endif
 
     ifneq ($(shell cat board/$(ARCH)/variants/$(MCU_FAMILY)/$(MCU)/$(BOARD_DIR)/Hardware.h | grep UART_INTERFACES), )
-        SOURCES += \
-        board/$(ARCH)/uart/UART.cpp \
-        board/common/uart/UART.cpp
+        SOURCES += board/$(ARCH)/uart/UART.cpp
+
+        ifneq ($(ARCH),native)
+            SOURCES += board/common/uart/UART.cpp
+        endif
     endif
 
     ifneq ($(filter %16u2 %8u2, $(TARGETNAME)), )
@@ -115,7 +125,11 @@ else
         board/common/io/Indicators.cpp \
         usb-link/USBlink.cpp
     else
-        SOURCES += $(shell $(FIND) ./board/common/io -type f -name "*.cpp" ! -name "*Bootloader*")
+        ifneq ($(ARCH),native)
+            #native board emulates all inputs and outputs on its own
+            SOURCES += $(shell $(FIND) ./board/common/io -type f -name "*.cpp" ! -name "*Bootloader*")
+        endif
+
         SOURCES += $(shell $(FIND) ./application -maxdepth 1 -type f -name "*.cpp")
         SOURCES += $(shell $(FIND) ./application/database -type f -name "*.cpp")
         SOURCES += $(shell $(FIND) ./application/OpenDeck -type f -name "*.cpp")
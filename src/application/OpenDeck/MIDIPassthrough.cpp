@@ -0,0 +1,202 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#include "MIDIPassthrough.h"
+
+namespace
+{
+    ///
+    /// \brief Code Index Numbers used in USB MIDI event packets.
+    ///
+    enum class cin_t : uint8_t
+    {
+        systemCommon2byte = 0x02,
+        systemCommon3byte = 0x03,
+        sysExStart        = 0x04,
+        sysExStop1byte    = 0x05,
+        sysExStop2byte    = 0x06,
+        sysExStop3byte    = 0x07,
+        singleByte        = 0x0F
+    };
+
+    constexpr uint8_t SYSEX_START = 0xF0;
+    constexpr uint8_t SYSEX_END   = 0xF7;
+}    // namespace
+
+void MIDIPassthrough::process(uint8_t data)
+{
+    //real-time messages can appear anywhere and don't affect anything else
+    if (data >= 0xF8)
+    {
+        send(static_cast<uint8_t>(cin_t::singleByte), data, 0, 0);
+        return;
+    }
+
+    if (data & 0x80)
+    {
+        //any other status byte terminates SysEx which hasn't been finished properly:
+        //in that case, buffered bytes are flushed with explicit SysEx end appended
+        if (sysEx)
+            endSysEx();
+
+        reset();
+
+        if (data == SYSEX_END)
+            return;
+
+        if (data == SYSEX_START)
+        {
+            sysEx         = true;
+            this->data[0] = data;
+            dataCount     = 1;
+            return;
+        }
+
+        switch (data)
+        {
+        case 0xF1:    //MTC quarter frame
+        case 0xF3:    //song select
+            dataExpected = 1;
+            break;
+
+        case 0xF2:    //song position
+            dataExpected = 2;
+            break;
+
+        case 0xF6:    //tune request
+            send(static_cast<uint8_t>(cin_t::sysExStop1byte), data, 0, 0);
+            return;
+
+        default:
+            if (data >= 0xF0)
+            {
+                //undefined
+                return;
+            }
+
+            //program change and channel aftertouch have single data byte
+            dataExpected = ((data & 0xE0) == 0xC0) ? 1 : 2;
+            break;
+        }
+
+        status = data;
+        return;
+    }
+
+    if (sysEx)
+    {
+        this->data[dataCount++] = data;
+
+        if (dataCount == 3)
+        {
+            send(static_cast<uint8_t>(cin_t::sysExStart), this->data[0], this->data[1], this->data[2]);
+            dataCount = 0;
+        }
+
+        return;
+    }
+
+    //data without status
+    if (!status)
+        return;
+
+    this->data[dataCount++] = data;
+
+    if (dataCount < dataExpected)
+        return;
+
+    dataCount = 0;
+
+    if (status >= 0xF0)
+    {
+        send(static_cast<uint8_t>(dataExpected == 1 ? cin_t::systemCommon2byte : cin_t::systemCommon3byte), status, this->data[0], dataExpected == 2 ? this->data[1] : 0);
+
+        //system common messages cancel running status
+        status = 0;
+        return;
+    }
+
+    uint8_t channel = status & 0x0F;
+
+    if (filterChannel && (channel != (filterChannel - 1)))
+        return;
+
+    if (outputChannel)
+        channel = outputChannel - 1;
+
+    send(status >> 4, (status & 0xF0) | channel, this->data[0], dataExpected == 2 ? this->data[1] : 0);
+}
+
+void MIDIPassthrough::endSysEx()
+{
+    data[dataCount++] = SYSEX_END;
+
+    //unused bytes in packet are zeroed
+    for (uint8_t i = dataCount; i < 3; i++)
+        data[i] = 0;
+
+    send(static_cast<uint8_t>(cin_t::sysExStop1byte) + dataCount - 1, data[0], data[1], data[2]);
+}
+
+void MIDIPassthrough::reset()
+{
+    status       = 0;
+    dataCount    = 0;
+    dataExpected = 0;
+    sysEx        = false;
+}
+
+void MIDIPassthrough::setChannels(uint8_t filterChannel, uint8_t outputChannel)
+{
+    this->filterChannel = filterChannel;
+    this->outputChannel = outputChannel;
+}
+
+uint8_t MIDIPassthrough::packetSize(const MIDI::USBMIDIpacket_t& packet)
+{
+    switch (static_cast<cin_t>(packet.Event & 0x0F))
+    {
+    case cin_t::sysExStop1byte:
+    case cin_t::singleByte:
+        return 1;
+
+    case cin_t::systemCommon2byte:
+    case cin_t::sysExStop2byte:
+        return 2;
+
+    case cin_t::systemCommon3byte:
+    case cin_t::sysExStart:
+    case cin_t::sysExStop3byte:
+        return 3;
+
+    default:
+        //channel messages
+        return ((packet.Data1 & 0xE0) == 0xC0) ? 2 : 3;
+    }
+}
+
+void MIDIPassthrough::send(uint8_t cin, uint8_t data1, uint8_t data2, uint8_t data3)
+{
+    MIDI::USBMIDIpacket_t packet;
+
+    packet.Event = cin;
+    packet.Data1 = data1;
+    packet.Data2 = data2;
+    packet.Data3 = data3;
+
+    packetHandler(packet);
+}
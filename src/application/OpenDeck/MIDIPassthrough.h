@@ -0,0 +1,77 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+#pragma once
+
+#include "midi/src/MIDI.h"
+
+///
+/// \brief Converts raw MIDI byte stream into USB MIDI event packets without full message parsing.
+/// Each byte is handled as soon as it's received: running status is applied to data bytes, SysEx
+/// is split into packets as it arrives and system real-time messages are passed on immediately,
+/// even in the middle of other messages. Channel messages can optionally be filtered by channel
+/// and moved to another channel.
+///
+class MIDIPassthrough
+{
+    public:
+    using packetHandler_t = bool (*)(MIDI::USBMIDIpacket_t& packet);
+
+    ///
+    /// @param [in] packetHandler   Function called for each complete packet.
+    ///
+    MIDIPassthrough(packetHandler_t packetHandler)
+        : packetHandler(packetHandler)
+    {}
+
+    ///
+    /// \brief Passes single byte of incoming MIDI stream to the converter.
+    ///
+    void process(uint8_t data);
+
+    ///
+    /// \brief Discards partially received message and running status.
+    ///
+    void reset();
+
+    ///
+    /// \brief Configures channel handling of channel messages.
+    /// @param [in] filterChannel   Only messages on this channel (1-16) are passed on. 0 passes all channels.
+    /// @param [in] outputChannel   Channel (1-16) on which messages are passed on. 0 leaves the channel unchanged.
+    ///
+    void setChannels(uint8_t filterChannel, uint8_t outputChannel);
+
+    ///
+    /// \brief Returns number of MIDI bytes contained in specified packet.
+    ///
+    static uint8_t packetSize(const MIDI::USBMIDIpacket_t& packet);
+
+    private:
+    void endSysEx();
+    void send(uint8_t cin, uint8_t data1, uint8_t data2, uint8_t data3);
+
+    packetHandler_t packetHandler;
+
+    uint8_t status       = 0;
+    uint8_t data[3]      = {};
+    uint8_t dataCount    = 0;
+    uint8_t dataExpected = 0;
+    bool    sysEx        = false;
+
+    uint8_t filterChannel = 0;
+    uint8_t outputChannel = 0;
+};
@@ -0,0 +1,617 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "MIDIScheduler.h"
+#include "core/src/general/Timing.h"
+
+namespace
+{
+    ///
+    /// \brief Controllers used to send NRPN messages.
+    /// @{
+
+    constexpr uint8_t NRPN_PARAM_MSB = 99;
+    constexpr uint8_t NRPN_PARAM_LSB = 98;
+    constexpr uint8_t DATA_ENTRY_MSB = 6;
+    constexpr uint8_t DATA_ENTRY_LSB = 38;
+    constexpr uint8_t DATA_INCREMENT = 96;
+    constexpr uint8_t DATA_DECREMENT = 97;
+    constexpr uint8_t RPN_PARAM_LSB  = 100;
+    constexpr uint8_t RPN_PARAM_MSB  = 101;
+
+    /// @}
+
+    ///
+    /// \brief Value used to indicate that NRPN parameter isn't known to be selected.
+    ///
+    constexpr uint16_t NO_PARAM = 0xFFFF;
+
+    ///
+    /// \brief Checks whether the controller changes the parameter targeted by data entry messages.
+    ///
+    bool isParamSelect(uint8_t controller)
+    {
+        switch (controller)
+        {
+        case NRPN_PARAM_MSB:
+        case NRPN_PARAM_LSB:
+        case RPN_PARAM_LSB:
+        case RPN_PARAM_MSB:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    ///
+    /// \brief Checks whether the controller is part of (N)RPN message.
+    /// Meaning of these depends on the parameter selected before them so they can't
+    /// be coalesced by controller number: they are always sent in the order received.
+    ///
+    bool isParamControl(uint8_t controller)
+    {
+        switch (controller)
+        {
+        case DATA_ENTRY_MSB:
+        case DATA_ENTRY_LSB:
+        case DATA_INCREMENT:
+        case DATA_DECREMENT:
+            return true;
+
+        default:
+            return isParamSelect(controller);
+        }
+    }
+
+    ///
+    /// \brief Returns number of data bytes which follow specified status byte.
+    ///
+    uint8_t dataBytes(uint8_t status)
+    {
+        switch (status & 0xF0)
+        {
+        case 0xC0:
+        case 0xD0:
+            return 1;
+
+        case 0xF0:
+        {
+            switch (status)
+            {
+            case 0xF1:
+            case 0xF3:
+                return 1;
+
+            case 0xF2:
+                return 2;
+
+            default:
+                return 0;
+            }
+        }
+
+        default:
+            return 2;
+        }
+    }
+}    // namespace
+
+bool MIDIScheduler::write(uint8_t data)
+{
+    queueFull = false;
+    process(data);
+
+    return !queueFull;
+}
+
+void MIDIScheduler::process(uint8_t data)
+{
+    if (data >= 0xF8)
+    {
+        //real-time messages can appear anywhere, even inside other messages:
+        //pass them on immediately and queue them only if the link can't accept them
+        if (!writeHandler(data))
+            pushMessage(data, 0, 0, 1);
+
+        return;
+    }
+
+    if (data & 0x80)
+    {
+        inSysEx     = (data == 0xF0);
+        inDataCount = 0;
+
+        if (inSysEx || (data == 0xF7))
+        {
+            releaseNRPN();
+            inStatus = 0;
+            pushMessage(data, 0, 0, 1);
+            return;
+        }
+
+        inStatus       = data;
+        inDataExpected = dataBytes(data);
+
+        if (!inDataExpected)
+        {
+            releaseNRPN();
+            pushMessage(data, 0, 0, 1);
+            inStatus = 0;
+        }
+
+        return;
+    }
+
+    if (inSysEx)
+    {
+        pushMessage(data, 0, 0, 1);
+        return;
+    }
+
+    //data byte without status: nothing to do
+    if (!inStatus)
+        return;
+
+    inData[inDataCount++] = data;
+
+    if (inDataCount == inDataExpected)
+    {
+        dispatch();
+        inDataCount = 0;
+
+        //running status is valid for channel messages only
+        if (inStatus >= 0xF0)
+            inStatus = 0;
+    }
+}
+
+void MIDIScheduler::update()
+{
+    //NRPN sequences are always written at once so anything incomplete at this point is just a regular controller
+    releaseNRPN();
+    drain();
+}
+
+void MIDIScheduler::reset()
+{
+    for (size_t i = 0; i < MIDI_SCHEDULER_SLOTS; i++)
+        slots[i].pending = false;
+
+    queueHead   = 0;
+    queueCount  = 0;
+    inStatus    = 0;
+    inDataCount = 0;
+    inSysEx     = false;
+    nrpnState   = nrpnState_t::none;
+    nrpnSlot    = -1;
+    lastStatus  = 0;
+
+    for (size_t i = 0; i < 16; i++)
+    {
+        inParam[i]  = NO_PARAM;
+        outParam[i] = NO_PARAM;
+    }
+}
+
+void MIDIScheduler::setRunningStatusState(bool state)
+{
+    runningStatus = state;
+    lastStatus    = 0;
+}
+
+void MIDIScheduler::dispatch()
+{
+    uint8_t channel = inStatus & 0x0F;
+
+    switch (inStatus & 0xF0)
+    {
+    case 0xB0:
+    {
+        controlChange(channel, inData[0], inData[1]);
+    }
+    break;
+
+    case 0xE0:
+    {
+        releaseNRPN();
+
+        if (coalesce(slotType_t::pitchBend, channel, 0, inData[0], inData[1]) < 0)
+            pushMessage(inStatus, inData[0], inData[1], 3);
+    }
+    break;
+
+    default:
+    {
+        releaseNRPN();
+        pushMessage(inStatus, inData[0], inData[1], inDataExpected + 1);
+    }
+    break;
+    }
+}
+
+void MIDIScheduler::controlChange(uint8_t channel, uint8_t controller, uint8_t value)
+{
+    bool sameChannel = (channel == nrpnChannel);
+
+    if (controller == NRPN_PARAM_MSB)
+    {
+        releaseNRPN();
+
+        nrpnState        = nrpnState_t::paramMSB;
+        nrpnChannel      = channel;
+        nrpnParam[0]     = value;
+        inParam[channel] = NO_PARAM;
+        return;
+    }
+
+    if ((controller == NRPN_PARAM_LSB) && sameChannel && (nrpnState == nrpnState_t::paramMSB))
+    {
+        nrpnState        = nrpnState_t::paramLSB;
+        nrpnParam[1]     = value;
+        inParam[channel] = (nrpnParam[0] << 7) | nrpnParam[1];
+        return;
+    }
+
+    if ((controller == DATA_ENTRY_MSB) && (inParam[channel] != NO_PARAM) && !(sameChannel && (nrpnState == nrpnState_t::paramLSB)))
+    {
+        //data entry for parameter which has already been selected earlier:
+        //handle it as complete NRPN message since selection on the link can be different by the time it's sent
+        releaseNRPN();
+
+        nrpnState    = nrpnState_t::paramLSB;
+        nrpnChannel  = channel;
+        nrpnParam[0] = (inParam[channel] >> 7) & 0x7F;
+        nrpnParam[1] = inParam[channel] & 0x7F;
+        sameChannel  = true;
+    }
+
+    if ((controller == DATA_ENTRY_MSB) && sameChannel && (nrpnState == nrpnState_t::paramLSB))
+    {
+        nrpnState = nrpnState_t::value;
+        nrpnSlot  = coalesce(slotType_t::nrpn, channel, (nrpnParam[0] << 7) | nrpnParam[1], value, 0);
+
+        if (nrpnSlot < 0)
+        {
+            pushMessage(0xB0 | channel, NRPN_PARAM_MSB, nrpnParam[0], 3);
+            pushMessage(0xB0 | channel, NRPN_PARAM_LSB, nrpnParam[1], 3);
+            pushMessage(0xB0 | channel, DATA_ENTRY_MSB, value, 3);
+        }
+        else
+        {
+            slots[nrpnSlot].hasLSB = false;
+        }
+
+        return;
+    }
+
+    if ((controller == DATA_ENTRY_LSB) && sameChannel && (nrpnState == nrpnState_t::value))
+    {
+        nrpnState = nrpnState_t::none;
+
+        if (nrpnSlot < 0)
+        {
+            pushMessage(0xB0 | channel, DATA_ENTRY_LSB, value, 3);
+        }
+        else
+        {
+            slots[nrpnSlot].value[1] = value;
+            slots[nrpnSlot].hasLSB   = true;
+        }
+
+        return;
+    }
+
+    releaseNRPN();
+
+    if (isParamSelect(controller))
+        inParam[channel] = NO_PARAM;
+
+    if (isParamControl(controller))
+    {
+        //RPN messages and data entry without known NRPN selection
+        pushMessage(0xB0 | channel, controller, value, 3);
+        return;
+    }
+
+    if (coalesce(slotType_t::controlChange, channel, controller, value, 0) < 0)
+        pushMessage(0xB0 | channel, controller, value, 3);
+}
+
+int16_t MIDIScheduler::coalesce(slotType_t type, uint8_t channel, uint16_t id, uint8_t value0, uint8_t value1)
+{
+    int16_t freeSlot = -1;
+
+    for (size_t i = 0; i < MIDI_SCHEDULER_SLOTS; i++)
+    {
+        auto& slot = slots[i];
+
+        if (!slot.pending)
+        {
+            if (freeSlot < 0)
+                freeSlot = i;
+
+            continue;
+        }
+
+        if ((slot.type == type) && (slot.channel == channel) && (slot.id == id))
+        {
+            //destination is already waiting in queue: only update the value
+            slot.value[0] = value0;
+            slot.value[1] = value1;
+            requeue(i);
+            return i;
+        }
+    }
+
+    if (freeSlot < 0)
+        return -1;
+
+    auto& slot = slots[freeSlot];
+
+    slot.pending  = true;
+    slot.type     = type;
+    slot.channel  = channel;
+    slot.id       = id;
+    slot.value[0] = value0;
+    slot.value[1] = value1;
+    slot.hasLSB   = false;
+
+    entry_t entry = {};
+    entry.data[0] = freeSlot;
+    entry.size    = 0;
+
+    if (!push(entry))
+    {
+        slot.pending = false;
+        return -1;
+    }
+
+    return freeSlot;
+}
+
+void MIDIScheduler::requeue(uint8_t slot)
+{
+    size_t position = queueCount;
+
+    for (size_t i = 0; i < queueCount; i++)
+    {
+        auto& entry = queue[(queueHead + i) % MIDI_SCHEDULER_QUEUE_SIZE];
+
+        if (!entry.size && (entry.data[0] == slot))
+        {
+            position = i;
+            break;
+        }
+    }
+
+    if (position == queueCount)
+        return;
+
+    //other destinations can stay behind the updated one since their order doesn't matter,
+    //but newer value can't overtake any other message
+    bool ordered = false;
+
+    for (size_t i = position + 1; i < queueCount; i++)
+    {
+        if (queue[(queueHead + i) % MIDI_SCHEDULER_QUEUE_SIZE].size)
+        {
+            ordered = true;
+            break;
+        }
+    }
+
+    if (!ordered)
+        return;
+
+    entry_t entry = queue[(queueHead + position) % MIDI_SCHEDULER_QUEUE_SIZE];
+
+    for (size_t i = position + 1; i < queueCount; i++)
+        queue[(queueHead + i - 1) % MIDI_SCHEDULER_QUEUE_SIZE] = queue[(queueHead + i) % MIDI_SCHEDULER_QUEUE_SIZE];
+
+    queue[(queueHead + queueCount - 1) % MIDI_SCHEDULER_QUEUE_SIZE] = entry;
+}
+
+void MIDIScheduler::releaseNRPN()
+{
+    //parameter selection without data entry: send the controllers as they are
+    switch (nrpnState)
+    {
+    case nrpnState_t::paramMSB:
+    case nrpnState_t::paramLSB:
+    {
+        auto    state   = nrpnState;
+        uint8_t channel = nrpnChannel;
+
+        nrpnState = nrpnState_t::none;
+
+        pushMessage(0xB0 | channel, NRPN_PARAM_MSB, nrpnParam[0], 3);
+
+        if (state == nrpnState_t::paramLSB)
+            pushMessage(0xB0 | channel, NRPN_PARAM_LSB, nrpnParam[1], 3);
+    }
+    break;
+
+    default:
+    {
+        nrpnState = nrpnState_t::none;
+    }
+    break;
+    }
+
+    nrpnSlot = -1;
+}
+
+bool MIDIScheduler::push(const entry_t& entry)
+{
+    //queue full: wait for the link, but only for limited time so that stalled link can't block the caller
+    if ((queueCount >= MIDI_SCHEDULER_QUEUE_SIZE) && !queueFull)
+    {
+        uint32_t start = core::timing::currentRunTimeMs();
+
+        while ((queueCount >= MIDI_SCHEDULER_QUEUE_SIZE) && ((core::timing::currentRunTimeMs() - start) < MIDI_SCHEDULER_PUSH_TIMEOUT))
+            drain();
+    }
+
+    if (queueCount >= MIDI_SCHEDULER_QUEUE_SIZE)
+    {
+        queueFull = true;
+        return false;
+    }
+
+    queue[(queueHead + queueCount) % MIDI_SCHEDULER_QUEUE_SIZE] = entry;
+    queueCount++;
+
+    return true;
+}
+
+void MIDIScheduler::pushMessage(uint8_t status, uint8_t data1, uint8_t data2, uint8_t size)
+{
+    entry_t entry;
+
+    entry.data[0] = status;
+    entry.data[1] = data1;
+    entry.data[2] = data2;
+    entry.size    = size;
+
+    push(entry);
+}
+
+void MIDIScheduler::drain()
+{
+    size_t space = spaceHandler();
+
+    while (queueCount)
+    {
+        auto&  entry = queue[queueHead];
+        size_t size  = entrySize(entry);
+        bool   sent  = true;
+
+        if (size > space)
+            break;
+
+        if (entry.size)
+        {
+            sent = send(entry.data[0], entry.data[1], entry.data[2], entry.size);
+        }
+        else
+        {
+            auto&   slot   = slots[entry.data[0]];
+            uint8_t status = (slot.type == slotType_t::pitchBend ? 0xE0 : 0xB0) | slot.channel;
+
+            switch (slot.type)
+            {
+            case slotType_t::nrpn:
+            {
+                if (outParam[slot.channel] != slot.id)
+                {
+                    sent = send(status, NRPN_PARAM_MSB, (slot.id >> 7) & 0x7F, 3) && send(status, NRPN_PARAM_LSB, slot.id & 0x7F, 3);
+
+                    if (sent)
+                        outParam[slot.channel] = slot.id;
+                }
+
+                if (sent)
+                    sent = send(status, DATA_ENTRY_MSB, slot.value[0], 3);
+
+                if (sent && slot.hasLSB)
+                    sent = send(status, DATA_ENTRY_LSB, slot.value[1], 3);
+            }
+            break;
+
+            case slotType_t::pitchBend:
+            {
+                sent = send(status, slot.value[0], slot.value[1], 3);
+            }
+            break;
+
+            default:
+            {
+                sent = send(status, slot.id, slot.value[0], 3);
+            }
+            break;
+            }
+
+            if (sent)
+                slot.pending = false;
+        }
+
+        if (!sent)
+        {
+            //link refused the data even though it reported enough space: keep the entry and
+            //send it again in full later - receiver discards any incomplete part on new status byte
+            lastStatus = 0;
+            break;
+        }
+
+        space -= size;
+        queueHead  = (queueHead + 1) % MIDI_SCHEDULER_QUEUE_SIZE;
+        queueCount--;
+    }
+}
+
+size_t MIDIScheduler::pendingBytes()
+{
+    size_t size = 0;
+
+    for (size_t i = 0; i < queueCount; i++)
+        size += entrySize(queue[(queueHead + i) % MIDI_SCHEDULER_QUEUE_SIZE]);
+
+    return size;
+}
+
+size_t MIDIScheduler::entrySize(const entry_t& entry)
+{
+    if (entry.size)
+        return entry.size;
+
+    auto& slot = slots[entry.data[0]];
+
+    if (slot.type == slotType_t::nrpn)
+        return slot.hasLSB ? 12 : 9;
+
+    return 3;
+}
+
+bool MIDIScheduler::send(uint8_t status, uint8_t data1, uint8_t data2, uint8_t size)
+{
+    if ((status >= 0xF8) || !(status & 0x80))
+    {
+        //real-time messages and SysEx data don't affect running status
+        return writeHandler(status);
+    }
+
+    if (!runningStatus || (status >= 0xF0) || (status != lastStatus))
+    {
+        if (!writeHandler(status))
+            return false;
+    }
+
+    lastStatus = (status < 0xF0) ? status : 0;
+
+    if (((status & 0xF0) == 0xB0) && isParamSelect(data1))
+        outParam[status & 0x0F] = NO_PARAM;
+
+    if ((size > 1) && !writeHandler(data1))
+        return false;
+
+    if ((size > 2) && !writeHandler(data2))
+        return false;
+
+    return true;
+}
@@ -0,0 +1,204 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include <stddef.h>
+
+///
+/// \brief Total number of continuous controller destinations which can wait to be sent at the same time.
+///
+#ifndef MIDI_SCHEDULER_SLOTS
+#define MIDI_SCHEDULER_SLOTS 16
+#endif
+
+///
+/// \brief Total number of outgoing messages (or individual SysEx bytes) which can wait to be sent.
+///
+#ifndef MIDI_SCHEDULER_QUEUE_SIZE
+#define MIDI_SCHEDULER_QUEUE_SIZE 32
+#endif
+
+///
+/// \brief Maximum time in milliseconds spent waiting for the link when the outgoing queue is full.
+/// Message which can't be queued within this time is dropped.
+///
+#ifndef MIDI_SCHEDULER_PUSH_TIMEOUT
+#define MIDI_SCHEDULER_PUSH_TIMEOUT 5
+#endif
+
+///
+/// \brief Outgoing MIDI byte stream scheduler for slow serial links.
+/// Control change, NRPN and pitch bend messages which are still waiting to be sent are replaced
+/// with newer values for the same destination (channel and controller) instead of being queued,
+/// so that the backlog can't grow beyond the number of destinations in use. Updated destination
+/// is moved behind any other message queued after it so that the newer value is never sent ahead
+/// of it. RPN messages and data entry controllers which don't follow complete NRPN selection
+/// are never coalesced since their meaning depends on the parameter selected before them.
+/// System real-time messages are passed on to the link immediately, ahead of everything
+/// waiting in queue. All other messages are sent in order, unmodified. Data is passed on only when the link can accept it without blocking.
+///
+class MIDIScheduler
+{
+    public:
+    using writeHandler_t = bool (*)(uint8_t data);
+    using spaceHandler_t = size_t (*)();
+
+    ///
+    /// @param [in] writeHandler    Function used to write single byte to the link. System real-time
+    ///                             bytes are written regardless of the available space, and
+    ///                             handler should send them with priority if possible. Returning
+    ///                             false for them makes the scheduler queue them instead.
+    /// @param [in] spaceHandler    Function returning number of bytes which can be written to the link without blocking.
+    ///
+    MIDIScheduler(writeHandler_t writeHandler, spaceHandler_t spaceHandler)
+        : writeHandler(writeHandler)
+        , spaceHandler(spaceHandler)
+    {
+        reset();
+    }
+
+    ///
+    /// \brief Passes single byte of outgoing MIDI stream to the scheduler.
+    /// Blocks only if the outgoing queue is full, for MIDI_SCHEDULER_PUSH_TIMEOUT milliseconds at most.
+    /// \returns True on success, false if the message had to be dropped because the queue stayed full.
+    ///
+    bool write(uint8_t data);
+
+    ///
+    /// \brief Sends as much of waiting data as the link can accept without blocking.
+    /// If the link refuses the data, the message is sent again in full on next call.
+    ///
+    void update();
+
+    ///
+    /// \brief Discards all waiting data and resets the parser.
+    ///
+    void reset();
+
+    ///
+    /// \brief Enables or disables running status on the link.
+    ///
+    void setRunningStatusState(bool state);
+
+    ///
+    /// \brief Returns number of bytes waiting in outgoing queue.
+    /// Running status isn't taken into account, so this is the upper bound.
+    ///
+    size_t pendingBytes();
+
+    private:
+    enum class slotType_t : uint8_t
+    {
+        controlChange,
+        nrpn,
+        pitchBend
+    };
+
+    ///
+    /// \brief Holds latest value for a single destination.
+    ///
+    typedef struct
+    {
+        bool       pending;
+        slotType_t type;
+        uint8_t    channel;
+        uint16_t   id;          ///< Controller or NRPN number, not used for pitch bend.
+        uint8_t    value[2];    ///< Value (or MSB and LSB of value for 14-bit messages).
+        bool       hasLSB;      ///< Whether the NRPN value contains LSB (CC 38).
+    } slot_t;
+
+    ///
+    /// \brief Single entry in outgoing queue.
+    /// Entry with size set to 0 references slot whose index is stored in first data byte.
+    ///
+    typedef struct
+    {
+        uint8_t data[3];
+        uint8_t size;
+    } entry_t;
+
+    ///
+    /// \brief State of NRPN sequence (CC 99, 98, 6 and optionally 38) detection.
+    ///
+    enum class nrpnState_t : uint8_t
+    {
+        none,
+        paramMSB,
+        paramLSB,
+        value
+    };
+
+    void    process(uint8_t data);
+    void    dispatch();
+    void    controlChange(uint8_t channel, uint8_t controller, uint8_t value);
+    int16_t coalesce(slotType_t type, uint8_t channel, uint16_t id, uint8_t value0, uint8_t value1);
+    void    requeue(uint8_t slot);
+    void    releaseNRPN();
+    bool    push(const entry_t& entry);
+    void    pushMessage(uint8_t status, uint8_t data1, uint8_t data2, uint8_t size);
+    void    drain();
+    size_t  entrySize(const entry_t& entry);
+    bool    send(uint8_t status, uint8_t data1, uint8_t data2, uint8_t size);
+
+    writeHandler_t writeHandler;
+    spaceHandler_t spaceHandler;
+
+    slot_t  slots[MIDI_SCHEDULER_SLOTS] = {};
+    entry_t queue[MIDI_SCHEDULER_QUEUE_SIZE];
+    size_t  queueHead  = 0;
+    size_t  queueCount = 0;
+
+    ///
+    /// \brief Set once a message has been dropped because of full queue while processing current byte.
+    /// Further messages are then dropped right away instead of waiting for the link again.
+    ///
+    bool queueFull = false;
+
+    ///
+    /// \brief Parser state for incoming byte stream.
+    /// @{
+
+    uint8_t inStatus       = 0;
+    uint8_t inData[2]      = {};
+    uint8_t inDataCount    = 0;
+    uint8_t inDataExpected = 0;
+    bool    inSysEx        = false;
+
+    /// @}
+
+    nrpnState_t nrpnState    = nrpnState_t::none;
+    uint8_t     nrpnChannel  = 0;
+    uint8_t     nrpnParam[2] = {};
+    int16_t     nrpnSlot     = -1;
+
+    ///
+    /// \brief Last NRPN parameter selected on each channel in incoming and outgoing stream.
+    /// Used to attribute data entry messages sent without parameter selection to the right
+    /// parameter, and to skip parameter selection on the link if it's already selected.
+    /// @{
+
+    uint16_t inParam[16];
+    uint16_t outParam[16];
+
+    /// @}
+
+    bool    runningStatus = false;
+    uint8_t lastStatus    = 0;
+};
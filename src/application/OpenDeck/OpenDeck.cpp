@@ -17,7 +17,9 @@ limitations under the License.
 */
 
 #include "OpenDeck.h"
+#include "Profiling.h"
 #include "board/Board.h"
+#include "core/src/general/Helpers.h"
 #include "core/src/general/Timing.h"
 #include "core/src/general/Interrupt.h"
 #include "core/src/general/Reset.h"
@@ -25,6 +27,7 @@ limitations under the License.
 #include "core/src/general/I2C.h"
 #endif
 #include "io/common/CInfo.h"
+#include "common/OpenDeckMIDIformat/OpenDeckMIDIformat.h"
 
 class DBhandlers : public Database::Handlers
 {
@@ -237,13 +240,56 @@ class HWAButtons : public IO::Buttons::HWA
 
     bool state(size_t index) override
     {
+        if (!encoderMaskBuilt || (encoderMaskRevision != database.revision(Database::block_t::encoders)))
+            buildEncoderMask();
+
         //if encoder under this index is enabled, just return false state each time
-        //side note: don't bother with references to dependencies here, just use global database object
-        if (database.read(Database::Section::encoder_t::enable, Board::io::getEncoderPair(index)))
+        if (BIT_READ(encoderMask[index / 8], index % 8))
             return false;
 
         return Board::io::getButtonState(index);
     }
+
+    uint8_t packedState(size_t arrayIndex) override
+    {
+        if (!encoderMaskBuilt || (encoderMaskRevision != database.revision(Database::block_t::encoders)))
+            buildEncoderMask();
+
+        return Board::io::getButtonStates(arrayIndex) & ~encoderMask[arrayIndex];
+    }
+
+    private:
+    ///
+    /// \brief Builds mask of all buttons which are used as encoders.
+    /// Masked buttons always report released state.
+    ///
+    void buildEncoderMask()
+    {
+        for (size_t i = 0; i < maskSize; i++)
+        {
+            encoderMask[i] = 0;
+
+            for (size_t j = 0; j < 8; j++)
+            {
+                size_t index = i * 8 + j;
+
+                if (index >= MAX_NUMBER_OF_BUTTONS)
+                    break;
+
+                if (database.read(Database::Section::encoder_t::enable, Board::io::getEncoderPair(index)))
+                    BIT_WRITE(encoderMask[i], j, true);
+            }
+        }
+
+        encoderMaskRevision = database.revision(Database::block_t::encoders);
+        encoderMaskBuilt    = true;
+    }
+
+    static constexpr size_t maskSize = (MAX_NUMBER_OF_BUTTONS + 7) / 8;
+
+    uint8_t  encoderMask[maskSize] = {};
+    uint32_t encoderMaskRevision   = 0;
+    bool     encoderMaskBuilt      = false;
 } hwaButtons;
 
 class HWAAnalog : public IO::Analog::HWA
@@ -341,6 +387,10 @@ void OpenDeck::init()
 {
     Board::init();
 
+#ifdef PROFILING
+    Profiling::init();
+#endif
+
     database.init();
     sysConfig.init();
     leds.init();
@@ -360,6 +410,8 @@ void OpenDeck::init()
     };
 
     dbHandlers.presetChangeHandler = [](uint8_t preset) {
+        //receivers could have been reconfigured for new preset
+        IO::Common::resetNRPNselection();
         leds.midiToState(MIDI::messageType_t::programChange, preset, 0, 0, true);
 
 #ifdef DISPLAY_SUPPORTED
@@ -393,6 +445,7 @@ void OpenDeck::init()
     //don't configure this handler before initializing database to avoid mcu reset if
     //factory reset is needed initially
     dbHandlers.factoryResetDoneHandler = []() {
+        Board::eeprom::flush();
         core::reset::mcuReset();
     };
 
@@ -413,6 +466,11 @@ void OpenDeck::init()
 #endif
     };
 
+#ifndef USB_MIDI_SUPPORTED
+    //USB link will respond only if it supports framed format
+    OpenDeckMIDIformat::requestFraming(UART_USB_LINK_CHANNEL);
+#endif
+
     Board::io::ledFlashStartup(Board::checkNewRevision());
 }
 
@@ -422,20 +480,20 @@ void OpenDeck::checkComponents()
     {
         if (Board::io::isInputDataAvailable())
         {
-            buttons.update();
-            encoders.update();
+            PROFILE_STAGE(buttons, PROFILE_LATENCY(buttons, Board::io::inputDataTimestamp(), buttons.update()));
+            PROFILE_STAGE(encoders, PROFILE_LATENCY(encoders, Board::io::inputDataTimestamp(), encoders.update()));
         }
 
         if (Board::io::isAnalogDataAvailable())
-            analog.update();
+            PROFILE_STAGE(analog, PROFILE_LATENCY(analog, Board::io::analogDataTimestamp(), analog.update()));
 
-        leds.checkBlinking();
+        PROFILE_STAGE(leds, leds.checkBlinking());
 #ifdef DISPLAY_SUPPORTED
-        display.update();
+        PROFILE_STAGE(display, display.update());
 #endif
 
 #ifdef TOUCHSCREEN_SUPPORTED
-        touchscreen.update();
+        PROFILE_STAGE(touchscreen, touchscreen.update());
 #endif
     }
 }
@@ -496,6 +554,10 @@ void OpenDeck::checkMIDI()
 
             if (messageType == MIDI::messageType_t::controlChange)
             {
+                //parameter selected by someone else could be forwarded to receivers
+                if ((data1 == 99) || (data1 == 98))
+                    IO::Common::resetNRPNselection();
+
                 for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
                 {
                     if (!database.read(Database::Section::encoder_t::remoteSync, i))
@@ -529,11 +591,81 @@ void OpenDeck::checkMIDI()
         }
     };
 
+#ifndef USB_MIDI_SUPPORTED
+    //SysEx request received from USB link which is waiting for space for the response
+    static bool     sysExDeferred  = false;
+    static uint32_t sysExDeferTime = 0;
+
+    //credit from USB link could be queued behind other incoming events:
+    //process what can be reached and give up waiting after USB_LINK_RESPONSE_DEFER_TIME
+    auto responseAllowed = [](uint32_t deferTime) {
+        if (!OpenDeckMIDIformat::canWrite(UART_USB_LINK_CHANNEL))
+            OpenDeckMIDIformat::receiveCommands(UART_USB_LINK_CHANNEL);
+
+        if (OpenDeckMIDIformat::canWrite(UART_USB_LINK_CHANNEL))
+            return true;
+
+        return (core::timing::currentRunTimeMs() - deferTime) >= USB_LINK_RESPONSE_DEFER_TIME;
+    };
+#endif
+
+    //process queued messages in bursts so that the feedback doesn't lag behind the host,
+    //but limit the amount of work so that the components are still scanned regularly
+    auto drain = [&](MIDI::interface_t interface) {
+        uint8_t  maxMessages = sysConfig.midiInputLimit(SysConfig::midiInput_t::maxMessages);
+        uint8_t  maxTime     = sysConfig.midiInputLimit(SysConfig::midiInput_t::maxTime);
+        uint32_t start       = core::timing::currentRunTimeMs();
+        uint8_t  processed   = 0;
+        bool     limited     = true;
+
+#ifndef USB_MIDI_SUPPORTED
+        //nothing else is read until the deferred request is handled so that it stays in MIDI object
+        if ((interface == MIDI::interface_t::usb) && sysExDeferred)
+        {
+            if (!responseAllowed(sysExDeferTime))
+                return;
+
+            sysExDeferred = false;
+            processMessage(interface);
+        }
+#endif
+
+        do
+        {
+            if (!midi.read(interface))
+            {
+                limited = false;
+                break;
+            }
+
+#ifndef USB_MIDI_SUPPORTED
+            //response would be dropped if USB link has no space for it
+            if ((interface == MIDI::interface_t::usb) &&
+                (midi.getType(interface) == MIDI::messageType_t::systemExclusive) &&
+                !responseAllowed(core::timing::currentRunTimeMs()))
+            {
+                sysExDeferred  = true;
+                sysExDeferTime = core::timing::currentRunTimeMs();
+                break;
+            }
+#endif
+
+            processMessage(interface);
+
+            processed++;
+
+            //time is measured in milliseconds so this stops somewhere between maxTime and maxTime + 1
+            if (maxTime && ((core::timing::currentRunTimeMs() - start) > maxTime))
+                break;
+        } while (processed < maxMessages);
+
+        sysConfig.recordInputBacklog(interface == MIDI::interface_t::usb ? SysConfig::midiInputSource_t::usb : SysConfig::midiInputSource_t::din, limited);
+    };
+
     //note: mega/uno
     //"fake" usb interface - din data is stored as usb data so use usb callback to read the usb
     //packet stored in midi object
-    if (midi.read(MIDI::interface_t::usb))
-        processMessage(MIDI::interface_t::usb);
+    drain(MIDI::interface_t::usb);
 
 #ifdef DIN_MIDI_SUPPORTED
     if (sysConfig.isMIDIfeatureEnabled(SysConfig::midiFeature_t::dinEnabled))
@@ -545,14 +677,12 @@ void OpenDeck::checkMIDI()
             switch (mergeType)
             {
             case SysConfig::midiMergeType_t::DINtoUSB:
-                //dump everything from DIN MIDI in to USB MIDI out
-                midi.read(MIDI::interface_t::din, MIDI::filterMode_t::fullUSB);
+            case SysConfig::midiMergeType_t::DINtoDIN:
+                //dump everything from DIN MIDI in to USB or DIN MIDI out
+                //nothing is done here for DIN to DIN merge if hardware loopback is used
+                sysConfig.updateMIDIpassthrough();
                 break;
 
-                // case SysConfig::midiMergeType_t::DINtoDIN:
-                //loopback is automatically configured here
-                // break;
-
                 // case SysConfig::midiMergeType_t::odMaster:
                 //already configured
                 // break;
@@ -560,8 +690,7 @@ void OpenDeck::checkMIDI()
             case SysConfig::midiMergeType_t::odSlaveInitial:
                 //handle the traffic regulary until slave is properly configured
                 //(upon receiving message from master)
-                if (midi.read(MIDI::interface_t::din))
-                    processMessage(MIDI::interface_t::din);
+                drain(MIDI::interface_t::din);
                 break;
 
             default:
@@ -570,8 +699,7 @@ void OpenDeck::checkMIDI()
         }
         else
         {
-            if (midi.read(MIDI::interface_t::din))
-                processMessage(MIDI::interface_t::din);
+            drain(MIDI::interface_t::din);
         }
     }
 #endif
@@ -579,6 +707,32 @@ void OpenDeck::checkMIDI()
 
 void OpenDeck::update()
 {
-    checkMIDI();
+#ifdef USB_MIDI_SUPPORTED
+    static bool usbConfigured = false;
+
+    if (Board::USB::isConfigured() != usbConfigured)
+    {
+        usbConfigured = !usbConfigured;
+
+        //host doesn't know which NRPN parameters have been selected before reconnection
+        if (usbConfigured)
+            IO::Common::resetNRPNselection();
+    }
+#endif
+
+    PROFILE_STAGE(checkMIDI, checkMIDI());
     checkComponents();
+
+#ifdef DIN_MIDI_SUPPORTED
+    sysConfig.updateMIDIscheduler();
+#endif
+
+    sysConfig.updateStorage();
+
+#ifdef USB_MIDI_SUPPORTED
+    //send everything queued during this iteration
+    Board::USB::flush();
+#else
+    OpenDeckMIDIformat::flush(UART_USB_LINK_CHANNEL);
+#endif
 }
\ No newline at end of file
@@ -0,0 +1,241 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef PROFILING
+
+#include "Profiling.h"
+#include "core/src/general/Interrupt.h"
+
+namespace
+{
+    ///
+    /// \brief Latency measurement of a message which hasn't left the device yet.
+    ///
+    typedef struct
+    {
+        Profiling::latencySource_t source;
+        uint32_t                   timestamp;
+        uint32_t                   mark;    ///< Number of units the driver has to send before the message is considered sent.
+    } pendingSample_t;
+
+    Board::profiling::stats_t stageStatistics[static_cast<uint8_t>(Profiling::stage_t::AMOUNT)];
+    uint32_t                  latencyBuckets[static_cast<uint8_t>(Profiling::latencySource_t::AMOUNT)][LATENCY_HISTOGRAM_BUCKETS];
+
+    bool                       latencySourceActive;
+    Profiling::latencySource_t latencySource;
+    uint32_t                   latencyTimestamp;
+
+    ///
+    /// \brief Samples waiting for the messages to leave the device, stored in order in which the messages were sent.
+    /// Accessed from interrupts.
+    /// @{
+
+    pendingSample_t pendingSamples[static_cast<uint8_t>(Profiling::output_t::AMOUNT)][LATENCY_PENDING_SAMPLES];
+    uint8_t         pendingHead[static_cast<uint8_t>(Profiling::output_t::AMOUNT)];
+    uint8_t         pendingCount[static_cast<uint8_t>(Profiling::output_t::AMOUNT)];
+
+    /// @}
+
+    ///
+    /// \brief Retrieves driver path used by specified output.
+    /// \returns False if the output isn't supported.
+    ///
+    bool outputPath(Profiling::output_t output, Board::profiling::txPath_t& path, uint8_t& channel)
+    {
+        switch (output)
+        {
+        case Profiling::output_t::usb:
+#ifdef USB_MIDI_SUPPORTED
+            path    = Board::profiling::txPath_t::usb;
+            channel = 0;
+#else
+            path    = Board::profiling::txPath_t::uart;
+            channel = UART_USB_LINK_CHANNEL;
+#endif
+            return true;
+
+#ifdef DIN_MIDI_SUPPORTED
+        case Profiling::output_t::din:
+            path    = Board::profiling::txPath_t::uart;
+            channel = UART_MIDI_CHANNEL;
+            return true;
+#endif
+
+        default:
+            return false;
+        }
+    }
+
+    void recordLatency(Profiling::latencySource_t source, uint32_t timestamp)
+    {
+        uint32_t latency = (Board::profiling::cycles() - timestamp) / Board::profiling::cyclesPerUs();
+        uint8_t  bucket  = 0;
+
+        while (latency && (bucket < (LATENCY_HISTOGRAM_BUCKETS - 1)))
+        {
+            latency >>= 1;
+            bucket++;
+        }
+
+        auto& count = latencyBuckets[static_cast<uint8_t>(source)][bucket];
+
+        //saturate instead of wrapping around
+        if (count != UINT32_MAX)
+            count++;
+    }
+
+    ///
+    /// \brief Records latency of all pending messages on specified output which have been sent.
+    /// Must be called with interrupts disabled.
+    ///
+    void completeSamples(uint8_t output, uint32_t sent)
+    {
+        while (pendingCount[output])
+        {
+            auto& sample = pendingSamples[output][pendingHead[output]];
+
+            //counters wrap around
+            if (static_cast<int32_t>(sent - sample.mark) < 0)
+                break;
+
+            recordLatency(sample.source, sample.timestamp);
+            pendingHead[output] = (pendingHead[output] + 1) % LATENCY_PENDING_SAMPLES;
+            pendingCount[output]--;
+        }
+    }
+
+    void txHandler(Board::profiling::txPath_t path, uint8_t channel, uint32_t sent)
+    {
+        for (uint8_t i = 0; i < static_cast<uint8_t>(Profiling::output_t::AMOUNT); i++)
+        {
+            Board::profiling::txPath_t outPath;
+            uint8_t                    outChannel;
+
+            if (!outputPath(static_cast<Profiling::output_t>(i), outPath, outChannel))
+                continue;
+
+            if ((outPath == path) && (outChannel == channel))
+                completeSamples(i, sent);
+        }
+    }
+}    // namespace
+
+namespace Profiling
+{
+    void init()
+    {
+        Board::profiling::setTxHandler(txHandler);
+    }
+
+    void record(stage_t stage, uint32_t start)
+    {
+        uint32_t elapsed = Board::profiling::cycles() - start;
+        auto&    stats   = stageStatistics[static_cast<uint8_t>(stage)];
+
+        if (!stats.count || (elapsed < stats.min))
+            stats.min = elapsed;
+
+        if (elapsed > stats.max)
+            stats.max = elapsed;
+
+        stats.total += elapsed;
+        stats.count++;
+    }
+
+    void stats(stage_t stage, Board::profiling::stats_t& stats)
+    {
+        stats = stageStatistics[static_cast<uint8_t>(stage)];
+    }
+
+    void setLatencySource(latencySource_t source, uint32_t timestamp)
+    {
+        latencySource       = source;
+        latencyTimestamp    = timestamp;
+        latencySourceActive = true;
+    }
+
+    void clearLatencySource()
+    {
+        latencySourceActive = false;
+    }
+
+    void trackLatency(output_t output, uint32_t upstream)
+    {
+        if (!latencySourceActive)
+            return;
+
+        Board::profiling::txPath_t path;
+        uint8_t                    channel;
+
+        if (!outputPath(output, path, channel))
+            return;
+
+        auto index = static_cast<uint8_t>(output);
+
+        ATOMIC_SECTION
+        {
+            if (pendingCount[index] < LATENCY_PENDING_SAMPLES)
+            {
+                auto& sample = pendingSamples[index][(pendingHead[index] + pendingCount[index]) % LATENCY_PENDING_SAMPLES];
+
+                sample.source    = latencySource;
+                sample.timestamp = latencyTimestamp;
+                sample.mark      = Board::profiling::txQueued(path, channel) + upstream;
+                pendingCount[index]++;
+
+                //message could have been sent already
+                completeSamples(index, Board::profiling::txSent(path, channel));
+            }
+        }
+    }
+
+    uint32_t latencyHistogram(latencySource_t source, uint8_t bucket)
+    {
+        if (bucket >= LATENCY_HISTOGRAM_BUCKETS)
+            return 0;
+
+        uint32_t count;
+
+        //updated from interrupts
+        ATOMIC_SECTION
+        {
+            count = latencyBuckets[static_cast<uint8_t>(source)][bucket];
+        }
+
+        return count;
+    }
+
+    void reset()
+    {
+        for (size_t i = 0; i < static_cast<uint8_t>(stage_t::AMOUNT); i++)
+            stageStatistics[i] = {};
+
+        ATOMIC_SECTION
+        {
+            for (size_t i = 0; i < static_cast<uint8_t>(latencySource_t::AMOUNT); i++)
+            {
+                for (size_t j = 0; j < LATENCY_HISTOGRAM_BUCKETS; j++)
+                    latencyBuckets[i][j] = 0;
+            }
+        }
+
+        Board::profiling::resetISRstats();
+    }
+}    // namespace Profiling
+
+#endif
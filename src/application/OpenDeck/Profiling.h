@@ -0,0 +1,158 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#ifdef PROFILING
+
+#include "board/Board.h"
+
+///
+/// \brief Total number of buckets in input-to-output latency histogram.
+/// Bucket N holds the number of messages whose latency in microseconds has N significant bits,
+/// ie. bucket 0 holds latencies below 1us and last bucket everything above 2^(N-2)us.
+///
+#define LATENCY_HISTOGRAM_BUCKETS 16
+
+///
+/// \brief Maximum number of outgoing messages per output whose latency is measured at the same time.
+/// Messages sent while this many are still waiting to leave the device aren't measured.
+///
+#define LATENCY_PENDING_SAMPLES 16
+
+///
+/// \brief Execution time statistics for individual stages of main loop
+/// and latency between input sampling and sending of outgoing MIDI messages.
+///
+namespace Profiling
+{
+    ///
+    /// \brief List of all measured main loop stages.
+    ///
+    enum class stage_t : uint8_t
+    {
+        checkMIDI,
+        buttons,
+        encoders,
+        analog,
+        leds,
+        display,
+        touchscreen,
+        AMOUNT
+    };
+
+    ///
+    /// \brief List of component classes for which input-to-output latency is tracked.
+    ///
+    enum class latencySource_t : uint8_t
+    {
+        buttons,
+        encoders,
+        analog,
+        AMOUNT
+    };
+
+    ///
+    /// \brief List of MIDI outputs on which latency is measured.
+    ///
+    enum class output_t : uint8_t
+    {
+        usb,    ///< Native USB (in USB MIDI packets) or USB link (in UART bytes).
+        din,    ///< DIN MIDI out (in UART bytes).
+        AMOUNT
+    };
+
+    ///
+    /// \brief Starts tracking of outgoing data in board drivers.
+    ///
+    void init();
+
+    ///
+    /// \brief Updates statistics of specified stage.
+    /// @param [in] stage   Stage which has been measured.
+    /// @param [in] start   Value of cycle counter read before the stage was run.
+    ///
+    void record(stage_t stage, uint32_t start);
+
+    ///
+    /// \brief Retrieves statistics for specified stage.
+    /// @param [in] stage   Stage for which to retrieve statistics.
+    /// @param [in] stats   Reference to structure in which statistics are stored.
+    ///
+    void stats(stage_t stage, Board::profiling::stats_t& stats);
+
+    ///
+    /// \brief Sets the origin of MIDI messages sent from now on.
+    /// @param [in] source      Component class which is being processed.
+    /// @param [in] timestamp   Cycle counter value at the moment the processed input data has been sampled.
+    ///
+    void setLatencySource(latencySource_t source, uint32_t timestamp);
+
+    ///
+    /// \brief Stops attributing outgoing MIDI messages to any component class.
+    ///
+    void clearLatencySource();
+
+    ///
+    /// \brief Starts measuring latency of a MIDI message which has just been passed on for sending.
+    /// Latency is added to the histogram of currently set source once the driver reports that the message
+    /// has left the device: that all the data queued in the driver so far, increased by specified amount,
+    /// has been sent. Nothing is done if the source isn't set.
+    /// @param [in] output      Output on which the message is sent.
+    /// @param [in] upstream    Number of units (USB MIDI packets or UART bytes) which are held before the
+    ///                         driver and still need to be queued in it before the message is sent.
+    ///
+    void trackLatency(output_t output, uint32_t upstream);
+
+    ///
+    /// \brief Retrieves number of messages in specified latency histogram bucket.
+    ///
+    uint32_t latencyHistogram(latencySource_t source, uint8_t bucket);
+
+    ///
+    /// \brief Clears statistics for all main loop stages and interrupt routines,
+    /// as well as latency histograms.
+    ///
+    void reset();
+}    // namespace Profiling
+
+///
+/// \brief Runs provided statement and records its execution time for specified stage.
+///
+#define PROFILE_STAGE(stage, statement)                          \
+    do                                                           \
+    {                                                            \
+        uint32_t start = Board::profiling::cycles();             \
+        statement;                                               \
+        Profiling::record(Profiling::stage_t::stage, start);     \
+    } while (0)
+
+///
+/// \brief Runs provided statement and attributes all MIDI messages sent from it to specified source.
+///
+#define PROFILE_LATENCY(source, timestamp, statement)                              \
+    do                                                                             \
+    {                                                                              \
+        Profiling::setLatencySource(Profiling::latencySource_t::source, timestamp); \
+        statement;                                                                 \
+        Profiling::clearLatencySource();                                           \
+    } while (0)
+#else
+#define PROFILE_STAGE(stage, statement)               statement
+#define PROFILE_LATENCY(source, timestamp, statement) statement
+#endif
@@ -33,13 +33,35 @@ limitations under the License.
 #define SYSEX_CR_DISABLE_PROCESSING        0x64
 #define SYSEX_CR_DAISY_CHAIN               0x6D
 #define SYSEX_CR_SUPPORTED_PRESETS         0x50
+#define SYSEX_CR_COMMIT                    0x63
+#define SYSEX_CR_STORAGE_STATS             0x53
+#define SYSEX_CR_INPUT_BACKLOG             0x71
+#ifdef PROFILING
+#define SYSEX_CR_PROFILING_STATS           0x70
+#define SYSEX_CR_PROFILING_RESET           0x72
+#define SYSEX_CR_LATENCY_HISTOGRAM         0x6C
+#endif
+#ifndef USB_MIDI_SUPPORTED
+#define SYSEX_CR_LINK_STATS                0x4C
+#else
+#define SYSEX_CR_USB_TX_STATS              0x54
+#endif
 
 /// @}
 
 ///
 /// \brief Total number of custom requests.
 ///
-#define NUMBER_OF_CUSTOM_REQUESTS 11
+#ifdef PROFILING
+#define NUMBER_OF_PROFILING_REQUESTS 3
+#else
+#define NUMBER_OF_PROFILING_REQUESTS 0
+#endif
+
+//either USB link (SYSEX_CR_LINK_STATS) or native USB (SYSEX_CR_USB_TX_STATS) transport statistics are available
+#define NUMBER_OF_TRANSPORT_STATS_REQUESTS 1
+
+#define NUMBER_OF_CUSTOM_REQUESTS (14 + NUMBER_OF_PROFILING_REQUESTS + NUMBER_OF_TRANSPORT_STATS_REQUESTS)
 
 ///
 /// \brief Custom ID used when sending info about components to host.
@@ -49,4 +71,22 @@ limitations under the License.
 ///
 /// \brief Minimum time difference in milliseconds between sending two identical component info messages.
 ///
-#define COMPONENT_INFO_TIMEOUT 500    //ms
\ No newline at end of file
+#define COMPONENT_INFO_TIMEOUT 500    //ms
+
+///
+/// \brief Time in milliseconds without received SysEx messages after which configuration
+/// changes held in RAM are written to non-volatile memory.
+///
+#define STORAGE_FLUSH_IDLE_TIME 500    //ms
+
+///
+/// \brief Maximum time in milliseconds for which handling of SysEx request received from USB link
+/// is delayed while USB link has no space for the response.
+///
+#define USB_LINK_RESPONSE_DEFER_TIME 5    //ms
+
+///
+/// \brief Maximum number of bytes forwarded from DIN MIDI input to merge output within single main loop iteration.
+/// Limits the time spent in passthrough under dense incoming traffic so that the components are still scanned regularly.
+///
+#define MIDI_PASSTHROUGH_MAX_BYTES 64
\ No newline at end of file
@@ -94,6 +94,16 @@ SysConfig::result_t SysConfig::onGetGlobal(Section::global_t section, size_t ind
     }
     break;
 
+    case Section::global_t::midiInput:
+    {
+        if (index < static_cast<size_t>(midiInput_t::AMOUNT))
+        {
+            readValue = midiInputLimit(static_cast<midiInput_t>(index));
+            result    = SysConfig::result_t::ok;
+        }
+    }
+    break;
+
     default:
         break;
     }
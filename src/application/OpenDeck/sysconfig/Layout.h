@@ -48,6 +48,13 @@ namespace
             .newValueMin        = 0,
             .newValueMax        = 0,
         },
+
+        //midi input section
+        {
+            .numberOfParameters = static_cast<uint8_t>(SysConfig::midiInput_t::AMOUNT),
+            .newValueMin        = 0,
+            .newValueMax        = 0,
+        },
     };
 
     SysExConf::section_t buttonSections[static_cast<uint8_t>(SysConfig::Section::button_t::AMOUNT)] = {
@@ -150,6 +157,13 @@ namespace
             .newValueMin        = 0,
             .newValueMax        = 1,
         },
+
+        //aggregation time section
+        {
+            .numberOfParameters = MAX_NUMBER_OF_ENCODERS,
+            .newValueMin        = 0,
+            .newValueMax        = ENCODERS_MAX_AGGREGATION_TIME,
+        },
     };
 
     SysExConf::section_t analogSections[static_cast<uint8_t>(SysConfig::Section::analog_t::AMOUNT)] = {
@@ -391,5 +405,49 @@ namespace
             .requestID     = SYSEX_CR_SUPPORTED_PRESETS,
             .connOpenCheck = true,
         },
+
+        {
+            .requestID     = SYSEX_CR_COMMIT,
+            .connOpenCheck = true,
+        },
+
+        {
+            .requestID     = SYSEX_CR_STORAGE_STATS,
+            .connOpenCheck = true,
+        },
+
+        {
+            .requestID     = SYSEX_CR_INPUT_BACKLOG,
+            .connOpenCheck = true,
+        },
+
+#ifdef PROFILING
+        {
+            .requestID     = SYSEX_CR_PROFILING_STATS,
+            .connOpenCheck = true,
+        },
+
+        {
+            .requestID     = SYSEX_CR_PROFILING_RESET,
+            .connOpenCheck = true,
+        },
+
+        {
+            .requestID     = SYSEX_CR_LATENCY_HISTOGRAM,
+            .connOpenCheck = true,
+        },
+#endif
+
+#ifndef USB_MIDI_SUPPORTED
+        {
+            .requestID     = SYSEX_CR_LINK_STATS,
+            .connOpenCheck = true,
+        },
+#else
+        {
+            .requestID     = SYSEX_CR_USB_TX_STATS,
+            .connOpenCheck = true,
+        },
+#endif
     };
 }    // namespace
\ No newline at end of file
@@ -80,7 +80,7 @@ SysConfig::result_t SysConfig::onSetGlobal(Section::global_t section, size_t ind
 #ifndef DIN_MIDI_SUPPORTED
             result = SysConfig::result_t::notSupported;
 #else
-            midi.setRunningStatusState(newValue);
+            setRunningStatusState(newValue);
             result = SysConfig::result_t::ok;
 #endif
         }
@@ -191,10 +191,27 @@ SysConfig::result_t SysConfig::onSetGlobal(Section::global_t section, size_t ind
 
         case midiMerge_t::mergeUSBchannel:
         case midiMerge_t::mergeDINchannel:
+        case midiMerge_t::mergeDINoutChannel:
         {
-            //unused for now
-            writeToDb = false;
-            result = SysConfig::result_t::ok;
+            //0 disables filtering/remapping
+            if (newValue <= 16)
+            {
+                //passthrough is configured from the database so update it first
+                writeToDb = false;
+                result    = database.update(dbSection(section), index, newValue) ? SysConfig::result_t::ok : SysConfig::result_t::error;
+
+                if ((result == SysConfig::result_t::ok) && isMIDIfeatureEnabled(midiFeature_t::dinEnabled) && isMIDIfeatureEnabled(midiFeature_t::mergeEnabled))
+                {
+                    auto mergeType = midiMergeType();
+
+                    if ((mergeType == midiMergeType_t::DINtoUSB) || (mergeType == midiMergeType_t::DINtoDIN))
+                        configureMIDImerge(mergeType);
+                }
+            }
+            else
+            {
+                result = SysConfig::result_t::notSupported;
+            }
         }
         break;
 
@@ -244,6 +261,40 @@ SysConfig::result_t SysConfig::onSetGlobal(Section::global_t section, size_t ind
     }
     break;
 
+    case Section::global_t::midiInput:
+    {
+        //limits are read on each main loop iteration so there is nothing to apply here
+        auto limit = static_cast<midiInput_t>(index);
+        writeToDb  = false;
+
+        switch (limit)
+        {
+        case midiInput_t::maxMessages:
+        {
+            //at least one message needs to be processed
+            if ((newValue >= 1) && (newValue <= 127))
+                result = database.update(Database::Section::global_t::midiInputMessages, 0, newValue) ? SysConfig::result_t::ok : SysConfig::result_t::error;
+            else
+                result = SysConfig::result_t::notSupported;
+        }
+        break;
+
+        case midiInput_t::maxTime:
+        {
+            //limit is stored as byte
+            if (newValue <= 0xFF)
+                result = database.update(Database::Section::global_t::midiInputTime, 0, newValue) ? SysConfig::result_t::ok : SysConfig::result_t::error;
+            else
+                result = SysConfig::result_t::notSupported;
+        }
+        break;
+
+        default:
+            break;
+        }
+    }
+    break;
+
     default:
         break;
     }
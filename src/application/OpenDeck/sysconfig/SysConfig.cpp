@@ -20,9 +20,81 @@ limitations under the License.
 #include "board/Board.h"
 #include "Version.h"
 #include "Layout.h"
+#include "OpenDeck/Profiling.h"
+#include "OpenDeck/MIDIScheduler.h"
+#include "OpenDeck/MIDIPassthrough.h"
+#include "io/common/Common.h"
 #include "core/src/general/Timing.h"
 #include "common/OpenDeckMIDIformat/OpenDeckMIDIformat.h"
 
+#ifdef DIN_MIDI_SUPPORTED
+namespace
+{
+    ///
+    /// \brief Queues outgoing DIN MIDI data so that continuous controller updates
+    /// which haven't been sent yet can be replaced with newer values.
+    ///
+    MIDIScheduler dinScheduler(
+        [](uint8_t data) {
+            //real-time messages skip the data already waiting in UART buffer
+            if (data >= 0xF8)
+                return Board::UART::writePriority(UART_MIDI_CHANNEL, data);
+
+            return Board::UART::tryWrite(UART_MIDI_CHANNEL, data);
+        },
+        []() {
+            return Board::UART::txSpace(UART_MIDI_CHANNEL);
+        });
+
+    ///
+    /// \brief Forgets NRPN parameters selected from here if forwarded packet selects other (N)RPN parameter.
+    /// Selection forwarded from DIN MIDI in overrides the one sent from here on the same output.
+    ///
+    void checkForwardedSelection(const MIDI::USBMIDIpacket_t& packet)
+    {
+        if (((packet.Event & 0x0F) == 0x0B) && (packet.Data2 >= 98) && (packet.Data2 <= 101))
+            IO::Common::resetNRPNselection();
+    }
+
+    ///
+    /// \brief Forwards incoming DIN MIDI data to USB without parsing it in MIDI module.
+    ///
+    MIDIPassthrough dinToUSB([](MIDI::USBMIDIpacket_t& packet) {
+        checkForwardedSelection(packet);
+
+#ifdef USB_MIDI_SUPPORTED
+        return Board::USB::writeMIDI(packet);
+#else
+        return OpenDeckMIDIformat::write(UART_USB_LINK_CHANNEL, packet, OpenDeckMIDIformat::packetType_t::midi);
+#endif
+    });
+
+    ///
+    /// \brief Forwards incoming DIN MIDI data to DIN MIDI out when channel filtering or
+    /// remapping is used and hardware loopback therefore can't be.
+    ///
+    MIDIPassthrough dinToDIN([](MIDI::USBMIDIpacket_t& packet) {
+        const uint8_t data[3] = { packet.Data1, packet.Data2, packet.Data3 };
+        uint8_t       size    = MIDIPassthrough::packetSize(packet);
+
+        checkForwardedSelection(packet);
+
+        for (uint8_t i = 0; i < size; i++)
+        {
+            if (!dinScheduler.write(data[i]))
+                return false;
+        }
+
+        return true;
+    });
+
+    ///
+    /// \brief Passthrough used for currently active MIDI merge type, nullptr if none.
+    ///
+    MIDIPassthrough* activePassthrough = nullptr;
+}    // namespace
+#endif
+
 Database::block_t SysConfig::dbBlock(uint8_t index)
 {
     //sysex blocks and db blocks don't have 1/1 mapping
@@ -86,9 +158,23 @@ Database::Section::display_t SysConfig::dbSection(Section::display_t section)
 
 void SysConfig::handleSysEx(const uint8_t* array, size_t size)
 {
+    lastSysExTime = core::timing::currentRunTimeMs();
     sysExConf.handleMessage(array, size);
 }
 
+void SysConfig::updateStorage()
+{
+    Board::eeprom::update();
+
+    if (!Board::eeprom::isFlushPending())
+        return;
+
+    if ((core::timing::currentRunTimeMs() - lastSysExTime) < STORAGE_FLUSH_IDLE_TIME)
+        return;
+
+    Board::eeprom::flush();
+}
+
 SysConfig::result_t SysConfig::SysExDataHandler::customRequest(size_t request, CustomResponse& customResponse)
 {
     using namespace Board;
@@ -161,6 +247,58 @@ SysConfig::result_t SysConfig::SysExDataHandler::customRequest(size_t request, C
     }
     break;
 
+    case SYSEX_CR_COMMIT:
+    {
+        if (!Board::eeprom::flush())
+            result = SysConfig::result_t::error;
+    }
+    break;
+
+    case SYSEX_CR_STORAGE_STATS:
+    {
+        //usage of memory page in percent, followed by duration of last page transfer in milliseconds
+        //duration is sent as three 7-bit groups, MSB first, and saturates at 21 bits
+        uint32_t transferTime = Board::eeprom::lastTransferTime();
+
+        if (transferTime > 0x1FFFFF)
+            transferTime = 0x1FFFFF;
+
+        customResponse.append(Board::eeprom::usage());
+        customResponse.append((transferTime >> 14) & static_cast<uint32_t>(0x7F));
+        customResponse.append((transferTime >> 7) & static_cast<uint32_t>(0x7F));
+        customResponse.append(transferTime & static_cast<uint32_t>(0x7F));
+    }
+    break;
+
+    case SYSEX_CR_INPUT_BACKLOG:
+    {
+        //maximum amount of data left unread after processing and number of iterations
+        //stopped by the limits, for USB and DIN interfaces, in that order
+        //backlog is sent as two 7-bit groups saturated at 14 bits and iteration count as
+        //three 7-bit groups saturated at 21 bits, MSB first
+        //statistics are cleared once reported
+        for (size_t i = 0; i < static_cast<uint8_t>(midiInputSource_t::AMOUNT); i++)
+        {
+            uint16_t backlog = sysConfig.inputBacklog[i].max;
+            uint32_t hits    = sysConfig.inputBacklog[i].limitHits;
+
+            if (backlog > 0x3FFF)
+                backlog = 0x3FFF;
+
+            if (hits > 0x1FFFFF)
+                hits = 0x1FFFFF;
+
+            customResponse.append((backlog >> 7) & 0x7F);
+            customResponse.append(backlog & 0x7F);
+            customResponse.append((hits >> 14) & static_cast<uint32_t>(0x7F));
+            customResponse.append((hits >> 7) & static_cast<uint32_t>(0x7F));
+            customResponse.append(hits & static_cast<uint32_t>(0x7F));
+
+            sysConfig.inputBacklog[i] = {};
+        }
+    }
+    break;
+
 #ifdef DIN_MIDI_SUPPORTED
     case SYSEX_CR_DAISY_CHAIN:
     {
@@ -191,6 +329,120 @@ SysConfig::result_t SysConfig::SysExDataHandler::customRequest(size_t request, C
     }
     break;
 
+#ifdef PROFILING
+    case SYSEX_CR_PROFILING_STATS:
+    {
+        //min, average and max cycle count for each main loop stage, followed by interrupts
+        //every value is sent as four 7-bit groups, MSB first, and saturates at 28 bits
+        auto append32 = [&customResponse](uint32_t value) {
+            if (value > 0x0FFFFFFF)
+                value = 0x0FFFFFFF;
+
+            customResponse.append((value >> 21) & static_cast<uint32_t>(0x7F));
+            customResponse.append((value >> 14) & static_cast<uint32_t>(0x7F));
+            customResponse.append((value >> 7) & static_cast<uint32_t>(0x7F));
+            customResponse.append(value & static_cast<uint32_t>(0x7F));
+        };
+
+        auto appendStats = [&append32](const Board::profiling::stats_t& stats) {
+            append32(stats.min);
+            append32(stats.count ? static_cast<uint32_t>(stats.total / stats.count) : 0);
+            append32(stats.max);
+        };
+
+        Board::profiling::stats_t stats;
+
+        for (size_t i = 0; i < static_cast<uint8_t>(Profiling::stage_t::AMOUNT); i++)
+        {
+            Profiling::stats(static_cast<Profiling::stage_t>(i), stats);
+            appendStats(stats);
+        }
+
+        for (size_t i = 0; i < static_cast<uint8_t>(Board::profiling::isr_t::AMOUNT); i++)
+        {
+            Board::profiling::isrStats(static_cast<Board::profiling::isr_t>(i), stats);
+            appendStats(stats);
+        }
+    }
+    break;
+
+    case SYSEX_CR_PROFILING_RESET:
+    {
+        Profiling::reset();
+    }
+    break;
+
+    case SYSEX_CR_LATENCY_HISTOGRAM:
+    {
+        //all histogram buckets for buttons, encoders and analog components, in that order
+        //every count is sent as three 7-bit groups, MSB first, and saturates at 21 bits
+        for (size_t i = 0; i < static_cast<uint8_t>(Profiling::latencySource_t::AMOUNT); i++)
+        {
+            for (size_t j = 0; j < LATENCY_HISTOGRAM_BUCKETS; j++)
+            {
+                uint32_t count = Profiling::latencyHistogram(static_cast<Profiling::latencySource_t>(i), j);
+
+                if (count > 0x1FFFFF)
+                    count = 0x1FFFFF;
+
+                customResponse.append((count >> 14) & static_cast<uint32_t>(0x7F));
+                customResponse.append((count >> 7) & static_cast<uint32_t>(0x7F));
+                customResponse.append(count & static_cast<uint32_t>(0x7F));
+            }
+        }
+    }
+    break;
+#endif
+
+#ifndef USB_MIDI_SUPPORTED
+    case SYSEX_CR_LINK_STATS:
+    {
+        //overrun and invalid frame counters of this MCU, followed by the ones reported by USB link
+        //and the number of events USB link couldn't write to USB
+        //every counter is sent as two 7-bit groups, MSB first, and saturates at 14 bits
+        auto append14 = [&customResponse](uint16_t value) {
+            if (value > 0x3FFF)
+                value = 0x3FFF;
+
+            customResponse.append((value >> 7) & 0x7F);
+            customResponse.append(value & 0x7F);
+        };
+
+        OpenDeckMIDIformat::stats_t local;
+        OpenDeckMIDIformat::stats_t remote;
+
+        OpenDeckMIDIformat::stats(UART_USB_LINK_CHANNEL, local, remote);
+
+        append14(local.overrun);
+        append14(local.invalid);
+        append14(remote.overrun);
+        append14(remote.invalid);
+        append14(remote.forwardFailed);
+    }
+    break;
+#else
+    case SYSEX_CR_USB_TX_STATS:
+    {
+        //outgoing USB MIDI overflow and stall counters, in that order
+        //every counter is sent as three 7-bit groups, MSB first, and saturates at 21 bits
+        auto append21 = [&customResponse](uint32_t value) {
+            if (value > 0x1FFFFF)
+                value = 0x1FFFFF;
+
+            customResponse.append((value >> 14) & static_cast<uint32_t>(0x7F));
+            customResponse.append((value >> 7) & static_cast<uint32_t>(0x7F));
+            customResponse.append(value & static_cast<uint32_t>(0x7F));
+        };
+
+        Board::USB::txStats_t stats;
+        Board::USB::getTxStats(stats);
+
+        append21(stats.overflows);
+        append21(stats.stalls);
+    }
+    break;
+#endif
+
     default:
     {
         result = SysConfig::result_t::error;
@@ -222,6 +474,34 @@ bool SysConfig::isProcessingEnabled()
 }
 
 #ifdef DIN_MIDI_SUPPORTED
+void SysConfig::updateMIDIscheduler()
+{
+    dinScheduler.update();
+}
+
+void SysConfig::updateMIDIpassthrough()
+{
+    if (activePassthrough == nullptr)
+        return;
+
+    uint8_t data;
+
+    //remaining data stays in uart buffer until next call
+    for (size_t i = 0; i < MIDI_PASSTHROUGH_MAX_BYTES; i++)
+    {
+        if (!Board::UART::read(UART_MIDI_CHANNEL, data))
+            break;
+
+        activePassthrough->process(data);
+    }
+}
+
+void SysConfig::setRunningStatusState(bool state)
+{
+    midi.setRunningStatusState(state);
+    dinScheduler.setRunningStatusState(state);
+}
+
 void SysConfig::setupMIDIoverUART(uint32_t baudRate, bool initRX, bool initTX)
 {
     Board::UART::init(UART_MIDI_CHANNEL, baudRate);
@@ -240,7 +520,15 @@ void SysConfig::setupMIDIoverUART(uint32_t baudRate, bool initRX, bool initTX)
     if (initTX)
     {
         midi.handleUARTwrite([](uint8_t data) {
-            return Board::UART::write(UART_MIDI_CHANNEL, data);
+#ifdef PROFILING
+            //count every message once, on its status byte: message is considered sent once the byte
+            //following the data waiting in scheduler is sent
+            //real-time messages skip UART buffer and aren't tracked in it
+            if ((data & 0x80) && (data < 0xF8))
+                Profiling::trackLatency(Profiling::output_t::din, dinScheduler.pendingBytes() + 1);
+#endif
+
+            return dinScheduler.write(data);
         });
     }
     else
@@ -254,7 +542,17 @@ void SysConfig::setupMIDIoverUSB()
 {
 #ifdef USB_MIDI_SUPPORTED
     midi.handleUSBread(Board::USB::readMIDI);
+#ifdef PROFILING
+    midi.handleUSBwrite([](MIDI::USBMIDIpacket_t& USBMIDIpacket) {
+        if (!Board::USB::writeMIDI(USBMIDIpacket))
+            return false;
+
+        Profiling::trackLatency(Profiling::output_t::usb, 0);
+        return true;
+    });
+#else
     midi.handleUSBwrite(Board::USB::writeMIDI);
+#endif
 #else
     //enable uart-to-usb link when usb isn't supported directly
     Board::UART::init(UART_USB_LINK_CHANNEL, UART_BAUDRATE_MIDI_OD);
@@ -272,7 +570,15 @@ void SysConfig::setupMIDIoverUSB()
     });
 
     midi.handleUSBwrite([](MIDI::USBMIDIpacket_t& USBMIDIpacket) {
-        return OpenDeckMIDIformat::write(UART_USB_LINK_CHANNEL, USBMIDIpacket, OpenDeckMIDIformat::packetType_t::midi);
+        if (!OpenDeckMIDIformat::write(UART_USB_LINK_CHANNEL, USBMIDIpacket, OpenDeckMIDIformat::packetType_t::midi))
+            return false;
+
+#ifdef PROFILING
+        //event could be waiting for the rest of the frame
+        Profiling::trackLatency(Profiling::output_t::usb, OpenDeckMIDIformat::pendingBytes(UART_USB_LINK_CHANNEL));
+#endif
+
+        return true;
     });
 #endif
 }
@@ -283,6 +589,12 @@ bool SysConfig::sendCInfo(Database::block_t dbBlock, SysExConf::sysExParameter_t
     {
         if ((core::timing::currentRunTimeMs() - lastCinfoMsgTime[static_cast<uint8_t>(dbBlock)]) > COMPONENT_INFO_TIMEOUT)
         {
+#ifndef USB_MIDI_SUPPORTED
+            //info is sent again on next change of the component
+            if (!OpenDeckMIDIformat::canWrite(UART_USB_LINK_CHANNEL))
+                return true;
+#endif
+
             SysExConf::sysExParameter_t cInfoMessage[] = {
                 SYSEX_CM_COMPONENT_ID,
                 static_cast<SysExConf::sysExParameter_t>(dbBlock),
@@ -306,6 +618,15 @@ void SysConfig::configureMIDI()
     midi.setRunningStatusState(isMIDIfeatureEnabled(midiFeature_t::runningStatus));
     midi.setChannelSendZeroStart(true);
 
+    //interfaces are (re)initialized: start with full NRPN parameter selection
+    IO::Common::resetNRPNselection();
+
+#ifdef DIN_MIDI_SUPPORTED
+    //drop anything queued with previous configuration
+    dinScheduler.reset();
+    setRunningStatusState(isMIDIfeatureEnabled(midiFeature_t::runningStatus));
+#endif
+
     setupMIDIoverUSB();
 
 #ifdef DIN_MIDI_SUPPORTED
@@ -343,6 +664,9 @@ void SysConfig::configureMIDI()
 #ifdef DIN_MIDI_SUPPORTED
 void SysConfig::configureMIDImerge(midiMergeType_t mergeType)
 {
+    activePassthrough = nullptr;
+    IO::Common::setNRPNselectionCache(true);
+
     switch (mergeType)
     {
     case midiMergeType_t::odMaster:
@@ -440,14 +764,39 @@ void SysConfig::configureMIDImerge(midiMergeType_t mergeType)
         //forward all incoming DIN MIDI data to DIN MIDI out
         //also send OpenDeck-generated traffic to DIN MIDI out
         setupMIDIoverUART(UART_BAUDRATE_MIDI_STD, false, true);
-        Board::UART::setLoopbackState(UART_MIDI_CHANNEL, true);
+
+        uint8_t filterChannel = database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(midiMerge_t::mergeDINchannel));
+        uint8_t outputChannel = database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(midiMerge_t::mergeDINoutChannel));
+
+        if (filterChannel || outputChannel)
+        {
+            //hardware loopback forwards everything as is: handle the data in passthrough instead
+            Board::UART::setLoopbackState(UART_MIDI_CHANNEL, false);
+            dinToDIN.setChannels(filterChannel, outputChannel);
+            dinToDIN.reset();
+            activePassthrough = &dinToDIN;
+        }
+        else
+        {
+            Board::UART::setLoopbackState(UART_MIDI_CHANNEL, true);
+
+            //forwarded data is never seen here so it isn't known whether it has changed NRPN selection
+            IO::Common::setNRPNselectionCache(false);
+        }
     }
     break;
 
     case midiMergeType_t::DINtoUSB:
     {
         setupMIDIoverUSB();
-        setupMIDIoverUART(UART_BAUDRATE_MIDI_STD, true, true);
+
+        //incoming DIN data is read directly from UART in passthrough
+        setupMIDIoverUART(UART_BAUDRATE_MIDI_STD, false, true);
+
+        dinToUSB.setChannels(database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(midiMerge_t::mergeDINchannel)),
+                             database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(midiMerge_t::mergeUSBchannel)));
+        dinToUSB.reset();
+        activePassthrough = &dinToUSB;
     }
     break;
 
@@ -487,4 +836,40 @@ bool SysConfig::isMIDIfeatureEnabled(midiFeature_t feature)
 SysConfig::midiMergeType_t SysConfig::midiMergeType()
 {
     return static_cast<midiMergeType_t>(database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(midiMerge_t::mergeType)));
+}
+
+uint8_t SysConfig::midiInputLimit(midiInput_t limit)
+{
+    if (limit == midiInput_t::maxMessages)
+        return database.read(Database::Section::global_t::midiInputMessages, 0);
+
+    return database.read(Database::Section::global_t::midiInputTime, 0);
+}
+
+void SysConfig::recordInputBacklog(midiInputSource_t source, bool limited)
+{
+    size_t backlog = 0;
+
+    if (source == midiInputSource_t::usb)
+    {
+#ifdef USB_MIDI_SUPPORTED
+        backlog = Board::USB::rxPending();
+#else
+        backlog = Board::UART::rxCount(UART_USB_LINK_CHANNEL);
+#endif
+    }
+#ifdef DIN_MIDI_SUPPORTED
+    else
+    {
+        backlog = Board::UART::rxCount(UART_MIDI_CHANNEL);
+    }
+#endif
+
+    auto& stats = inputBacklog[static_cast<uint8_t>(source)];
+
+    if (backlog > stats.max)
+        stats.max = backlog > UINT16_MAX ? UINT16_MAX : backlog;
+
+    if (limited && (stats.limitHits != UINT32_MAX))
+        stats.limitHits++;
 }
\ No newline at end of file
@@ -74,6 +74,7 @@ class SysConfig
             midiFeature,
             midiMerge,
             presets,
+            midiInput,
             AMOUNT
         };
 
@@ -98,6 +99,7 @@ class SysConfig
             acceleration,
             midiID_msb,
             remoteSync,
+            aggregationTime,
             AMOUNT
         };
 
@@ -156,8 +158,30 @@ class SysConfig
     enum class midiMerge_t : uint8_t
     {
         mergeType,
-        mergeUSBchannel,
-        mergeDINchannel,
+        mergeUSBchannel,       ///< Output channel (1-16) of channel messages merged to USB, 0 to keep the original channel.
+        mergeDINchannel,       ///< Merge only channel messages on this DIN channel (1-16), 0 to merge all channels.
+        mergeDINoutChannel,    ///< Output channel (1-16) of channel messages merged to DIN out, 0 to keep the original channel.
+        AMOUNT
+    };
+
+    ///
+    /// \brief Limits for processing of incoming MIDI messages within single main loop iteration.
+    /// Limits are applied to each interface separately.
+    ///
+    enum class midiInput_t : uint8_t
+    {
+        maxMessages,    ///< Maximum number of processed messages (1-127).
+        maxTime,        ///< Maximum processing time in milliseconds (0-255), 0 for no time limit.
+        AMOUNT
+    };
+
+    ///
+    /// \brief List of MIDI inputs for which the amount of unread incoming data is tracked.
+    ///
+    enum class midiInputSource_t : uint8_t
+    {
+        usb,    ///< Native USB or USB link, counted in USB MIDI packets or bytes respectively.
+        din,    ///< DIN MIDI input, counted in bytes.
         AMOUNT
     };
 
@@ -177,6 +201,34 @@ class SysConfig
     bool            sendCInfo(Database::block_t dbBlock, SysExConf::sysExParameter_t componentID);
     bool            isMIDIfeatureEnabled(midiFeature_t feature);
     midiMergeType_t midiMergeType();
+    uint8_t         midiInputLimit(midiInput_t limit);
+
+    ///
+    /// \brief Records the amount of data still waiting in receive buffer of specified input
+    /// after incoming MIDI messages have been processed in current main loop iteration.
+    /// @param [in] source      Input which has been processed.
+    /// @param [in] limited     True if processing was stopped by the limits while there could be more messages.
+    ///
+    void recordInputBacklog(midiInputSource_t source, bool limited);
+
+    ///
+    /// \brief Writes configuration changes held in RAM to non-volatile memory
+    /// once no SysEx message has been received for STORAGE_FLUSH_IDLE_TIME milliseconds.
+    ///
+    void updateStorage();
+
+#ifdef DIN_MIDI_SUPPORTED
+    ///
+    /// \brief Sends as much of the queued DIN MIDI data as the UART can currently accept.
+    ///
+    void updateMIDIscheduler();
+
+    ///
+    /// \brief Forwards all the received DIN MIDI data when DIN to USB or DIN to DIN merge is active.
+    /// Data is converted byte by byte without passing it through MIDI module.
+    ///
+    void updateMIDIpassthrough();
+#endif
 
     private:
     using result_t = SysExConf::DataHandler::result_t;
@@ -245,15 +297,38 @@ class SysConfig
 #ifdef DIN_MIDI_SUPPORTED
     void configureMIDImerge(midiMergeType_t mergeType);
     void sendDaisyChainRequest();
+
+    ///
+    /// \brief Sets running status for DIN MIDI output in both MIDI module and DIN MIDI scheduler.
+    ///
+    void setRunningStatusState(bool state);
 #endif
 
     uint32_t lastCinfoMsgTime[static_cast<uint8_t>(Database::block_t::AMOUNT)];
 
+    ///
+    /// \brief Statistics of unread incoming data for single MIDI input.
+    ///
+    struct inputBacklog_t
+    {
+        uint16_t max;          ///< Largest amount of data left unread after processing.
+        uint32_t limitHits;    ///< Number of main loop iterations in which processing was stopped by the limits.
+    };
+
+    inputBacklog_t inputBacklog[static_cast<uint8_t>(midiInputSource_t::AMOUNT)] = {};
+
+    ///
+    /// \brief Time in milliseconds at which last SysEx message has been received.
+    /// Used to postpone writing to non-volatile memory until configuration burst is over.
+    ///
+    uint32_t lastSysExTime = 0;
+
     //map sysex sections to sections in db
     const Database::Section::global_t sysEx2DB_global[static_cast<uint8_t>(Section::global_t::AMOUNT)] = {
         Database::Section::global_t::midiFeatures,
         Database::Section::global_t::midiMerge,
         Database::Section::global_t::AMOUNT,    //unused
+        Database::Section::global_t::AMOUNT,    //unused
     };
 
     const Database::Section::button_t sysEx2DB_button[static_cast<uint8_t>(Section::button_t::AMOUNT)] = {
@@ -273,7 +348,8 @@ class SysConfig
         Database::Section::encoder_t::pulsesPerStep,
         Database::Section::encoder_t::acceleration,
         Database::Section::encoder_t::midiID,
-        Database::Section::encoder_t::remoteSync
+        Database::Section::encoder_t::remoteSync,
+        Database::Section::encoder_t::aggregationTime
     };
 
     const Database::Section::analog_t sysEx2DB_analog[static_cast<uint8_t>(Section::analog_t::AMOUNT)] = {
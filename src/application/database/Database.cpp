@@ -28,10 +28,197 @@ namespace SectionPrivate
         presets,
         AMOUNT
     };
+
+#ifdef DATABASE_SPARSE_PRESETS
+    enum class presetDelta_t : uint8_t
+    {
+        size,
+        id,
+        index,
+        value,
+        AMOUNT
+    };
+#endif
 }
 
 #include "Layout.h"
 
+#ifdef DATABASE_CONFIG_CACHE
+namespace
+{
+    ///
+    /// \brief RAM copy of the active preset.
+    /// Values are stored decoded, one array per section, so that components
+    /// can fetch their configuration without going through the storage backend.
+    ///
+    struct
+    {
+        uint8_t midiFeatures[static_cast<uint8_t>(SysConfig::midiFeature_t::AMOUNT)];
+        uint8_t midiMerge[static_cast<uint8_t>(SysConfig::midiMerge_t::AMOUNT)];
+        uint8_t midiInputMessages[1];
+        uint8_t midiInputTime[1];
+    } globalCache;
+
+    struct
+    {
+        uint8_t type[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t midiMessage[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t midiID[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t velocity[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t midiChannel[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS];
+    } buttonCache;
+
+    struct
+    {
+        uint8_t  enable[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  invert[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  mode[MAX_NUMBER_OF_ENCODERS];
+        uint16_t midiID[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  midiChannel[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  pulsesPerStep[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  acceleration[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  remoteSync[MAX_NUMBER_OF_ENCODERS];
+        uint8_t  aggregationTime[MAX_NUMBER_OF_ENCODERS];
+    } encoderCache;
+
+    struct
+    {
+        uint8_t  enable[MAX_NUMBER_OF_ANALOG];
+        uint8_t  invert[MAX_NUMBER_OF_ANALOG];
+        uint8_t  type[MAX_NUMBER_OF_ANALOG];
+        uint16_t midiID[MAX_NUMBER_OF_ANALOG];
+        uint16_t lowerLimit[MAX_NUMBER_OF_ANALOG];
+        uint16_t upperLimit[MAX_NUMBER_OF_ANALOG];
+        uint8_t  midiChannel[MAX_NUMBER_OF_ANALOG];
+    } analogCache;
+
+    struct
+    {
+        uint8_t global[static_cast<uint8_t>(IO::LEDs::setting_t::AMOUNT)];
+        uint8_t activationID[MAX_NUMBER_OF_LEDS + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t rgbEnable[MAX_NUMBER_OF_RGB_LEDS + (MAX_TOUCHSCREEN_BUTTONS / 3)];
+        uint8_t controlType[MAX_NUMBER_OF_LEDS + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t activationValue[MAX_NUMBER_OF_LEDS + MAX_TOUCHSCREEN_BUTTONS];
+        uint8_t midiChannel[MAX_NUMBER_OF_LEDS + MAX_TOUCHSCREEN_BUTTONS];
+    } ledCache;
+
+    struct
+    {
+        uint8_t features[static_cast<uint8_t>(IO::Display::feature_t::AMOUNT)];
+        uint8_t setting[static_cast<uint8_t>(IO::Display::setting_t::AMOUNT)];
+    } displayCache;
+
+    ///
+    /// \brief Location of a single cached section.
+    /// Only one of the pointers is set, depending on the width of the parameters.
+    /// Sections left out of the tables below have both pointers set to nullptr
+    /// and are read from storage instead.
+    ///
+    struct cacheSection_t
+    {
+        uint8_t*  byteData;
+        uint16_t* wordData;
+    };
+
+    cacheSection_t globalCacheSections[static_cast<uint8_t>(Database::Section::global_t::AMOUNT)] = {
+        { globalCache.midiFeatures, nullptr },
+        { globalCache.midiMerge, nullptr },
+        { globalCache.midiInputMessages, nullptr },
+        { globalCache.midiInputTime, nullptr },
+    };
+
+    cacheSection_t buttonCacheSections[static_cast<uint8_t>(Database::Section::button_t::AMOUNT)] = {
+        { buttonCache.type, nullptr },
+        { buttonCache.midiMessage, nullptr },
+        { buttonCache.midiID, nullptr },
+        { buttonCache.velocity, nullptr },
+        { buttonCache.midiChannel, nullptr },
+    };
+
+    cacheSection_t encoderCacheSections[static_cast<uint8_t>(Database::Section::encoder_t::AMOUNT)] = {
+        { encoderCache.enable, nullptr },
+        { encoderCache.invert, nullptr },
+        { encoderCache.mode, nullptr },
+        { nullptr, encoderCache.midiID },
+        { encoderCache.midiChannel, nullptr },
+        { encoderCache.pulsesPerStep, nullptr },
+        { encoderCache.acceleration, nullptr },
+        { encoderCache.remoteSync, nullptr },
+        { encoderCache.aggregationTime, nullptr },
+    };
+
+    cacheSection_t analogCacheSections[static_cast<uint8_t>(Database::Section::analog_t::AMOUNT)] = {
+        { analogCache.enable, nullptr },
+        { analogCache.invert, nullptr },
+        { analogCache.type, nullptr },
+        { nullptr, analogCache.midiID },
+        { nullptr, analogCache.lowerLimit },
+        { nullptr, analogCache.upperLimit },
+        { analogCache.midiChannel, nullptr },
+    };
+
+    cacheSection_t ledCacheSections[static_cast<uint8_t>(Database::Section::leds_t::AMOUNT)] = {
+        { ledCache.global, nullptr },
+        { ledCache.activationID, nullptr },
+        { ledCache.rgbEnable, nullptr },
+        { ledCache.controlType, nullptr },
+        { ledCache.activationValue, nullptr },
+        { ledCache.midiChannel, nullptr },
+    };
+
+    cacheSection_t displayCacheSections[static_cast<uint8_t>(Database::Section::display_t::AMOUNT)] = {
+        { displayCache.features, nullptr },
+        { displayCache.setting, nullptr },
+    };
+
+    cacheSection_t* cacheLayout[static_cast<uint8_t>(Database::block_t::AMOUNT)] = {
+        globalCacheSections,
+        buttonCacheSections,
+        encoderCacheSections,
+        analogCacheSections,
+        ledCacheSections,
+        displayCacheSections,
+    };
+
+    ///
+    /// \brief Set to true once the cache holds the contents of the active preset.
+    ///
+    bool cacheValid = false;
+
+#ifdef DATABASE_SPARSE_PRESETS
+    ///
+    /// \brief Single value of the active preset which differs from its default.
+    ///
+    struct presetEntry_t
+    {
+        uint8_t  id;    ///< Block index in upper and section index in lower nibble.
+        uint16_t index;
+        uint16_t value;
+    };
+
+    //block and section indexes are packed together in the entry ID
+    static_assert(static_cast<uint8_t>(Database::block_t::AMOUNT) <= 16, "Block index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::global_t::AMOUNT) < 16, "Global section index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::button_t::AMOUNT) < 16, "Button section index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::encoder_t::AMOUNT) < 16, "Encoder section index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::analog_t::AMOUNT) < 16, "Analog section index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::leds_t::AMOUNT) < 16, "LED section index doesn't fit in preset entry ID");
+    static_assert(static_cast<uint8_t>(Database::Section::display_t::AMOUNT) < 16, "Display section index doesn't fit in preset entry ID");
+
+    ///
+    /// \brief RAM copy of all the values in active preset which differ from defaults,
+    /// in the same order in which they are stored.
+    ///
+    presetEntry_t presetEntries[SPARSE_PRESET_ENTRIES];
+
+    ///
+    /// \brief Number of valid entries in presetEntries array.
+    ///
+    size_t presetEntryCount;
+#endif
+}    // namespace
+#endif
+
 ///
 /// \brief Helper macro for easier entry and exit from system block.
 /// Important: ::init must called before trying to use this macro.
@@ -39,9 +226,9 @@ namespace SectionPrivate
 #define SYSTEM_BLOCK_ENTER(code)                                                    \
     {                                                                               \
         setStartAddress(0);                                                         \
-        LESSDB::setLayout(dbLayout, static_cast<uint8_t>(block_t::AMOUNT) + 1);     \
+        LESSDB::setLayout(storageLayout, storageLayoutSize);                        \
         code                                                                        \
-            LESSDB::setLayout(&dbLayout[1], static_cast<uint8_t>(block_t::AMOUNT)); \
+            LESSDB::setLayout(&storageLayout[1], storageLayoutSize - 1);            \
         setStartAddress(userDataStartAddress + (lastPresetAddress * activePreset)); \
     }
 
@@ -55,7 +242,7 @@ bool Database::init()
     uint32_t systemBlockUsage = 0;
 
     //set only system block for now
-    if (!LESSDB::setLayout(dbLayout, 1))
+    if (!LESSDB::setLayout(storageLayout, 1))
     {
         return false;
     }
@@ -65,7 +252,7 @@ bool Database::init()
         userDataStartAddress = LESSDB::nextParameterAddress();
 
         //now set the entire layout
-        if (!LESSDB::setLayout(dbLayout, static_cast<uint8_t>(block_t::AMOUNT) + 1))
+        if (!LESSDB::setLayout(storageLayout, storageLayoutSize))
             return false;
     }
 
@@ -124,21 +311,26 @@ bool Database::factoryReset(LESSDB::factoryResetType_t type)
     if (type == LESSDB::factoryResetType_t::full)
         clear();
 
-    if (!setDbUID(getDbUID()))
-        return false;
-
-    if (!setPresetPreserveState(false))
-        return false;
-
+    //defaults are streamed to each preset directly: preset is switched (and its RAM copy
+    //reloaded) only once, after all of them have been written
     for (int i = supportedPresets - 1; i >= 0; i--)
     {
-        if (!setPreset(i))
-            return false;
+        setStartAddress(userDataStartAddress + (lastPresetAddress * i));
 
         if (!initData(type))
             return false;
     }
 
+    if (!setPresetPreserveState(false))
+        return false;
+
+    if (!setPreset(0))
+        return false;
+
+    //UID is written last so that interrupted reset is performed again on next init
+    if (!setDbUID(getDbUID()))
+        return false;
+
     handlers.factoryResetDone();
 
     return true;
@@ -164,6 +356,13 @@ bool Database::setPreset(uint8_t preset)
                              static_cast<size_t>(SysConfig::presetSetting_t::activePreset),
                              preset);)
 
+#ifdef DATABASE_CONFIG_CACHE
+    if (returnValue)
+        returnValue = cacheFill();
+#endif
+
+    invalidateRevisions();
+
     if (returnValue)
         handlers.presetChange(preset);
 
@@ -237,6 +436,16 @@ bool Database::isSignatureValid()
     return getDbUID() == signature;
 }
 
+///
+/// \brief Marks contents of all blocks as changed.
+/// Used when entire layout is switched or rewritten at once.
+///
+void Database::invalidateRevisions()
+{
+    for (int i = 0; i < static_cast<uint8_t>(block_t::AMOUNT); i++)
+        blockRevision[i]++;
+}
+
 ///
 /// \brief Calculates unique database ID.
 /// UID is calculated by appending number of parameters and their types for all
@@ -261,9 +470,23 @@ uint16_t Database::getDbUID()
         }
     }
 
+#ifdef DATABASE_SPARSE_PRESETS
+    //layout of preset entries needs to be taken into account as well
+    for (int i = 0; i < sparseLayout[1].numberOfSections; i++)
+    {
+        signature += static_cast<uint16_t>(sparseLayout[1].section[i].numberOfParameters);
+        signature += static_cast<uint16_t>(sparseLayout[1].section[i].parameterType);
+    }
+#endif
+
     signature += supportedPresets;
+    signature ^= uidBase;
 
-    return signature ^ uidBase;
+    //cleared memory reads as 0 - never treat it as initialized
+    if (!signature)
+        signature = uidBase;
+
+    return signature;
 }
 
 ///
@@ -279,4 +502,259 @@ bool Database::setDbUID(uint16_t uid)
         returnValue = update(0, static_cast<uint8_t>(SectionPrivate::system_t::uid), 0, uid);)
 
     return returnValue;
-}
\ No newline at end of file
+}
+
+#ifdef DATABASE_CONFIG_CACHE
+///
+/// \brief Retrieves value from RAM copy of the active preset.
+/// @param [in] block   Block in which the section is located.
+/// @param [in] section Section index within the block.
+/// @param [in] index   Parameter index within the section.
+/// @param [in] value   Reference to variable in which read value is stored.
+/// \returns True if the value has been found in cache, false otherwise.
+///
+bool Database::cacheRead(block_t block, uint8_t section, size_t index, int32_t& value)
+{
+    if (!cacheValid)
+        return false;
+
+    uint8_t blockIndex = static_cast<uint8_t>(block);
+
+    if (blockIndex >= static_cast<uint8_t>(block_t::AMOUNT))
+        return false;
+
+    //first block in layout is system block which isn't cached
+    if (section >= dbLayout[blockIndex + 1].numberOfSections)
+        return false;
+
+    if (index >= dbLayout[blockIndex + 1].section[section].numberOfParameters)
+        return false;
+
+    const cacheSection_t& cacheSection = cacheLayout[blockIndex][section];
+
+    //sections without RAM copy are read from storage
+    if ((cacheSection.byteData == nullptr) && (cacheSection.wordData == nullptr))
+        return false;
+
+    if (cacheSection.wordData != nullptr)
+        value = cacheSection.wordData[index];
+    else
+        value = cacheSection.byteData[index];
+
+    return true;
+}
+
+///
+/// \brief Updates single value in RAM copy of the active preset.
+/// Should be called only once the value has been successfully written to storage.
+///
+void Database::cacheUpdate(block_t block, uint8_t section, size_t index, int32_t value)
+{
+    uint8_t blockIndex = static_cast<uint8_t>(block);
+
+    if (blockIndex >= static_cast<uint8_t>(block_t::AMOUNT))
+        return;
+
+    if (section >= dbLayout[blockIndex + 1].numberOfSections)
+        return;
+
+    if (index >= dbLayout[blockIndex + 1].section[section].numberOfParameters)
+        return;
+
+    const cacheSection_t& cacheSection = cacheLayout[blockIndex][section];
+
+    if (cacheSection.wordData != nullptr)
+        cacheSection.wordData[index] = value;
+    else if (cacheSection.byteData != nullptr)
+        cacheSection.byteData[index] = value;
+}
+
+///
+/// \brief Loads all user blocks of the active preset into RAM.
+/// \returns True on success, false otherwise.
+///
+bool Database::cacheFill()
+{
+    cacheValid = false;
+
+    for (int block = 0; block < static_cast<uint8_t>(block_t::AMOUNT); block++)
+    {
+        for (int section = 0; section < dbLayout[block + 1].numberOfSections; section++)
+        {
+            for (size_t index = 0; index < dbLayout[block + 1].section[section].numberOfParameters; index++)
+            {
+#ifdef DATABASE_SPARSE_PRESETS
+                //only the differences are stored, start from defaults
+                int32_t value = defaultValue(static_cast<block_t>(block), section, index);
+#else
+                int32_t value;
+
+                if (!LESSDB::read(block, section, index, value))
+                    return false;
+#endif
+
+                cacheUpdate(static_cast<block_t>(block), section, index, value);
+            }
+        }
+    }
+
+#ifdef DATABASE_SPARSE_PRESETS
+    int32_t size;
+
+    if (!LESSDB::read(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::size), 0, size))
+        return false;
+
+    presetEntryCount = CONSTRAIN(size, 0, SPARSE_PRESET_ENTRIES);
+
+    for (size_t i = 0; i < presetEntryCount; i++)
+    {
+        int32_t id;
+        int32_t index;
+        int32_t value;
+
+        if (!LESSDB::read(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::id), i, id))
+            return false;
+
+        if (!LESSDB::read(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::index), i, index))
+            return false;
+
+        if (!LESSDB::read(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::value), i, value))
+            return false;
+
+        presetEntries[i].id    = id;
+        presetEntries[i].index = index;
+        presetEntries[i].value = value;
+
+        //out of range entries are ignored here
+        cacheUpdate(static_cast<block_t>(id >> 4), id & 0x0F, index, value);
+    }
+#endif
+
+    cacheValid = true;
+
+    return true;
+}
+#endif
+
+#ifdef DATABASE_SPARSE_PRESETS
+///
+/// \brief Retrieves default value of specified parameter as defined in database layout.
+///
+int32_t Database::defaultValue(block_t block, uint8_t section, size_t index)
+{
+    const LESSDB::section_t& layoutSection = dbLayout[static_cast<uint8_t>(block) + 1].section[section];
+
+    if (layoutSection.autoIncrement)
+        return layoutSection.defaultValue + index;
+
+    return layoutSection.defaultValue;
+}
+
+///
+/// \brief Retrieves value of a parameter in the active preset directly from the stored entries.
+/// Used only for sections which don't have RAM copy.
+/// \returns True on success, false if the parameter doesn't exist.
+///
+bool Database::sparseRead(block_t block, uint8_t section, size_t index, int32_t& value)
+{
+    uint8_t blockIndex = static_cast<uint8_t>(block);
+
+    if (blockIndex >= static_cast<uint8_t>(block_t::AMOUNT))
+        return false;
+
+    if (section >= dbLayout[blockIndex + 1].numberOfSections)
+        return false;
+
+    if (index >= dbLayout[blockIndex + 1].section[section].numberOfParameters)
+        return false;
+
+    uint8_t id = (blockIndex << 4) | section;
+
+    for (size_t entry = 0; entry < presetEntryCount; entry++)
+    {
+        if ((presetEntries[entry].id == id) && (presetEntries[entry].index == index))
+        {
+            value = presetEntries[entry].value;
+            return true;
+        }
+    }
+
+    value = defaultValue(block, section, index);
+
+    return true;
+}
+
+///
+/// \brief Stores new value of a parameter in the active preset.
+/// Values equal to defaults are removed from the preset, while all the others are
+/// either updated in place or appended at the end of the preset.
+/// \returns True on success, false if the value is out of range or the preset is full.
+///
+bool Database::sparseUpdate(block_t block, uint8_t section, size_t index, int32_t value)
+{
+    uint8_t blockIndex = static_cast<uint8_t>(block);
+
+    if (blockIndex >= static_cast<uint8_t>(block_t::AMOUNT))
+        return false;
+
+    if (section >= dbLayout[blockIndex + 1].numberOfSections)
+        return false;
+
+    if (index >= dbLayout[blockIndex + 1].section[section].numberOfParameters)
+        return false;
+
+    uint8_t id    = (blockIndex << 4) | section;
+    size_t  entry = 0;
+
+    for (; entry < presetEntryCount; entry++)
+    {
+        if ((presetEntries[entry].id == id) && (presetEntries[entry].index == index))
+            break;
+    }
+
+    auto writeEntry = [this](size_t entry) {
+        return LESSDB::update(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::id), entry, presetEntries[entry].id) &&
+               LESSDB::update(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::index), entry, presetEntries[entry].index) &&
+               LESSDB::update(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::value), entry, presetEntries[entry].value);
+    };
+
+    if (value == defaultValue(block, section, index))
+    {
+        if (entry == presetEntryCount)
+            return true;
+
+        //move the last entry in place of the removed one so that the entries stay contiguous
+        if (entry != (presetEntryCount - 1))
+        {
+            presetEntries[entry] = presetEntries[presetEntryCount - 1];
+
+            if (!writeEntry(entry))
+                return false;
+        }
+
+        presetEntryCount--;
+    }
+    else if (entry != presetEntryCount)
+    {
+        presetEntries[entry].value = value;
+        return LESSDB::update(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::value), entry, value);
+    }
+    else
+    {
+        if (presetEntryCount >= SPARSE_PRESET_ENTRIES)
+            return false;
+
+        presetEntries[entry].id    = id;
+        presetEntries[entry].index = index;
+        presetEntries[entry].value = value;
+
+        if (!writeEntry(entry))
+            return false;
+
+        presetEntryCount++;
+    }
+
+    //entry count is written last so that the preset never holds partially written entry
+    return LESSDB::update(0, static_cast<uint8_t>(SectionPrivate::presetDelta_t::size), 0, presetEntryCount);
+}
+#endif
@@ -20,6 +20,15 @@ limitations under the License.
 
 #include "dbms/src/LESSDB.h"
 
+#ifdef DATABASE_SPARSE_PRESETS
+///
+/// \brief Maximum number of values in single preset which can differ from defaults.
+///
+#ifndef SPARSE_PRESET_ENTRIES
+#define SPARSE_PRESET_ENTRIES 64
+#endif
+#endif
+
 ///
 /// \addtogroup eeprom
 /// @{
@@ -63,6 +72,8 @@ class Database : public LESSDB
         {
             midiFeatures,
             midiMerge,
+            midiInputMessages,
+            midiInputTime,
             AMOUNT
         };
 
@@ -86,6 +97,7 @@ class Database : public LESSDB
             pulsesPerStep,
             acceleration,
             remoteSync,
+            aggregationTime,
             AMOUNT
         };
 
@@ -127,21 +139,73 @@ class Database : public LESSDB
     int32_t read(T section, size_t index)
     {
         block_t blockIndex = block(section);
+
+#ifdef DATABASE_CONFIG_CACHE
+        int32_t value;
+
+        if (cacheRead(blockIndex, static_cast<uint8_t>(section), index, value))
+            return value;
+#endif
+
+#ifdef DATABASE_SPARSE_PRESETS
+        //user blocks aren't stored as they are - look up the value in preset entries
+        //value is declared above since sparse presets always come with cache
+        value = 0;
+        sparseRead(blockIndex, static_cast<uint8_t>(section), index, value);
+        return value;
+#else
         return LESSDB::read(static_cast<uint8_t>(blockIndex), static_cast<uint8_t>(section), index);
+#endif
     }
 
     template<typename T>
     bool read(T section, size_t index, int32_t& value)
     {
         block_t blockIndex = block(section);
+
+#ifdef DATABASE_CONFIG_CACHE
+        if (cacheRead(blockIndex, static_cast<uint8_t>(section), index, value))
+            return true;
+#endif
+
+#ifdef DATABASE_SPARSE_PRESETS
+        return sparseRead(blockIndex, static_cast<uint8_t>(section), index, value);
+#else
         return LESSDB::read(static_cast<uint8_t>(blockIndex), static_cast<uint8_t>(section), index, value);
+#endif
     }
 
     template<typename T>
     bool update(T section, size_t index, int32_t value)
     {
         block_t blockIndex = block(section);
-        return LESSDB::update(static_cast<uint8_t>(blockIndex), static_cast<uint8_t>(section), index, value);
+
+#ifdef DATABASE_SPARSE_PRESETS
+        if (!sparseUpdate(blockIndex, static_cast<uint8_t>(section), index, value))
+            return false;
+#else
+        if (!LESSDB::update(static_cast<uint8_t>(blockIndex), static_cast<uint8_t>(section), index, value))
+            return false;
+#endif
+
+#ifdef DATABASE_CONFIG_CACHE
+        cacheUpdate(blockIndex, static_cast<uint8_t>(section), index, value);
+#endif
+
+        blockRevision[static_cast<uint8_t>(blockIndex)]++;
+
+        return true;
+    }
+
+    ///
+    /// \brief Retrieves revision of specified block.
+    /// Revision changes every time any value within the block changes,
+    /// including preset change and factory reset. Used by components which
+    /// build their own lookup data from database to detect when to rebuild it.
+    ///
+    uint32_t revision(block_t block)
+    {
+        return blockRevision[static_cast<uint8_t>(block)];
     }
 
     bool    init();
@@ -186,6 +250,19 @@ class Database : public LESSDB
 
     uint16_t getDbUID();
     bool     setDbUID(uint16_t uid);
+    void     invalidateRevisions();
+
+#ifdef DATABASE_CONFIG_CACHE
+    bool cacheRead(block_t block, uint8_t section, size_t index, int32_t& value);
+    void cacheUpdate(block_t block, uint8_t section, size_t index, int32_t value);
+    bool cacheFill();
+#endif
+
+#ifdef DATABASE_SPARSE_PRESETS
+    int32_t defaultValue(block_t block, uint8_t section, size_t index);
+    bool    sparseRead(block_t block, uint8_t section, size_t index, int32_t& value);
+    bool    sparseUpdate(block_t block, uint8_t section, size_t index, int32_t value);
+#endif
 
     Handlers& handlers;
 
@@ -210,4 +287,9 @@ class Database : public LESSDB
     /// \brief Holds currently active preset.
     ///
     uint8_t activePreset = 0;
+
+    ///
+    /// \brief Array holding revision for each block.
+    ///
+    uint32_t blockRevision[static_cast<uint8_t>(block_t::AMOUNT)] = {};
 };
\ No newline at end of file
@@ -24,7 +24,18 @@ limitations under the License.
 #include "OpenDeck/sysconfig/SysConfig.h"
 #include "io/display/Config.h"
 
+#ifdef DATABASE_SPARSE_PRESETS
+#ifndef DATABASE_CONFIG_CACHE
+#error Sparse preset storage requires DATABASE_CONFIG_CACHE
+#endif
+
+///
+/// \brief Limited so that the number of presets fits in a single 7-bit value.
+///
+#define MAX_PRESETS 127
+#else
 #define MAX_PRESETS 10
+#endif
 
 namespace
 {
@@ -63,13 +74,36 @@ namespace
         },
 
         //midi merge section
+        //channel parameters take values 0-16 so they don't fit in half-byte
+        //note: changing the type or the number of parameters changes database UID - on first boot after the
+        //update, database is reinitialized and stored configuration is reset to defaults
         {
             .numberOfParameters     = static_cast<uint8_t>(SysConfig::midiMerge_t::AMOUNT),
-            .parameterType          = LESSDB::sectionParameterType_t::halfByte,
+            .parameterType          = LESSDB::sectionParameterType_t::byte,
             .preserveOnPartialReset = false,
             .defaultValue           = 0,
             .autoIncrement          = false,
             .address                = 0,
+        },
+
+        //midi input message limit section
+        {
+            .numberOfParameters     = 1,
+            .parameterType          = LESSDB::sectionParameterType_t::byte,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 16,
+            .autoIncrement          = false,
+            .address                = 0,
+        },
+
+        //midi input time limit section
+        {
+            .numberOfParameters     = 1,
+            .parameterType          = LESSDB::sectionParameterType_t::byte,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 1,
+            .autoIncrement          = false,
+            .address                = 0,
         }
     };
 
@@ -204,6 +238,16 @@ namespace
             .defaultValue           = 0,
             .autoIncrement          = false,
             .address                = 0,
+        },
+
+        //aggregation time section
+        {
+            .numberOfParameters     = MAX_NUMBER_OF_ENCODERS,
+            .parameterType          = LESSDB::sectionParameterType_t::byte,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 0,
+            .autoIncrement          = false,
+            .address                = 0,
         }
     };
 
@@ -413,4 +457,74 @@ namespace
             .address          = 0,
         }
     };
+
+#ifdef DATABASE_SPARSE_PRESETS
+    LESSDB::section_t presetDeltaSections[static_cast<uint8_t>(SectionPrivate::presetDelta_t::AMOUNT)] = {
+        //number of entries section
+        {
+            .numberOfParameters     = 1,
+            .parameterType          = LESSDB::sectionParameterType_t::word,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 0,
+            .autoIncrement          = false,
+            .address                = 0,
+        },
+
+        //entry ID section
+        {
+            .numberOfParameters     = SPARSE_PRESET_ENTRIES,
+            .parameterType          = LESSDB::sectionParameterType_t::byte,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 0,
+            .autoIncrement          = false,
+            .address                = 0,
+        },
+
+        //entry index section
+        {
+            .numberOfParameters     = SPARSE_PRESET_ENTRIES,
+            .parameterType          = LESSDB::sectionParameterType_t::word,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 0,
+            .autoIncrement          = false,
+            .address                = 0,
+        },
+
+        //entry value section
+        {
+            .numberOfParameters     = SPARSE_PRESET_ENTRIES,
+            .parameterType          = LESSDB::sectionParameterType_t::word,
+            .preserveOnPartialReset = false,
+            .defaultValue           = 0,
+            .autoIncrement          = false,
+            .address                = 0,
+        }
+    };
+
+    ///
+    /// \brief Layout used in storage when presets hold only values which differ from defaults.
+    /// User blocks from dbLayout then only describe the parameters and their defaults.
+    ///
+    LESSDB::block_t sparseLayout[2] = {
+        //system block
+        {
+            .numberOfSections = static_cast<uint8_t>(SectionPrivate::system_t::AMOUNT),
+            .section          = systemSections,
+            .address          = 0,
+        },
+
+        //preset block
+        {
+            .numberOfSections = static_cast<uint8_t>(SectionPrivate::presetDelta_t::AMOUNT),
+            .section          = presetDeltaSections,
+            .address          = 0,
+        }
+    };
+
+    LESSDB::block_t* storageLayout     = sparseLayout;
+    const uint8_t    storageLayoutSize = 2;
+#else
+    LESSDB::block_t* storageLayout     = dbLayout;
+    const uint8_t    storageLayoutSize = static_cast<uint8_t>(Database::block_t::AMOUNT) + 1;
+#endif
 }    // namespace
\ No newline at end of file
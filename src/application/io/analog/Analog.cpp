@@ -23,15 +23,18 @@ using namespace IO;
 
 void Analog::update()
 {
+    if (!configBuilt || (configRevision != database.revision(Database::block_t::analog)))
+        rebuildConfig();
+
     //check values
     for (int i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
     {
         //don't process component if it's not enabled
-        if (!database.read(Database::Section::analog_t::enable, i))
+        if (!analogConfig[i].enabled)
             continue;
 
         uint16_t analogData = hwa.state(i);
-        auto     type       = static_cast<type_t>(database.read(Database::Section::analog_t::type, i));
+        auto     type       = analogConfig[i].type;
 
         //normally use exponential filter but not around the edges
         if (analogData <= adc7bitStep)
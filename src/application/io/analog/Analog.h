@@ -24,6 +24,7 @@ limitations under the License.
 #ifdef DISPLAY_SUPPORTED
 #include "io/display/Display.h"
 #endif
+#include "io/common/Common.h"
 #include "io/common/CInfo.h"
 
 namespace IO
@@ -35,7 +36,7 @@ namespace IO
     /// @{
     ///
 
-    class Analog
+    class Analog : public Common
     {
         public:
         enum class adcType_t : uint8_t
@@ -105,6 +106,9 @@ namespace IO
         void         setButtonHandler(void (*fptr)(uint8_t adcIndex, bool state));
         adcConfig_t& config();
 
+        static uint32_t scaleFactor(uint16_t multiplier, uint16_t divisor);
+        static uint16_t scale(uint16_t value, uint32_t factor, uint16_t multiplier, uint16_t divisor);
+
         private:
         enum class potDirection_t : uint8_t
         {
@@ -161,6 +165,27 @@ namespace IO
             uint16_t currentValue = 0;
         };
 
+        ///
+        /// \brief Precomputed values used to scale MIDI value of potentiometer to configured limits.
+        ///
+        struct potScaling_t
+        {
+            uint16_t base;          ///< Value sent when potentiometer is at its lowest position.
+            uint16_t range;         ///< Absolute difference between lower and upper limit.
+            uint16_t factor;        ///< Fixed-point ratio between range and maximum MIDI value.
+            bool     descending;    ///< Set if sent value decreases when potentiometer value increases.
+        };
+
+        ///
+        /// \brief Settings of single analog component needed on every scan.
+        ///
+        struct analogConfig_t
+        {
+            bool   enabled;
+            type_t type;
+        };
+
+        void     rebuildConfig();
         void     checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32_t value);
         void     checkFSRvalue(uint8_t analogID, uint16_t pressure);
         bool     fsrPressureStable(uint8_t analogID);
@@ -188,6 +213,35 @@ namespace IO
         potDirection_t lastDirection[MAX_NUMBER_OF_ANALOG] = {};
         EMA            emaFilter[MAX_NUMBER_OF_ANALOG];
         const uint16_t adc7bitStep;
+
+        ///
+        /// \brief Scaling data for all analog components, built from analog database block.
+        ///
+        potScaling_t potScaling[MAX_NUMBER_OF_ANALOG] = {};
+
+        ///
+        /// \brief RAM copy of analog settings, built together with the scaling data.
+        ///
+        analogConfig_t analogConfig[MAX_NUMBER_OF_ANALOG] = {};
+
+        ///
+        /// \brief Fixed-point ratios used to convert raw ADC value to 7-bit and 14-bit MIDI value.
+        /// @{
+
+        uint32_t adcScaleFactor7bit  = 0;
+        uint32_t adcScaleFactor14bit = 0;
+
+        /// @}
+
+        ///
+        /// \brief Revision of analog database block used to build the scaling data and settings copy.
+        ///
+        uint32_t configRevision = 0;
+
+        ///
+        /// \brief Set to true once the scaling data and settings copy have been built.
+        ///
+        bool configBuilt = false;
     };
 
     /// @}
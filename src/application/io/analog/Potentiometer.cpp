@@ -21,9 +21,94 @@ limitations under the License.
 
 using namespace IO;
 
+namespace
+{
+    ///
+    /// \brief Amount of fractional bits in fixed-point scaling factors.
+    /// Scaled values are at most 14-bit so the error of rounded down factor is always
+    /// smaller than one, which is then corrected in Analog::scale.
+    ///
+    constexpr uint8_t SCALE_SHIFT = 15;
+}    // namespace
+
+///
+/// \brief Precomputes scaling data and copies settings needed on every scan for all analog components from database.
+/// This is the only place where division is needed: scaling itself is done
+/// with multiplication only since AVR doesn't have hardware divider.
+///
+void Analog::rebuildConfig()
+{
+    MIDI::encDec_14bit_t encDec_14bit;
+
+    adcScaleFactor7bit  = scaleFactor(MIDI_7_BIT_VALUE_MAX, adcConfig.adcMaxValue);
+    adcScaleFactor14bit = scaleFactor(MIDI_14_BIT_VALUE_MAX, adcConfig.adcMaxValue);
+
+    for (int i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
+    {
+        auto     type       = static_cast<type_t>(database.read(Database::Section::analog_t::type, i));
+        uint16_t lowerLimit = database.read(Database::Section::analog_t::lowerLimit, i);
+        uint16_t upperLimit = database.read(Database::Section::analog_t::upperLimit, i);
+        bool     invert     = database.read(Database::Section::analog_t::invert, i);
+        uint16_t maxLimit   = MIDI_14_BIT_VALUE_MAX;
+
+        analogConfig[i].enabled = database.read(Database::Section::analog_t::enable, i);
+        analogConfig[i].type    = type;
+
+        if ((type != type_t::nrpn14b) && (type != type_t::pitchBend) && (type != type_t::cc14bit))
+        {
+            //use 7-bit limits
+            maxLimit = MIDI_7_BIT_VALUE_MAX;
+
+            encDec_14bit.value = lowerLimit;
+            encDec_14bit.split14bit();
+            lowerLimit = encDec_14bit.low;
+
+            encDec_14bit.value = upperLimit;
+            encDec_14bit.split14bit();
+            upperLimit = encDec_14bit.low;
+        }
+
+        //lower limit larger than upper limit has the same effect as inversion
+        potScaling[i].range      = (lowerLimit > upperLimit) ? lowerLimit - upperLimit : upperLimit - lowerLimit;
+        potScaling[i].factor     = scaleFactor(potScaling[i].range, maxLimit);
+        potScaling[i].base       = invert ? upperLimit : lowerLimit;
+        potScaling[i].descending = (lowerLimit > upperLimit) != invert;
+    }
+
+    configRevision = database.revision(Database::block_t::analog);
+    configBuilt    = true;
+}
+
+///
+/// \brief Calculates fixed-point factor used to scale values with Analog::scale.
+///
+uint32_t Analog::scaleFactor(uint16_t multiplier, uint16_t divisor)
+{
+    return (static_cast<uint32_t>(multiplier) << SCALE_SHIFT) / divisor;
+}
+
+///
+/// \brief Calculates value * multiplier / divisor, rounded down, without division.
+/// @param [in] value       Value to scale. Must not be larger than divisor.
+/// @param [in] factor      Factor calculated with Analog::scaleFactor for given multiplier and divisor.
+/// @param [in] multiplier  Multiplier used to calculate the factor.
+/// @param [in] divisor     Divisor used to calculate the factor.
+///
+uint16_t Analog::scale(uint16_t value, uint32_t factor, uint16_t multiplier, uint16_t divisor)
+{
+    uint16_t result = (static_cast<uint32_t>(value) * factor) >> SCALE_SHIFT;
+
+    //factor is rounded down so the result can be lower by one
+    if ((static_cast<uint32_t>(value) * multiplier - static_cast<uint32_t>(result) * divisor) >= divisor)
+        result++;
+
+    return result;
+}
+
 void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32_t value)
 {
     uint16_t maxLimit;
+    uint32_t adcScaleFactor;
     uint16_t stepDiff;
     bool     use14bit = false;
 
@@ -32,16 +117,18 @@ void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32
 
     if (use14bit)
     {
-        maxLimit = MIDI_14_BIT_VALUE_MAX;
-        stepDiff = adcConfig.midiStepMinDiff14bit;
+        maxLimit       = MIDI_14_BIT_VALUE_MAX;
+        adcScaleFactor = adcScaleFactor14bit;
+        stepDiff       = adcConfig.midiStepMinDiff14bit;
     }
     else
     {
-        maxLimit = MIDI_7_BIT_VALUE_MAX;
-        stepDiff = adcConfig.midiStepMinDiff7bit;
+        maxLimit       = MIDI_7_BIT_VALUE_MAX;
+        adcScaleFactor = adcScaleFactor7bit;
+        stepDiff       = adcConfig.midiStepMinDiff7bit;
     }
 
-    auto midiValue = core::misc::mapRange(value, static_cast<uint32_t>(0), static_cast<uint32_t>(adcConfig.adcMaxValue), static_cast<uint32_t>(0), static_cast<uint32_t>(maxLimit));
+    uint32_t midiValue = scale(value, adcScaleFactor, maxLimit, adcConfig.adcMaxValue);
 
     //if the first read value is 0, mark it as increasing since the lastAnalogueValue is initialized to value 0 for all pots
     potDirection_t direction = midiValue >= lastMIDIValue[analogID] ? potDirection_t::increasing : potDirection_t::decreasing;
@@ -69,48 +156,22 @@ void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32
 
     lastDirection[analogID] = direction;
 
-    uint16_t             lowerLimit = database.read(Database::Section::analog_t::lowerLimit, analogID);
-    uint16_t             upperLimit = database.read(Database::Section::analog_t::upperLimit, analogID);
-    uint16_t             midiID     = database.read(Database::Section::analog_t::midiID, analogID);
-    uint8_t              channel    = database.read(Database::Section::analog_t::midiChannel, analogID);
+    uint16_t             midiID  = database.read(Database::Section::analog_t::midiID, analogID);
+    uint8_t              channel = database.read(Database::Section::analog_t::midiChannel, analogID);
     MIDI::encDec_14bit_t encDec_14bit;
 
     if (!use14bit)
     {
-        //use 7-bit MIDI ID and limits
+        //use 7-bit MIDI ID
         encDec_14bit.value = midiID;
         encDec_14bit.split14bit();
         midiID = encDec_14bit.low;
-
-        encDec_14bit.value = lowerLimit;
-        encDec_14bit.split14bit();
-        lowerLimit = encDec_14bit.low;
-
-        encDec_14bit.value = upperLimit;
-        encDec_14bit.split14bit();
-        upperLimit = encDec_14bit.low;
     }
-    // else
-    // {
-    //     //14-bit values are already read
-    // }
 
-    uint32_t scaledMIDIvalue;
-
-    if (lowerLimit > upperLimit)
-    {
-        scaledMIDIvalue = core::misc::mapRange(midiValue, static_cast<uint32_t>(0), static_cast<uint32_t>(maxLimit), static_cast<uint32_t>(upperLimit), static_cast<uint32_t>(lowerLimit));
-
-        if (!database.read(Database::Section::analog_t::invert, analogID))
-            scaledMIDIvalue = upperLimit - (scaledMIDIvalue - lowerLimit);
-    }
-    else
-    {
-        scaledMIDIvalue = core::misc::mapRange(midiValue, static_cast<uint32_t>(0), static_cast<uint32_t>(maxLimit), static_cast<uint32_t>(lowerLimit), static_cast<uint32_t>(upperLimit));
-
-        if (database.read(Database::Section::analog_t::invert, analogID))
-            scaledMIDIvalue = upperLimit - (scaledMIDIvalue - lowerLimit);
-    }
+    //limits and inversion are already applied to scaling data
+    const potScaling_t& scaling         = potScaling[analogID];
+    uint16_t            offset          = scale(midiValue, scaling.factor, scaling.range, maxLimit);
+    uint32_t            scaledMIDIvalue = scaling.descending ? scaling.base - offset : scaling.base + offset;
 
     switch (analogType)
     {
@@ -118,7 +179,7 @@ void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32
     case type_t::potentiometerNote:
         if (analogType == type_t::potentiometerControlChange)
         {
-            midi.sendControlChange(midiID, scaledMIDIvalue, channel);
+            sendControlChange(midi, midiID, scaledMIDIvalue, channel);
 #ifdef DISPLAY_SUPPORTED
             display.displayMIDIevent(Display::eventType_t::out, Display::event_t::controlChange, midiID, scaledMIDIvalue, channel + 1);
 #endif
@@ -142,10 +203,7 @@ void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32
         encDec_14bit.split14bit();
 
         if (analogType != type_t::cc14bit)
-        {
-            midi.sendControlChange(99, encDec_14bit.high, channel);
-            midi.sendControlChange(98, encDec_14bit.low, channel);
-        }
+            selectNRPN(midi, channel, midiID);
 
         if (analogType == type_t::nrpn7b)
         {
@@ -165,8 +223,8 @@ void Analog::checkPotentiometerValue(type_t analogType, uint8_t analogID, uint32
                 if (midiID >= 96)
                     break;    //not allowed
 
-                midi.sendControlChange(midiID, encDec_14bit.high, channel);
-                midi.sendControlChange(midiID + 32, encDec_14bit.low, channel);
+                sendControlChange(midi, midiID, encDec_14bit.high, channel);
+                sendControlChange(midi, midiID + 32, encDec_14bit.low, channel);
             }
             else
             {
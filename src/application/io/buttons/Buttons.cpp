@@ -21,19 +21,45 @@ limitations under the License.
 
 using namespace IO;
 
+namespace
+{
+    ///
+    /// \brief Calculates amount of consecutive equal readings needed for button state to be considered stable.
+    /// Equals to the number of zero bits in BUTTON_DEBOUNCE_COMPARE.
+    ///
+    constexpr uint8_t debounceReadings(uint8_t compare, uint8_t bit = 0)
+    {
+        return bit == 8 ? 0 : !((compare >> bit) & 0x01) + debounceReadings(compare, bit + 1);
+    }
+
+    ///
+    /// \brief Value which vertical counter must hold in order for the new reading to be accepted.
+    ///
+    constexpr uint8_t debounceTarget = debounceReadings(BUTTON_DEBOUNCE_COMPARE) ? debounceReadings(BUTTON_DEBOUNCE_COMPARE) - 1 : 0;
+
+    static_assert(debounceTarget < 8, "Debounce counter must fit in three bits.");
+}    // namespace
+
 ///
 /// \brief Continuously reads inputs from buttons and acts if necessary.
 ///
 void Buttons::update()
 {
-    for (int i = 0; i < MAX_NUMBER_OF_BUTTONS; i++)
+    for (size_t i = 0; i < debounceArraySize; i++)
     {
-        bool state = hwa.state(i);
+        uint8_t changed = debounce(i, hwa.packedState(i));
+
+        //process only the buttons which have changed the state
+        while (changed)
+        {
+            uint8_t bit = 0;
 
-        if (!buttonDebounced(i, state))
-            continue;
+            while (!BIT_READ(changed, bit))
+                bit++;
 
-        processButton(i, state);
+            changed &= changed - 1;
+            processButton(i * 8 + bit, BIT_READ(debouncedState[i], bit));
+        }
     }
 }
 
@@ -199,7 +225,7 @@ void Buttons::sendMessage(uint8_t buttonID, bool state, messageType_t buttonMess
 
         case messageType_t::controlChange:
         case messageType_t::controlChangeReset:
-            midi.sendControlChange(note, velocity, channel);
+            sendControlChange(midi, note, velocity, channel);
 #ifdef DISPLAY_SUPPORTED
             display.displayMIDIevent(Display::eventType_t::out, Display::event_t::controlChange, note, velocity, channel + 1);
 #endif
@@ -298,7 +324,7 @@ void Buttons::sendMessage(uint8_t buttonID, bool state, messageType_t buttonMess
             break;
 
         case messageType_t::controlChangeReset:
-            midi.sendControlChange(note, 0, channel);
+            sendControlChange(midi, note, 0, channel);
 #ifdef DISPLAY_SUPPORTED
             display.displayMIDIevent(Display::eventType_t::out, Display::event_t::controlChange, note, 0, channel + 1);
 #endif
@@ -379,21 +405,41 @@ bool Buttons::getLatchingState(uint8_t buttonID)
 }
 
 ///
-/// \brief Checks if button reading is stable.
-/// Shift old value to the left, append new value and
-/// append DEBOUNCE_COMPARE with OR command. If final value is equal to 0xFF or
-/// DEBOUNCE_COMPARE, signal is debounced.
-/// @param [in] buttonID    Button index which is being checked.
-/// @param [in] state Current button state.
-/// \returns                True if button reading is stable, false otherwise.
+/// \brief Debounces eight buttons at once using vertical counters.
+/// Button state is considered stable once the same reading has been received
+/// in a row for the amount of times specified with BUTTON_DEBOUNCE_COMPARE.
+/// @param [in] arrayIndex  Index of button group.
+/// @param [in] states      Current readings for all buttons in group.
+/// \returns Mask of buttons in group for which debounced state has changed.
 ///
-bool Buttons::buttonDebounced(uint8_t buttonID, bool state)
+uint8_t Buttons::debounce(size_t arrayIndex, uint8_t states)
 {
-    //shift new button reading into previousButtonState
-    buttonDebounceCounter[buttonID] = (buttonDebounceCounter[buttonID] << (uint8_t)1) | (uint8_t)state | BUTTON_DEBOUNCE_COMPARE;
+    //only the buttons which currently differ from debounced state are being counted
+    uint8_t delta = states ^ debouncedState[arrayIndex];
+
+    uint8_t& counter0 = debounceCounter[0][arrayIndex];
+    uint8_t& counter1 = debounceCounter[1][arrayIndex];
+    uint8_t& counter2 = debounceCounter[2][arrayIndex];
 
-    //if button is debounced, return true
-    return ((buttonDebounceCounter[buttonID] == BUTTON_DEBOUNCE_COMPARE) || (buttonDebounceCounter[buttonID] == 0xFF));
+    //buttons whose counter has reached the target value
+    uint8_t target = ~(counter0 ^ (BIT_READ(debounceTarget, 0) ? 0xFF : 0x00)) &
+                     ~(counter1 ^ (BIT_READ(debounceTarget, 1) ? 0xFF : 0x00)) &
+                     ~(counter2 ^ (BIT_READ(debounceTarget, 2) ? 0xFF : 0x00));
+
+    uint8_t changed = delta & target;
+    uint8_t count   = delta & ~changed;
+
+    //increment the counters of the buttons still being counted, reset all others
+    uint8_t carry1 = counter0 & count;
+    uint8_t carry2 = counter1 & carry1;
+
+    counter0 = (counter0 ^ count) & count;
+    counter1 = (counter1 ^ carry1) & count;
+    counter2 = (counter2 ^ carry2) & count;
+
+    debouncedState[arrayIndex] ^= changed;
+
+    return changed;
 }
 
 ///
@@ -402,7 +448,17 @@ bool Buttons::buttonDebounced(uint8_t buttonID, bool state)
 ///
 void Buttons::reset(uint8_t buttonID)
 {
-    buttonDebounceCounter[buttonID] = 0;
+    if (buttonID < MAX_NUMBER_OF_BUTTONS)
+    {
+        uint8_t arrayIndex  = buttonID / 8;
+        uint8_t buttonIndex = buttonID - 8 * arrayIndex;
+
+        BIT_WRITE(debouncedState[arrayIndex], buttonIndex, false);
+
+        for (int i = 0; i < 3; i++)
+            BIT_WRITE(debounceCounter[i][arrayIndex], buttonIndex, false);
+    }
+
     setButtonState(buttonID, false);
     setLatchingState(buttonID, false);
 }
\ No newline at end of file
@@ -79,6 +79,30 @@ namespace IO
         {
             public:
             virtual bool state(size_t index) = 0;
+
+            ///
+            /// \brief Reads states of eight consecutive buttons at once.
+            /// Default implementation reads the buttons one by one. Should be overriden when
+            /// hardware already provides button states in packed form.
+            /// @param [in] arrayIndex  Index of button group (first button in group is arrayIndex * 8).
+            /// \returns Button states, first button in group is stored in bit 0.
+            ///
+            virtual uint8_t packedState(size_t arrayIndex)
+            {
+                uint8_t states = 0;
+
+                for (size_t i = 0; i < 8; i++)
+                {
+                    size_t index = arrayIndex * 8 + i;
+
+                    if (index >= MAX_NUMBER_OF_BUTTONS)
+                        break;
+
+                    states |= static_cast<uint8_t>(state(index)) << i;
+                }
+
+                return states;
+            }
         };
 
 #ifdef DISPLAY_SUPPORTED
@@ -106,7 +130,7 @@ namespace IO
         void setButtonState(uint8_t buttonID, uint8_t state);
         void setLatchingState(uint8_t buttonID, uint8_t state);
         bool getLatchingState(uint8_t buttonID);
-        bool buttonDebounced(uint8_t buttonID, bool state);
+        uint8_t debounce(size_t arrayIndex, uint8_t states);
         void customHook(uint8_t buttonID, bool state);
 
         HWA&      hwa;
@@ -119,9 +143,20 @@ namespace IO
         ComponentInfo& cInfo;
 
         ///
-        /// \brief Array holding debounce count for all buttons to avoid incorrect state detection.
+        /// \brief Total number of bytes needed to store packed states of all physical buttons.
+        ///
+        static constexpr size_t debounceArraySize = (MAX_NUMBER_OF_BUTTONS + 7) / 8;
+
+        ///
+        /// \brief Array holding last debounced (stable) state for all physical buttons.
+        ///
+        uint8_t debouncedState[debounceArraySize] = {};
+
+        ///
+        /// \brief Vertical counters used for debouncing, one bit plane per counter bit.
+        /// Each counter holds the number of consecutive readings which differ from the debounced state.
         ///
-        uint8_t buttonDebounceCounter[MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS] = {};
+        uint8_t debounceCounter[3][debounceArraySize] = {};
 
         ///
         /// \brief Array holding current state for all buttons.
@@ -18,9 +18,20 @@ limitations under the License.
 
 #include "Common.h"
 
+namespace
+{
+    ///
+    /// \brief Flag set in stored NRPN parameter to indicate that the parameter is selected.
+    /// Zero-initialized channels don't have any parameter selected.
+    ///
+    constexpr uint16_t NRPN_SELECTED = 0x8000;
+}    // namespace
+
 namespace IO
 {
-    uint8_t Common::pcValue[16] = {};
+    uint8_t  Common::pcValue[16]        = {};
+    uint16_t Common::nrpnParameter[16]  = {};
+    bool     Common::nrpnSelectionCache = true;
 
     bool Common::pcIncrement(uint8_t channel)
     {
@@ -69,4 +80,56 @@ namespace IO
         pcValue[channel] = program;
         return true;
     }
-}    // namespace IO
\ No newline at end of file
+
+    void Common::resetNRPNselection()
+    {
+        for (int i = 0; i < 16; i++)
+            nrpnParameter[i] = 0;
+    }
+
+    void Common::setNRPNselectionCache(bool state)
+    {
+        nrpnSelectionCache = state;
+        resetNRPNselection();
+    }
+
+    void Common::selectNRPN(MIDI& midi, uint8_t channel, uint16_t parameter)
+    {
+        if (channel >= 16)
+            return;
+
+        if (nrpnSelectionCache && (nrpnParameter[channel] == (parameter | NRPN_SELECTED)))
+            return;
+
+        MIDI::encDec_14bit_t encDec_14bit;
+
+        encDec_14bit.value = parameter;
+        encDec_14bit.split14bit();
+
+        midi.sendControlChange(99, encDec_14bit.high, channel);
+        midi.sendControlChange(98, encDec_14bit.low, channel);
+
+        nrpnParameter[channel] = parameter | NRPN_SELECTED;
+    }
+
+    void Common::sendControlChange(MIDI& midi, uint8_t controller, uint8_t value, uint8_t channel)
+    {
+        midi.sendControlChange(controller, value, channel);
+
+        if (channel >= 16)
+            return;
+
+        switch (controller)
+        {
+        case 98:     //NRPN LSB
+        case 99:     //NRPN MSB
+        case 100:    //RPN LSB
+        case 101:    //RPN MSB
+            nrpnParameter[channel] = 0;
+            break;
+
+        default:
+            break;
+        }
+    }
+}    // namespace IO
@@ -19,6 +19,7 @@ limitations under the License.
 #pragma once
 
 #include <inttypes.h>
+#include "midi/src/MIDI.h"
 
 namespace IO
 {
@@ -32,10 +33,47 @@ namespace IO
         uint8_t program(uint8_t channel);
         bool    setProgram(uint8_t channel, uint8_t program);
 
+        ///
+        /// \brief Forgets NRPN parameters selected on all MIDI channels.
+        /// Next NRPN message on each channel will contain full parameter selection.
+        ///
+        static void resetNRPNselection();
+
+        ///
+        /// \brief Enables or disables skipping of NRPN parameter selection already made on the channel.
+        /// Should be disabled when other data is mixed into the output without being seen by the application.
+        /// When disabled, every NRPN message contains full parameter selection.
+        ///
+        static void setNRPNselectionCache(bool state);
+
         protected:
+        ///
+        /// \brief Sends NRPN parameter selection (CC 99 and CC 98) on specified channel
+        /// unless the same parameter is already selected on it.
+        ///
+        static void selectNRPN(MIDI& midi, uint8_t channel, uint16_t parameter);
+
+        ///
+        /// \brief Sends control change message on specified channel.
+        /// Should be used for all controllers which can be configured by user: if the controller
+        /// is one of NRPN/RPN parameter selection controllers (CC 98-101), NRPN parameter
+        /// remembered for the channel is forgotten.
+        ///
+        static void sendControlChange(MIDI& midi, uint8_t controller, uint8_t value, uint8_t channel);
+
         ///
         /// \brief Holds current program change value for all 16 MIDI channels.
         ///
         static uint8_t pcValue[16];
+
+        ///
+        /// \brief Holds last NRPN parameter selected on all 16 MIDI channels.
+        ///
+        static uint16_t nrpnParameter[16];
+
+        ///
+        /// \brief Set if NRPN parameter selection is skipped when the same parameter is already selected.
+        ///
+        static bool nrpnSelectionCache;
     };
 }    // namespace IO
\ No newline at end of file
@@ -35,4 +35,14 @@ limitations under the License.
 ///
 /// \brief Time threshold in milliseconds between two encoder steps used to detect fast movement.
 ///
-#define ENCODERS_SPEED_TIMEOUT 140
\ No newline at end of file
+#define ENCODERS_SPEED_TIMEOUT 140
+
+///
+/// \brief Maximum configurable time in milliseconds during which encoder steps are aggregated into single message.
+///
+#define ENCODERS_MAX_AGGREGATION_TIME 100
+
+///
+/// \brief Maximum amount of steps which can be sent in single message in 7Fh01h and 3Fh41h modes.
+///
+#define ENCODERS_MAX_AGGREGATED_STEPS 63
\ No newline at end of file
@@ -28,6 +28,8 @@ using namespace IO;
 ///
 void Encoders::init()
 {
+    rebuildConfig();
+
     for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
         resetValue(i);
 }
@@ -37,12 +39,17 @@ void Encoders::init()
 ///
 void Encoders::update()
 {
+    //encoder configuration has changed, either through sysex, preset change or factory reset
+    if (!configBuilt || (configRevision != database.revision(Database::block_t::encoders)))
+        rebuildConfig();
+
     for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
     {
-        if (!database.read(Database::Section::encoder_t::enable, i))
+        if (!encoderConfig[i].enabled)
             continue;
 
-        position_t encoderState = read(i, hwa.state(i));
+        position_t encoderState    = read(i, hwa.state(i));
+        uint8_t    aggregationTime = encoderConfig[i].aggregationTime;
 
         //disable debounce mode if encoder isn't moving for more than
         //ENCODERS_DEBOUNCE_RESET_TIME milliseconds
@@ -54,7 +61,7 @@ void Encoders::update()
 
         if (encoderState != position_t::stopped)
         {
-            if (database.read(Database::Section::encoder_t::invert, i))
+            if (encoderConfig[i].invert)
             {
                 if (encoderState == position_t::ccw)
                     encoderState = position_t::cw;
@@ -76,7 +83,7 @@ void Encoders::update()
                 }
             }
 
-            uint8_t encAcceleration = database.read(Database::Section::encoder_t::acceleration, i);
+            uint8_t encAcceleration = encoderConfig[i].acceleration;
 
             if (encAcceleration)
             {
@@ -94,21 +101,38 @@ void Encoders::update()
             if (debounceDirection[i] != position_t::stopped)
                 encoderState = debounceDirection[i];
 
-            uint8_t  midiID       = database.read(Database::Section::encoder_t::midiID, i);
-            uint8_t  channel      = database.read(Database::Section::encoder_t::midiChannel, i);
-            auto     type         = static_cast<type_t>(database.read(Database::Section::encoder_t::mode, i));
+            uint8_t  channel      = encoderConfig[i].channel;
+            auto     type         = encoderConfig[i].type;
             bool     validType    = true;
+            bool     aggregate    = false;
             uint16_t encoderValue = 0;
             uint8_t  steps        = (encoderSpeed[i] > 0) ? encoderSpeed[i] : 1;
             bool     use14bit     = false;
 
-            MIDI::encDec_14bit_t encDec_14bit;
-
             switch (type)
             {
             case type_t::t7Fh01h:
             case type_t::t3Fh41h:
-                encoderValue = encValue[static_cast<uint8_t>(type)][static_cast<uint8_t>(encoderState)];
+                if (aggregationTime)
+                {
+                    aggregatedSteps[i] += (encoderState == position_t::cw) ? 1 : -1;
+
+                    //single message can't hold more steps: send them right away
+                    if (abs(aggregatedSteps[i]) < ENCODERS_MAX_AGGREGATED_STEPS)
+                    {
+                        aggregate = true;
+                    }
+                    else
+                    {
+                        encoderValue         = relativeValue(type, aggregatedSteps[i]);
+                        aggregatedSteps[i]   = 0;
+                        aggregationActive[i] = false;
+                    }
+                }
+                else
+                {
+                    encoderValue = encValue[static_cast<uint8_t>(type)][static_cast<uint8_t>(encoderState)];
+                }
                 break;
 
             case type_t::tProgramChange:
@@ -155,6 +179,10 @@ void Encoders::update()
                 }
 
                 encoderValue = midiValue[i];
+
+                //only the last value is sent in absolute modes
+                if ((type == type_t::tControlChange) || (type == type_t::tPitchBend))
+                    aggregate = (aggregationTime != 0);
                 break;
 
             case type_t::tPresetChange:
@@ -166,81 +194,185 @@ void Encoders::update()
                 break;
             }
 
-            if (validType)
+            if (validType && aggregate)
             {
-                if (type == type_t::tProgramChange)
+                //message is sent once aggregation time passes
+                if (!aggregationActive[i])
                 {
-                    midi.sendProgramChange(encoderValue, channel);
+                    aggregationActive[i]    = true;
+                    aggregationStartTime[i] = core::timing::currentRunTimeMs();
+                }
+            }
+            else
+            {
+                if (validType)
+                    sendMessage(i, type, encoderValue, encoderState);
+
+                cInfo.send(Database::block_t::encoders, i);
+            }
+        }
+
+        if (aggregationActive[i] && (static_cast<uint16_t>(core::timing::currentRunTimeMs() - aggregationStartTime[i]) >= aggregationTime))
+            sendAggregated(i);
+    }
+}
+
+///
+/// \brief Sends the MIDI message for specified encoder.
+/// @param [in] encoderID       Encoder for which the message is sent.
+/// @param [in] type            Encoder type. See type_t.
+/// @param [in] encoderValue    Value to send.
+/// @param [in] encoderState    Direction of last movement. Used in preset change mode only.
+///
+void Encoders::sendMessage(uint8_t encoderID, type_t type, uint16_t encoderValue, position_t encoderState)
+{
+    uint8_t midiID  = encoderConfig[encoderID].midiID;
+    uint8_t channel = encoderConfig[encoderID].channel;
+
+    MIDI::encDec_14bit_t encDec_14bit;
+
+    if (type == type_t::tProgramChange)
+    {
+        midi.sendProgramChange(encoderValue, channel);
 #ifdef DISPLAY_SUPPORTED
-                    display.displayMIDIevent(Display::eventType_t::out, Display::event_t::programChange, midiID & 0x7F, encoderValue, channel + 1);
+        display.displayMIDIevent(Display::eventType_t::out, Display::event_t::programChange, midiID & 0x7F, encoderValue, channel + 1);
 #endif
-                }
-                else if (type == type_t::tPitchBend)
-                {
-                    midi.sendPitchBend(encoderValue, channel);
+    }
+    else if (type == type_t::tPitchBend)
+    {
+        midi.sendPitchBend(encoderValue, channel);
 #ifdef DISPLAY_SUPPORTED
-                    display.displayMIDIevent(Display::eventType_t::out, Display::event_t::pitchBend, midiID & 0x7F, encoderValue, channel + 1);
+        display.displayMIDIevent(Display::eventType_t::out, Display::event_t::pitchBend, midiID & 0x7F, encoderValue, channel + 1);
 #endif
-                }
-                else if ((type == type_t::tNRPN7bit) || (type == type_t::tNRPN14bit) || (type == type_t::tControlChange14bit))
-                {
-                    encDec_14bit.value = midiID;
-                    encDec_14bit.split14bit();
+    }
+    else if ((type == type_t::tNRPN7bit) || (type == type_t::tNRPN14bit) || (type == type_t::tControlChange14bit))
+    {
+        encDec_14bit.value = midiID;
+        encDec_14bit.split14bit();
 
-                    midi.sendControlChange(99, encDec_14bit.high, channel);
-                    midi.sendControlChange(98, encDec_14bit.low, channel);
+        selectNRPN(midi, channel, midiID);
 
-                    if (type == type_t::tNRPN7bit)
-                    {
-                        midi.sendControlChange(6, encoderValue, channel);
-                    }
-                    else
-                    {
-                        midiID = encDec_14bit.low;
-
-                        encDec_14bit.value = encoderValue;
-                        encDec_14bit.split14bit();
-
-                        if (type == type_t::tControlChange14bit)
-                        {
-                            if (midiID >= 96)
-                                break;    //not allowed
-
-                            midi.sendControlChange(midiID, encDec_14bit.high, channel);
-                            midi.sendControlChange(midiID + 32, encDec_14bit.low, channel);
-                        }
-                        else
-                        {
-                            midi.sendControlChange(6, encDec_14bit.high, channel);
-                            midi.sendControlChange(38, encDec_14bit.low, channel);
-                        }
-                    }
+        if (type == type_t::tNRPN7bit)
+        {
+            midi.sendControlChange(6, encoderValue, channel);
+        }
+        else
+        {
+            midiID = encDec_14bit.low;
+
+            encDec_14bit.value = encoderValue;
+            encDec_14bit.split14bit();
+
+            if (type == type_t::tControlChange14bit)
+            {
+                if (midiID >= 96)
+                    return;    //not allowed
+
+                sendControlChange(midi, midiID, encDec_14bit.high, channel);
+                sendControlChange(midi, midiID + 32, encDec_14bit.low, channel);
+            }
+            else
+            {
+                midi.sendControlChange(6, encDec_14bit.high, channel);
+                midi.sendControlChange(38, encDec_14bit.low, channel);
+            }
+        }
 
 #ifdef DISPLAY_SUPPORTED
-                    display.displayMIDIevent(Display::eventType_t::out, (type == type_t::tControlChange14bit) ? Display::event_t::controlChange : Display::event_t::nrpn, midiID, encoderValue, channel + 1);
+        display.displayMIDIevent(Display::eventType_t::out, (type == type_t::tControlChange14bit) ? Display::event_t::controlChange : Display::event_t::nrpn, midiID, encoderValue, channel + 1);
 #endif
-                }
-                else if (type != type_t::tPresetChange)
-                {
-                    midi.sendControlChange(midiID, encoderValue, channel);
+    }
+    else if (type != type_t::tPresetChange)
+    {
+        sendControlChange(midi, midiID, encoderValue, channel);
 #ifdef DISPLAY_SUPPORTED
-                    display.displayMIDIevent(Display::eventType_t::out, Display::event_t::controlChange, midiID & 0x7F, encoderValue, channel + 1);
+        display.displayMIDIevent(Display::eventType_t::out, Display::event_t::controlChange, midiID & 0x7F, encoderValue, channel + 1);
 #endif
-                }
-                else
-                {
-                    uint8_t preset = database.getPreset();
-                    preset += (encoderState == position_t::cw) ? 1 : -1;
+    }
+    else
+    {
+        uint8_t preset = database.getPreset();
+        preset += (encoderState == position_t::cw) ? 1 : -1;
 
-                    database.setPreset(preset);
-                }
-            }
+        database.setPreset(preset);
+    }
+}
 
-            cInfo.send(Database::block_t::encoders, i);
-        }
+///
+/// \brief Sends the value accumulated during aggregation time for specified encoder.
+///
+void Encoders::sendAggregated(uint8_t encoderID)
+{
+    auto type = encoderConfig[encoderID].type;
+
+    aggregationActive[encoderID] = false;
+
+    if ((type == type_t::t7Fh01h) || (type == type_t::t3Fh41h))
+    {
+        //movements in opposite directions have cancelled each other out
+        if (!aggregatedSteps[encoderID])
+            return;
+
+        sendMessage(encoderID, type, relativeValue(type, aggregatedSteps[encoderID]), position_t::stopped);
+        aggregatedSteps[encoderID] = 0;
+    }
+    else
+    {
+        sendMessage(encoderID, type, midiValue[encoderID], position_t::stopped);
+    }
+
+    cInfo.send(Database::block_t::encoders, encoderID);
+}
+
+///
+/// \brief Copies settings of all encoders from database to RAM.
+/// Steps collected with old settings shouldn't be sent with the new ones, so aggregation is reset as well.
+///
+void Encoders::rebuildConfig()
+{
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+    {
+        encoderConfig[i].enabled         = database.read(Database::Section::encoder_t::enable, i);
+        encoderConfig[i].invert          = database.read(Database::Section::encoder_t::invert, i);
+        encoderConfig[i].type            = static_cast<type_t>(database.read(Database::Section::encoder_t::mode, i));
+        encoderConfig[i].midiID          = database.read(Database::Section::encoder_t::midiID, i);
+        encoderConfig[i].channel         = database.read(Database::Section::encoder_t::midiChannel, i);
+        encoderConfig[i].acceleration    = database.read(Database::Section::encoder_t::acceleration, i);
+        encoderConfig[i].pulsesPerStep   = database.read(Database::Section::encoder_t::pulsesPerStep, i);
+        encoderConfig[i].aggregationTime = database.read(Database::Section::encoder_t::aggregationTime, i);
+    }
+
+    resetAggregation();
+
+    configRevision = database.revision(Database::block_t::encoders);
+    configBuilt    = true;
+}
+
+///
+/// \brief Drops the steps and values collected during aggregation time for all encoders.
+///
+void Encoders::resetAggregation()
+{
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+    {
+        aggregatedSteps[i]   = 0;
+        aggregationActive[i] = false;
     }
 }
 
+///
+/// \brief Converts amount of steps to value used in 7Fh01h or 3Fh41h mode.
+/// @param [in] type    Encoder type. See type_t.
+/// @param [in] steps   Amount of steps, positive for clockwise movement.
+///
+uint8_t Encoders::relativeValue(type_t type, int8_t steps)
+{
+    if (type == type_t::t7Fh01h)
+        return steps & 0x7F;
+
+    return 64 + steps;
+}
+
 ///
 /// \brief Sets the MIDI value of specified encoder to default.
 ///
@@ -257,6 +389,8 @@ void Encoders::resetValue(uint8_t encoderID)
     debounceCounter[encoderID]   = 0;
     encoderData[encoderID]       = 0;
     encoderPulses[encoderID]     = 0;
+    aggregatedSteps[encoderID]   = 0;
+    aggregationActive[encoderID] = false;
 }
 
 void Encoders::setValue(uint8_t encoderID, uint16_t value)
@@ -292,7 +426,7 @@ Encoders::position_t Encoders::read(uint8_t encoderID, uint8_t pairState)
 
     encoderPulses[encoderID] += encoderLookUpTable[encoderData[encoderID] & 0x0F];
 
-    if (abs(encoderPulses[encoderID]) >= database.read(Database::Section::encoder_t::pulsesPerStep, encoderID))
+    if (abs(encoderPulses[encoderID]) >= encoderConfig[encoderID].pulsesPerStep)
     {
         returnValue = (encoderPulses[encoderID] > 0) ? position_t::ccw : position_t::cw;
         //reset count
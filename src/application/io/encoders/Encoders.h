@@ -103,6 +103,44 @@ namespace IO
 #endif
         ComponentInfo& cInfo;
 
+        void    sendMessage(uint8_t encoderID, type_t type, uint16_t encoderValue, position_t encoderState);
+        void    sendAggregated(uint8_t encoderID);
+        uint8_t relativeValue(type_t type, int8_t steps);
+        void    rebuildConfig();
+        void    resetAggregation();
+
+        ///
+        /// \brief Settings of single encoder needed on every scan.
+        ///
+        struct encoderConfig_t
+        {
+            bool     enabled;
+            bool     invert;
+            type_t   type;
+            uint16_t midiID;
+            uint8_t  channel;
+            uint8_t  acceleration;
+            uint8_t  pulsesPerStep;
+            uint8_t  aggregationTime;
+        };
+
+        ///
+        /// \brief RAM copy of encoder settings, built from encoders database block.
+        /// Used so that scanning doesn't need to go through database on every pass.
+        ///
+        encoderConfig_t encoderConfig[MAX_NUMBER_OF_ENCODERS] = {};
+
+        ///
+        /// \brief Revision of encoders database block used to build the settings copy.
+        /// Steps aggregated with older settings are dropped once the copy is rebuilt.
+        ///
+        uint32_t configRevision = 0;
+
+        ///
+        /// \brief Set to true once the settings copy has been built.
+        ///
+        bool configBuilt = false;
+
         ///
         /// \brief Holds current MIDI value for all encoders.
         ///
@@ -138,6 +176,23 @@ namespace IO
         ///
         uint8_t debounceCounter[MAX_NUMBER_OF_ENCODERS] = {};
 
+        ///
+        /// \brief Array holding amount of steps made during aggregation time for all encoders.
+        /// Used in 7Fh01h and 3Fh41h modes only. Positive values indicate clockwise movement.
+        ///
+        int8_t aggregatedSteps[MAX_NUMBER_OF_ENCODERS] = {};
+
+        ///
+        /// \brief Array holding time (lower 16 bits) at which aggregation has started for all encoders.
+        ///
+        uint16_t aggregationStartTime[MAX_NUMBER_OF_ENCODERS] = {};
+
+        ///
+        /// \brief Array holding aggregation state for all encoders.
+        /// When aggregation is active, messages are sent once aggregation time passes.
+        ///
+        bool aggregationActive[MAX_NUMBER_OF_ENCODERS] = {};
+
         ///
         /// \brief Array holding last two readings from encoder pins.
         ///
@@ -151,180 +151,242 @@ LEDs::blinkSpeed_t LEDs::valueToBlinkSpeed(uint8_t value)
 
 void LEDs::midiToState(MIDI::messageType_t messageType, uint8_t data1, uint8_t data2, uint8_t channel, bool local)
 {
-    for (size_t i = 0; i < maxLEDs; i++)
+    if (!lookupBuilt || (lookupRevision != database.revision(Database::block_t::leds)))
+        rebuildLookup();
+
+    if (messageType == MIDI::messageType_t::programChange)
     {
-        //no point in checking if channel doesn't match
-        if (database.read(Database::Section::leds_t::midiChannel, i) != channel)
-            continue;
+        //program change turns off all the leds on the channel which don't match the received ID
+        //check all of them in this case
+        for (size_t i = 0; i < maxLEDs; i++)
+        {
+            if (database.read(Database::Section::leds_t::midiChannel, i) != channel)
+                continue;
 
-        bool setState = false;
-        bool setBlink = false;
+            midiToStateSingle(i, messageType, data1, data2, local);
+        }
 
-        auto controlType = static_cast<controlType_t>(database.read(Database::Section::leds_t::controlType, i));
+        return;
+    }
 
-        //determine whether led state or blink state should be changed
-        //received MIDI message must match with defined control type
-        if (local)
-        {
-            switch (controlType)
-            {
-            case controlType_t::localNoteForStateNoBlink:
-                if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
-                    setState = true;
-                break;
+    //for other messages only the leds with matching channel and activation ID can change
+    //binary search for the first matching entry
+    uint16_t key   = lookupKey(channel, data1);
+    size_t   first = 0;
+    size_t   last  = maxLEDs;
 
-            case controlType_t::localCCforStateNoBlink:
-                if (messageType == MIDI::messageType_t::controlChange)
-                    setState = true;
-                break;
+    while (first < last)
+    {
+        size_t middle = first + ((last - first) / 2);
 
-            //set state for program change control type regardless of local/midi in setting
-            case controlType_t::midiInPCforStateNoBlink:
-            case controlType_t::localPCforStateNoBlink:
-                if (messageType == MIDI::messageType_t::programChange)
-                    setState = true;
-                break;
+        if (lookupKeys[middle] < key)
+            first = middle + 1;
+        else
+            last = middle;
+    }
 
-            case controlType_t::midiInNoteForStateAndBlink:
-                if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
-                {
-                    setState = true;
-                    setBlink = true;
-                }
-                break;
+    for (size_t i = first; (i < maxLEDs) && (lookupKeys[i] == key); i++)
+        midiToStateSingle(lookupIndex[i], messageType, data1, data2, local);
+}
 
-            case controlType_t::midiInCCforStateAndBlink:
-                if (messageType == MIDI::messageType_t::controlChange)
-                {
-                    setState = true;
-                    setBlink = true;
-                }
-                break;
+void LEDs::midiToStateSingle(size_t i, MIDI::messageType_t messageType, uint8_t data1, uint8_t data2, bool local)
+{
+    bool setState = false;
+    bool setBlink = false;
 
-            default:
-                break;
-            }
-        }
-        else
+    auto controlType = static_cast<controlType_t>(database.read(Database::Section::leds_t::controlType, i));
+
+    //determine whether led state or blink state should be changed
+    //received MIDI message must match with defined control type
+    if (local)
+    {
+        switch (controlType)
         {
-            switch (controlType)
+        case controlType_t::localNoteForStateNoBlink:
+            if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
+                setState = true;
+            break;
+
+        case controlType_t::localCCforStateNoBlink:
+            if (messageType == MIDI::messageType_t::controlChange)
+                setState = true;
+            break;
+
+        //set state for program change control type regardless of local/midi in setting
+        case controlType_t::midiInPCforStateNoBlink:
+        case controlType_t::localPCforStateNoBlink:
+            if (messageType == MIDI::messageType_t::programChange)
+                setState = true;
+            break;
+
+        case controlType_t::midiInNoteForStateAndBlink:
+            if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
             {
-            case controlType_t::midiInNoteForStateCCforBlink:
-                if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
-                    setState = true;
-                else if (messageType == MIDI::messageType_t::controlChange)
-                    setBlink = true;
-                break;
+                setState = true;
+                setBlink = true;
+            }
+            break;
 
-            case controlType_t::midiInCCforStateNoteForBlink:
-                if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
-                    setBlink = true;
-                else if (messageType == MIDI::messageType_t::controlChange)
-                    setState = true;
-                break;
+        case controlType_t::midiInCCforStateAndBlink:
+            if (messageType == MIDI::messageType_t::controlChange)
+            {
+                setState = true;
+                setBlink = true;
+            }
+            break;
 
-            case controlType_t::midiInNoteForStateAndBlink:
-                if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
-                {
-                    setState = true;
-                    setBlink = true;
-                }
-                break;
+        default:
+            break;
+        }
+    }
+    else
+    {
+        switch (controlType)
+        {
+        case controlType_t::midiInNoteForStateCCforBlink:
+            if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
+                setState = true;
+            else if (messageType == MIDI::messageType_t::controlChange)
+                setBlink = true;
+            break;
+
+        case controlType_t::midiInCCforStateNoteForBlink:
+            if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
+                setBlink = true;
+            else if (messageType == MIDI::messageType_t::controlChange)
+                setState = true;
+            break;
+
+        case controlType_t::midiInNoteForStateAndBlink:
+            if ((messageType == MIDI::messageType_t::noteOn) || (messageType == MIDI::messageType_t::noteOff))
+            {
+                setState = true;
+                setBlink = true;
+            }
+            break;
 
-            case controlType_t::midiInCCforStateAndBlink:
-                if (messageType == MIDI::messageType_t::controlChange)
-                {
-                    setState = true;
-                    setBlink = true;
-                }
-                break;
+        case controlType_t::midiInCCforStateAndBlink:
+            if (messageType == MIDI::messageType_t::controlChange)
+            {
+                setState = true;
+                setBlink = true;
+            }
+            break;
 
-            //set state for program change control type regardless of local/midi in setting
-            case controlType_t::midiInPCforStateNoBlink:
-            case controlType_t::localPCforStateNoBlink:
-                if (messageType == MIDI::messageType_t::programChange)
-                    setState = true;
-                break;
+        //set state for program change control type regardless of local/midi in setting
+        case controlType_t::midiInPCforStateNoBlink:
+        case controlType_t::localPCforStateNoBlink:
+            if (messageType == MIDI::messageType_t::programChange)
+                setState = true;
+            break;
 
-            default:
-                break;
-            }
+        default:
+            break;
         }
+    }
 
-        auto color      = color_t::off;
-        bool rgbEnabled = database.read(Database::Section::leds_t::rgbEnable, hwa.rgbIndex(i));
+    auto color      = color_t::off;
+    bool rgbEnabled = database.read(Database::Section::leds_t::rgbEnable, hwa.rgbIndex(i));
 
-        if (setState)
+    if (setState)
+    {
+        //match activation ID with received ID
+        if (database.read(Database::Section::leds_t::activationID, i) == data1)
         {
-            //match activation ID with received ID
-            if (database.read(Database::Section::leds_t::activationID, i) == data1)
+            if (messageType == MIDI::messageType_t::programChange)
             {
-                if (messageType == MIDI::messageType_t::programChange)
-                {
-                    //byte2 doesn't exist on program change message
-                    //color depends on data1 if rgb led is enabled
-                    //otherwise just turn the led on - no activation value check
-                    if (rgbEnabled)
-                        color = valueToColor(data1);
-                    else
-                        color = color_t::red;    //any color is fine on single-color led
-                }
+                //byte2 doesn't exist on program change message
+                //color depends on data1 if rgb led is enabled
+                //otherwise just turn the led on - no activation value check
+                if (rgbEnabled)
+                    color = valueToColor(data1);
                 else
-                {
-                    //use data2 value (note velocity / cc value) to set led color
-                    //and possibly blink speed (depending on configuration)
-                    //when note/cc are used to control both state and blinking ignore activation velocity
-                    if (rgbEnabled || (setState && setBlink))
-                        color = valueToColor(data2);
-                    else
-                        color = (database.read(Database::Section::leds_t::activationValue, i) == data2) ? color_t::red : color_t::off;
-                }
-
-                setColor(i, color);
+                    color = color_t::red;    //any color is fine on single-color led
             }
-            else if (messageType == MIDI::messageType_t::programChange)
+            else
             {
-                //when ID doesn't match and control type is program change, make sure to turn the led off
-                color = color_t::off;
-                setColor(i, color);
+                //use data2 value (note velocity / cc value) to set led color
+                //and possibly blink speed (depending on configuration)
+                //when note/cc are used to control both state and blinking ignore activation velocity
+                if (rgbEnabled || (setState && setBlink))
+                    color = valueToColor(data2);
+                else
+                    color = (database.read(Database::Section::leds_t::activationValue, i) == data2) ? color_t::red : color_t::off;
             }
+
+            setColor(i, color);
+        }
+        else if (messageType == MIDI::messageType_t::programChange)
+        {
+            //when ID doesn't match and control type is program change, make sure to turn the led off
+            color = color_t::off;
+            setColor(i, color);
         }
+    }
 
-        if (setBlink)
+    if (setBlink)
+    {
+        //match activation ID with received ID
+        if (database.read(Database::Section::leds_t::activationID, i) == data1)
         {
-            //match activation ID with received ID
-            if (database.read(Database::Section::leds_t::activationID, i) == data1)
+            if (setState)
             {
-                if (setState)
-                {
-                    auto blinkSpeed = static_cast<uint8_t>(blinkSpeed_t::noBlink);
-
-                    if (data2 && static_cast<bool>(color))
-                    {
-                        //single message is being used to set both state and blink value
-                        //first reduce data2 to range 0-15
-                        //append 1 so that first value is blinking one
-                        //turn off blinking only on higher range
-                        blinkSpeed = 1 + (data2 - ((static_cast<uint8_t>(color) * 16)));
-
-                        //make sure data2 is in range
-                        //when it's not turn off blinking
-                        if (blinkSpeed >= static_cast<uint8_t>(blinkSpeed_t::AMOUNT))
-                            blinkSpeed = static_cast<uint8_t>(blinkSpeed_t::noBlink);
-                    }
-
-                    setBlinkState(i, static_cast<blinkSpeed_t>(blinkSpeed));
-                }
-                else
+                auto blinkSpeed = static_cast<uint8_t>(blinkSpeed_t::noBlink);
+
+                if (data2 && static_cast<bool>(color))
                 {
-                    //blink speed depends on data2 value
-                    setBlinkState(i, valueToBlinkSpeed(data2));
+                    //single message is being used to set both state and blink value
+                    //first reduce data2 to range 0-15
+                    //append 1 so that first value is blinking one
+                    //turn off blinking only on higher range
+                    blinkSpeed = 1 + (data2 - ((static_cast<uint8_t>(color) * 16)));
+
+                    //make sure data2 is in range
+                    //when it's not turn off blinking
+                    if (blinkSpeed >= static_cast<uint8_t>(blinkSpeed_t::AMOUNT))
+                        blinkSpeed = static_cast<uint8_t>(blinkSpeed_t::noBlink);
                 }
+
+                setBlinkState(i, static_cast<blinkSpeed_t>(blinkSpeed));
+            }
+            else
+            {
+                //blink speed depends on data2 value
+                setBlinkState(i, valueToBlinkSpeed(data2));
             }
         }
     }
 }
 
+uint16_t LEDs::lookupKey(uint8_t channel, uint8_t activationID)
+{
+    return (static_cast<uint16_t>(channel) << 8) | activationID;
+}
+
+void LEDs::rebuildLookup()
+{
+    //insertion sort - keeps the leds with the same key in ascending order
+    for (size_t i = 0; i < maxLEDs; i++)
+    {
+        uint16_t key = lookupKey(database.read(Database::Section::leds_t::midiChannel, i),
+                                 database.read(Database::Section::leds_t::activationID, i));
+        size_t   j   = i;
+
+        while ((j > 0) && (lookupKeys[j - 1] > key))
+        {
+            lookupKeys[j]  = lookupKeys[j - 1];
+            lookupIndex[j] = lookupIndex[j - 1];
+            j--;
+        }
+
+        lookupKeys[j]  = key;
+        lookupIndex[j] = i;
+    }
+
+    lookupRevision = database.revision(Database::block_t::leds);
+    lookupBuilt    = true;
+}
+
 void LEDs::setBlinkState(uint8_t ledID, blinkSpeed_t state)
 {
     uint8_t ledArray[3], leds = 0;
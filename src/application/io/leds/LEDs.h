@@ -148,6 +148,9 @@ namespace IO
         blinkSpeed_t valueToBlinkSpeed(uint8_t value);
         void         handleLED(uint8_t ledID, bool state, bool rgbLED, rgbIndex_t index = rgbIndex_t::r);
         void         startUpAnimation();
+        void         midiToStateSingle(size_t index, MIDI::messageType_t messageType, uint8_t data1, uint8_t data2, bool local);
+        void         rebuildLookup();
+        uint16_t     lookupKey(uint8_t channel, uint8_t activationID);
 
         HWA&                    hwa;
         Database&               database;
@@ -163,6 +166,27 @@ namespace IO
         ///
         uint8_t blinkTimer[maxLEDs] = {};
 
+        ///
+        /// \brief Array holding LED indexes sorted by MIDI channel and activation ID.
+        /// Used to find LEDs which should react on incoming message without checking all of them.
+        ///
+        uint16_t lookupIndex[maxLEDs] = {};
+
+        ///
+        /// \brief Array holding lookup keys (MIDI channel and activation ID) for each entry in lookupIndex array.
+        ///
+        uint16_t lookupKeys[maxLEDs] = {};
+
+        ///
+        /// \brief Revision of LED database block used to build the lookup arrays.
+        ///
+        uint32_t lookupRevision = 0;
+
+        ///
+        /// \brief Set to true once the lookup arrays have been built.
+        ///
+        bool lookupBuilt = false;
+
         ///
         /// \brief Holds currently active LED blink type.
         ///
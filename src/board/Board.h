@@ -79,10 +79,45 @@ namespace Board
 
         ///
         /// \brief Used to write MIDI data to USB interface.
+        /// Depending on the target, data can be queued internally and sent once flush is called.
         /// @param [in] USBMIDIpacket   Pointer to structure holding MIDI data to write.
-        /// \returns True if data is available, false otherwise.
+        /// \returns True on success, false if the data couldn't be written or queued.
         ///
         bool writeMIDI(MIDI::USBMIDIpacket_t& USBMIDIpacket);
+
+        ///
+        /// \brief Structure holding outgoing USB MIDI statistics.
+        ///
+        typedef struct
+        {
+            uint32_t overflows;    ///< Number of packets dropped because outgoing buffer was full.
+            uint32_t stalls;       ///< Number of transfers which host hasn't collected in time. Packets dropped because of this aren't counted as overflows.
+        } txStats_t;
+
+        ///
+        /// \brief Sends all outgoing MIDI data which has been queued with writeMIDI.
+        /// Should be called once per main loop iteration so that queued data
+        /// doesn't wait for the outgoing buffer to fill up.
+        ///
+        void flush();
+
+        ///
+        /// \brief Retrieves outgoing USB MIDI statistics.
+        /// @param [in] stats   Reference to structure in which statistics are stored.
+        ///
+        void getTxStats(txStats_t& stats);
+
+        ///
+        /// \brief Returns number of received MIDI packets which haven't been read with readMIDI yet.
+        /// Only packets already received by the device are counted, not the ones still waiting on host.
+        ///
+        size_t rxPending();
+
+        ///
+        /// \brief Checks whether the host has configured the USB device.
+        /// Can be used to detect reconnection to the host.
+        ///
+        bool isConfigured();
     }    // namespace USB
 
     namespace UART
@@ -117,6 +152,27 @@ namespace Board
         ///
         bool write(uint8_t channel, uint8_t data);
 
+        ///
+        /// \brief Used to write data to UART TX buffer without waiting for space in it.
+        /// @param [in] channel     UART channel on MCU.
+        /// @param [in] data        Byte of data to write.
+        /// \returns True if the byte has been queued, false if the buffer is full
+        /// (writing would block) or if the channel is invalid.
+        ///
+        bool tryWrite(uint8_t channel, uint8_t data);
+
+        ///
+        /// \brief Used to write data to high-priority UART TX buffer without waiting for space in it.
+        /// Bytes written this way are sent before any data waiting in regular TX buffer, so they
+        /// can end up between the bytes written with write or tryWrite. Intended for MIDI
+        /// system real-time messages which are allowed to appear anywhere in the stream.
+        /// @param [in] channel     UART channel on MCU.
+        /// @param [in] data        Byte of data to write.
+        /// \returns True if the byte has been queued, false if the buffer is full
+        /// or if the channel is invalid.
+        ///
+        bool writePriority(uint8_t channel, uint8_t data);
+
         ///
         /// \brief Used to enable or disable UART loopback functionality.
         /// Used to pass incoming UART data to TX channel immediately.
@@ -131,6 +187,18 @@ namespace Board
         /// \returns True if there is no more data to transmit, false otherwise.
         ///
         bool isTxEmpty(uint8_t channel);
+
+        ///
+        /// \brief Returns number of bytes which can be written to specified UART channel without blocking.
+        /// @param [in] channel UART channel on MCU.
+        ///
+        size_t txSpace(uint8_t channel);
+
+        ///
+        /// \brief Returns number of received bytes on specified UART channel which haven't been read yet.
+        /// @param [in] channel UART channel on MCU.
+        ///
+        size_t rxCount(uint8_t channel);
     }    // namespace UART
 
     namespace io
@@ -157,6 +225,14 @@ namespace Board
         ///
         bool isInputDataAvailable();
 
+#ifdef PROFILING
+        ///
+        /// \brief Returns value of cycle counter at the moment in which the digital input data
+        /// last retrieved with isInputDataAvailable has been sampled.
+        ///
+        uint32_t inputDataTimestamp();
+#endif
+
         ///
         /// \brief Returns last read button state for requested button index.
         /// @param [in] buttonIndex Index of button which should be read.
@@ -164,6 +240,13 @@ namespace Board
         ///
         bool getButtonState(uint8_t buttonIndex);
 
+        ///
+        /// \brief Returns last read states for eight consecutive buttons.
+        /// @param [in] arrayIndex  Index of button group (first button in group is arrayIndex * 8).
+        /// \returns Button states, first button in group is stored in bit 0.
+        ///
+        uint8_t getButtonStates(uint8_t arrayIndex);
+
         ///
         /// \brief Calculates encoder pair number based on provided button ID.
         /// @param [in] buttonID   Button index from which encoder pair is being calculated.
@@ -214,6 +297,14 @@ namespace Board
         ///
         bool isAnalogDataAvailable();
 
+#ifdef PROFILING
+        ///
+        /// \brief Returns value of cycle counter at the moment in which reading of analog data
+        /// last retrieved with isAnalogDataAvailable has been completed.
+        ///
+        uint32_t analogDataTimestamp();
+#endif
+
         ///
         /// brief Checks for current analog value for specified analog index.
         /// @param[in] analogID     Analog index for which ADC value is being checked.
@@ -263,8 +354,131 @@ namespace Board
         /// \returns            True on success, false otherwise.
         ///
         bool write(uint32_t address, int32_t value, LESSDB::sectionParameterType_t type);
+
+        ///
+        /// \brief Writes all the values which are held only in RAM to non-volatile memory.
+        /// Boards which don't delay the writes have nothing to do here.
+        /// \returns True on success, false otherwise.
+        ///
+        bool flush();
+
+        ///
+        /// \brief Checks whether there are values waiting to be written with flush, or
+        /// other work which should be done only when memory is idle (eg. page erase).
+        ///
+        bool isFlushPending();
+
+        ///
+        /// \brief Performs pending memory maintenance in small steps.
+        /// Should be called continuously.
+        ///
+        void update();
+
+        ///
+        /// \brief Returns how much of the memory currently used for writing is filled, in percent.
+        /// Boards which write directly to EEPROM always return 0.
+        ///
+        uint8_t usage();
+
+        ///
+        /// \brief Returns duration in milliseconds of the last transfer of values to the new
+        /// memory page, or 0 if no transfer has been done since boot.
+        ///
+        uint32_t lastTransferTime();
     }    // namespace eeprom
 
+#ifdef PROFILING
+    namespace profiling
+    {
+        ///
+        /// \brief List of interrupt routines whose execution time is measured.
+        ///
+        enum class isr_t : uint8_t
+        {
+            mainTimer,
+            adc,
+            AMOUNT
+        };
+
+        ///
+        /// \brief Structure holding execution time statistics, expressed in CPU cycles.
+        ///
+        typedef struct
+        {
+            uint32_t min;
+            uint32_t max;
+            uint64_t total;    ///< Sum of all measurements, used to calculate average.
+            uint32_t count;    ///< Total number of measurements.
+        } stats_t;
+
+        ///
+        /// \brief Returns free-running CPU cycle counter.
+        /// Counter wraps around so only the difference between two readings is meaningful.
+        ///
+        uint32_t cycles();
+
+        ///
+        /// \brief Returns number of cycle counter increments per microsecond.
+        ///
+        uint32_t cyclesPerUs();
+
+        ///
+        /// \brief Retrieves execution time statistics for specified interrupt routine.
+        /// @param [in] isr     Interrupt routine for which to retrieve statistics.
+        /// @param [in] stats   Reference to structure in which statistics are stored.
+        ///
+        void isrStats(isr_t isr, stats_t& stats);
+
+        ///
+        /// \brief Clears all interrupt routine statistics.
+        ///
+        void resetISRstats();
+
+        ///
+        /// \brief List of outgoing data paths whose transmission is tracked.
+        /// USB is tracked in USB MIDI packets and UART in bytes. Bytes sent
+        /// with UART::writePriority aren't tracked.
+        ///
+        enum class txPath_t : uint8_t
+        {
+            usb,
+            uart
+        };
+
+        ///
+        /// \brief Handler called once the data has left the device: USB transfer has been completed
+        /// or handed over to USB controller, or UART byte has been moved to the data register.
+        /// Can be called from interrupt, always with interrupts disabled.
+        /// @param [in] path    Path on which the data has been sent.
+        /// @param [in] channel UART channel on MCU, 0 for USB.
+        /// @param [in] sent    Total number of units sent on the path so far. Wraps around.
+        ///
+        using txHandler_t = void (*)(txPath_t path, uint8_t channel, uint32_t sent);
+
+        ///
+        /// \brief Returns total number of units accepted for sending on specified path so far.
+        /// Compared against the number of sent units in txHandler_t to find out when
+        /// the data written up to this point has left the device. Wraps around.
+        /// @param [in] path    Path for which to retrieve the count.
+        /// @param [in] channel UART channel on MCU, ignored for USB.
+        ///
+        uint32_t txQueued(txPath_t path, uint8_t channel);
+
+        ///
+        /// \brief Returns total number of units sent on specified path so far. Wraps around.
+        /// @param [in] path    Path for which to retrieve the count.
+        /// @param [in] channel UART channel on MCU, ignored for USB.
+        ///
+        uint32_t txSent(txPath_t path, uint8_t channel);
+
+        ///
+        /// \brief Sets the function called every time data leaves the device.
+        /// @param [in] handler Function to call, nullptr to disable.
+        ///
+        void setTxHandler(txHandler_t handler);
+    }    // namespace profiling
+#endif
+
     namespace bootloader
     {
         size_t pageSize(size_t index);
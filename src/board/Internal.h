@@ -19,6 +19,7 @@ limitations under the License.
 #pragma once
 
 #include <inttypes.h>
+#include "board/Board.h"
 #include "midi/src/MIDI.h"
 #include "core/src/general/IO.h"
 
@@ -92,12 +93,69 @@ namespace Board
             ///
             void timers();
 
+#ifdef ADC_DMA
+            ///
+            /// \brief Starts continuous, timer triggered scanning of all analog inputs using DMA.
+            /// ADC needs to be initialized in scan mode before calling this function.
+            /// @param [in] adcHandle   Initialized ADC handle.
+            ///
+            void adcScan(ADC_HandleTypeDef& adcHandle);
+#endif
+
+#ifdef SR_SPI
+            ///
+            /// \brief Initializes SPI peripheral and DMA used to transfer shift register data.
+            ///
+            void shiftRegisters();
+#endif
+
             ///
             /// \brief Used to setup bootloader if needed.
             ///
             void bootloader();
+
+#ifdef PROFILING
+            ///
+            /// \brief Starts free-running cycle counter used for profiling.
+            ///
+            void profiling();
+#endif
         }    // namespace setup
 
+#ifdef PROFILING
+        namespace profiling
+        {
+            ///
+            /// \brief Updates execution time statistics of specified interrupt routine.
+            /// @param [in] isr     Interrupt routine which has been measured.
+            /// @param [in] start   Value of cycle counter read on interrupt routine entry.
+            ///
+            void record(Board::profiling::isr_t isr, uint32_t start);
+
+            ///
+            /// \brief Updates number of units accepted for sending on specified path.
+            ///
+            void txQueued(Board::profiling::txPath_t path, uint8_t channel, size_t count);
+
+            ///
+            /// \brief Updates number of units sent on specified path and notifies the handler set with
+            /// Board::profiling::setTxHandler. Discarded data must be reported here as well so
+            /// that the number of sent units catches up with the number of queued ones.
+            ///
+            void txSent(Board::profiling::txPath_t path, uint8_t channel, size_t count);
+        }    // namespace profiling
+#endif
+
+        namespace USB
+        {
+            ///
+            /// \brief Sends data written to USB IN endpoint if it's still waiting to be sent.
+            /// Called from main timer interrupt to limit the latency of outgoing USB MIDI data
+            /// on targets which don't flush after every packet.
+            ///
+            void checkTxTimeout();
+        }    // namespace USB
+
         namespace UART
         {
             namespace ll
@@ -244,6 +302,38 @@ namespace Board
             ///
             TIM_TypeDef* mainTimerInstance();
 
+            ///
+            /// \brief Holds DMA streams (and their request channels) used for transmitting and receiving on a peripheral.
+            ///
+            typedef struct
+            {
+                DMA_Stream_TypeDef* txStream;
+                uint32_t            txChannel;
+                IRQn_Type           txIrqn;
+                DMA_Stream_TypeDef* rxStream;
+                uint32_t            rxChannel;
+                IRQn_Type           rxIrqn;
+            } DMAstreams_t;
+
+#ifdef SR_SPI
+            ///
+            /// \brief Used to retrieve SPI interface and pins on which shift register chains are connected.
+            ///
+            STMPeripheral* srSPIDescriptor();
+
+            ///
+            /// \brief Used to retrieve DMA streams used for shift register SPI transfers.
+            ///
+            DMAstreams_t& srSPIDMA();
+#endif
+
+#ifdef UART_DMA
+            ///
+            /// \brief Used to retrieve DMA streams used for transfers on a given UART channel.
+            ///
+            DMAstreams_t& uartDMA(uint8_t channel);
+#endif
+
             ///
             /// \brief Used to retrieve descriptors for flash pages used for EEPROM emulation.
             /// @ {
@@ -267,6 +357,35 @@ namespace Board
             ///
             void checkDigitalOutputs();
 
+#ifdef SR_SPI
+            namespace sr
+            {
+                ///
+                /// \brief Starts background SPI transfer of all input and output shift registers.
+                /// Inputs are latched before the transfer and outputs once the transfer is complete.
+                /// \returns False if previous transfer is still in progress, true otherwise.
+                ///
+                bool startTransfer();
+
+                ///
+                /// \brief Returns data received from input shift registers during last complete transfer.
+                ///
+                const uint8_t* inputs();
+
+                ///
+                /// \brief Returns buffer which should be filled with new output shift register data.
+                /// First byte in buffer is shifted out first (ends up in the last register in chain).
+                /// Once filled, commitOutputs should be called so that the data is sent on next transfer.
+                ///
+                uint8_t* outputs();
+
+                ///
+                /// \brief Marks output buffer as ready for transfer.
+                ///
+                void commitOutputs();
+            }    // namespace sr
+#endif
+
 #ifdef LED_INDICATORS
             ///
             /// \brief Used to indicate that the MIDI event has occured using built-in LEDs on board.
@@ -306,10 +425,43 @@ namespace Board
             ///
             void adc(uint16_t adcValue);
 
+#ifdef ADC_DMA
+            ///
+            /// \brief Called once all analog inputs have been read.
+            /// @param [in] samples     Array holding readings for all analog inputs.
+            ///                         When multiplexers are used, readings for all multiplexers
+            ///                         are stored for each multiplexer input in a row.
+            ///
+            void adcFrame(volatile uint16_t* samples);
+#endif
+
             ///
             /// \brief Global ISR handler for main timer.
             ///
             void mainTimer();
+
+#ifdef SR_SPI
+            ///
+            /// \brief Called in DMA ISRs of shift register SPI transfers.
+            /// @{
+
+            void srDMAtx();
+            void srDMArx();
+
+            /// @}
+#endif
+
+#ifdef UART_DMA
+            ///
+            /// \brief Called in DMA ISRs of UART transfers.
+            /// @param [in] channel UART channel on MCU.
+            /// @{
+
+            void uartDMAtx(uint8_t channel);
+            void uartDMArx(uint8_t channel);
+
+            /// @}
+#endif
         }    // namespace isrHandling
 
         namespace bootloader
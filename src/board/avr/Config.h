@@ -40,4 +40,23 @@ limitations under the License.
 ///
 /// \brief Total number of states between fully off and fully on for LEDs.
 ///
-#define NUMBER_OF_LED_TRANSITIONS 64
\ No newline at end of file
+#define NUMBER_OF_LED_TRANSITIONS 64
+
+///
+/// \brief Sizes in bytes of buffers used for each UART channel.
+/// Can be overriden by the board.
+/// @{
+
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 64
+#endif
+
+#ifndef UART_TX_PRIORITY_BUFFER_SIZE
+#define UART_TX_PRIORITY_BUFFER_SIZE 4
+#endif
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 64
+#endif
+
+/// @}
\ No newline at end of file
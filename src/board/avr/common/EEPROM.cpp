@@ -82,6 +82,31 @@ namespace Board
             return true;
         }
 
+        bool flush()
+        {
+            //values are written to EEPROM immediately
+            return true;
+        }
+
+        bool isFlushPending()
+        {
+            return false;
+        }
+
+        void update()
+        {
+        }
+
+        uint8_t usage()
+        {
+            return 0;
+        }
+
+        uint32_t lastTransferTime()
+        {
+            return 0;
+        }
+
         void clear(uint32_t start, uint32_t end)
         {
             for (uint32_t i = start; i < end; i++)
@@ -27,7 +27,15 @@ limitations under the License.
 ///
 ISR(ADC_vect)
 {
+#ifdef PROFILING
+    uint32_t start = Board::profiling::cycles();
+#endif
+
     Board::detail::isrHandling::adc(ADC);
+
+#ifdef PROFILING
+    Board::detail::profiling::record(Board::profiling::isr_t::adc, start);
+#endif
 }
 #endif
 #endif
@@ -38,8 +46,21 @@ ISR(ADC_vect)
 ///
 ISR(TIMER0_COMPA_vect)
 {
+#ifdef FW_APP
+#ifdef PROFILING
+    uint32_t start = Board::profiling::cycles();
+#endif
+#endif
+
     static bool _1ms = true;
 
+#ifdef FW_APP
+#ifdef USB_MIDI_SUPPORTED
+    //flush any outgoing usb data which is waiting in endpoint bank - limits the latency to timer period
+    Board::detail::USB::checkTxTimeout();
+#endif
+#endif
+
     _1ms = !_1ms;
 
     if (_1ms)
@@ -62,5 +83,9 @@ ISR(TIMER0_COMPA_vect)
 #ifndef USB_LINK_MCU
     Board::detail::io::checkDigitalInputs();
 #endif
+
+#ifdef PROFILING
+    Board::detail::profiling::record(Board::profiling::isr_t::mainTimer, start);
+#endif
 #endif
 }
@@ -66,6 +66,12 @@ namespace Board
 #endif
 
         detail::setup::timers();
+
+#ifdef PROFILING
+        //board timer setup clears timer 1 configuration (and interrupt mask on some boards)
+        //so profiling timer must be configured only once that is done
+        detail::setup::profiling();
+#endif
 #else
         detail::setup::bootloader();
 
@@ -0,0 +1,85 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef PROFILING
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "board/Board.h"
+#include "board/Internal.h"
+
+//AVR has no cycle counter: 16-bit timer 1 runs freely with prescaler 8 and
+//is extended to 32 bits in software. Resolution is therefore 8 CPU cycles.
+//Timer 1 isn't used by any board, but board timer setup resets it, so this
+//setup is called from Board::init right after detail::setup::timers.
+
+namespace
+{
+    volatile uint16_t overflowCount;
+}    // namespace
+
+ISR(TIMER1_OVF_vect)
+{
+    overflowCount++;
+}
+
+namespace Board
+{
+    namespace profiling
+    {
+        uint32_t cycles()
+        {
+            //also called from interrupts - restore previous interrupt state instead of enabling them
+            uint8_t sreg = SREG;
+            cli();
+
+            uint16_t high = overflowCount;
+            uint16_t low  = TCNT1;
+
+            //overflow which happened after interrupts were disabled hasn't been counted yet
+            if ((TIFR1 & (1 << TOV1)) && (low < 0x8000))
+                high++;
+
+            SREG = sreg;
+
+            return ((static_cast<uint32_t>(high) << 16) | low) << 3;
+        }
+
+        uint32_t cyclesPerUs()
+        {
+            return F_CPU / 1000000UL;
+        }
+    }    // namespace profiling
+
+    namespace detail
+    {
+        namespace setup
+        {
+            void profiling()
+            {
+                TCCR1A = 0;
+                TCCR1B = (1 << CS11);    //normal mode, prescaler 8
+                TCNT1  = 0;
+                TIFR1  = (1 << TOV1);    //clear any stale overflow flag
+                TIMSK1 = (1 << TOIE1);
+            }
+        }    // namespace setup
+    }        // namespace detail
+}    // namespace Board
+
+#endif
@@ -20,6 +20,7 @@ limitations under the License.
 #include "midi/src/MIDI.h"
 #include "board/Board.h"
 #include "board/Internal.h"
+#include "core/src/general/Atomic.h"
 
 namespace
 {
@@ -27,6 +28,36 @@ namespace
     /// \brief MIDI Class Device Mode Configuration and State Structure.
     ///
     USB_ClassInfo_MIDI_Device_t MIDI_Interface;
+
+    ///
+    /// \brief Set to true when IN endpoint bank holds data which hasn't been sent yet.
+    ///
+    volatile bool txPending;
+
+    ///
+    /// \brief Set to true while endpoints are being accessed outside of interrupt.
+    /// Used to prevent flushing from main timer interrupt in the middle of endpoint access.
+    ///
+    volatile bool txBusy;
+
+    Board::USB::txStats_t usbTxStats;
+
+#ifdef PROFILING
+    ///
+    /// \brief Number of packets written to IN endpoint bank which hasn't been handed over to USB controller yet.
+    ///
+    uint8_t txBankPackets;
+
+    ///
+    /// \brief Marks all packets in IN endpoint bank as sent.
+    /// Must be called right after the bank has been handed over to USB controller.
+    ///
+    void bankSent()
+    {
+        Board::detail::profiling::txSent(Board::profiling::txPath_t::usb, 0, txBankPackets);
+        txBankPackets = 0;
+    }
+#endif
 }    // namespace
 
 ///
@@ -106,6 +137,34 @@ namespace Board
                 USB_Init();
             }
         }    // namespace setup
+
+        namespace USB
+        {
+            void checkTxTimeout()
+            {
+                if (!txPending || txBusy)
+                    return;
+
+                if (USB_DeviceState != DEVICE_STATE_Configured)
+                    return;
+
+                uint8_t previousEndpoint = Endpoint_GetCurrentEndpoint();
+
+                Endpoint_SelectEndpoint(MIDI_Interface.Config.DataINEndpoint.Address);
+
+                if (Endpoint_IsINReady() && Endpoint_BytesInEndpoint())
+                {
+                    Endpoint_ClearIN();
+                    txPending = false;
+
+#ifdef PROFILING
+                    bankSent();
+#endif
+                }
+
+                Endpoint_SelectEndpoint(previousEndpoint);
+            }
+        }    // namespace USB
     }        // namespace detail
 
     namespace USB
@@ -148,17 +207,46 @@ namespace Board
             if (USB_DeviceState != DEVICE_STATE_Configured)
                 return false;
 
+            txBusy = true;
+
             Endpoint_SelectEndpoint(MIDI_Interface.Config.DataINEndpoint.Address);
 
             uint8_t ErrorCode;
 
             if ((ErrorCode = Endpoint_Write_Stream_LE(&USBMIDIpacket, sizeof(MIDI::USBMIDIpacket_t), NULL)) != ENDPOINT_RWSTREAM_NoError)
+            {
+                //count each failure only once: timeout means the host hasn't collected the data in time
+                if (ErrorCode == ENDPOINT_RWSTREAM_Timeout)
+                    usbTxStats.stalls++;
+                else
+                    usbTxStats.overflows++;
+
+                txBusy = false;
                 return false;
+            }
+
+#ifdef PROFILING
+            Board::detail::profiling::txQueued(Board::profiling::txPath_t::usb, 0, 1);
+            txBankPackets++;
+#endif
 
+            //don't flush after each packet - send the bank only once it's full
+            //remaining data is sent either in flush or from main timer interrupt
             if (!(Endpoint_IsReadWriteAllowed()))
+            {
                 Endpoint_ClearIN();
+                txPending = false;
 
-            MIDI_Device_Flush(&MIDI_Interface);
+#ifdef PROFILING
+                bankSent();
+#endif
+            }
+            else
+            {
+                txPending = true;
+            }
+
+            txBusy = false;
 
 #ifdef FW_APP
 #ifdef LED_INDICATORS
@@ -168,5 +256,56 @@ namespace Board
 
             return true;
         }
+
+        void flush()
+        {
+            if (!txPending)
+                return;
+
+            txBusy = true;
+
+            //bank is handed over to USB controller even if waiting for it afterwards times out
+            if (MIDI_Device_Flush(&MIDI_Interface) == ENDPOINT_READYWAIT_Timeout)
+                usbTxStats.stalls++;
+
+#ifdef PROFILING
+            bankSent();
+#endif
+
+            txPending = false;
+            txBusy    = false;
+        }
+
+        void getTxStats(txStats_t& stats)
+        {
+            ATOMIC_SECTION
+            {
+                stats = usbTxStats;
+            }
+        }
+
+        size_t rxPending()
+        {
+            if (USB_DeviceState != DEVICE_STATE_Configured)
+                return 0;
+
+            size_t  pending          = 0;
+            uint8_t previousEndpoint = Endpoint_GetCurrentEndpoint();
+
+            //only the bank currently selected by the endpoint is visible here
+            Endpoint_SelectEndpoint(MIDI_STREAM_OUT_EPADDR);
+
+            if (Endpoint_IsOUTReceived())
+                pending = Endpoint_BytesInEndpoint() / sizeof(MIDI::USBMIDIpacket_t);
+
+            Endpoint_SelectEndpoint(previousEndpoint);
+
+            return pending;
+        }
+
+        bool isConfigured()
+        {
+            return USB_DeviceState == DEVICE_STATE_Configured;
+        }
     }    // namespace USB
 }    // namespace Board
\ No newline at end of file
@@ -49,6 +49,12 @@ limitations under the License.
 ///
 #define UART_MIDI_CHANNEL               1
 
+///
+/// \brief Size of outgoing UART buffers in bytes.
+/// Larger than default since there is enough RAM for it.
+///
+#define UART_TX_BUFFER_SIZE             128
+
 ///
 /// \brief Defines UART channel used for communication with USB link.
 ///
@@ -49,6 +49,11 @@ limitations under the License.
 ///
 #define UART_USB_LINK_CHANNEL   0
 
+///
+/// \brief Use smaller frames for USB link to save RAM.
+///
+#define OD_FORMAT_FRAME_EVENTS  4
+
 ///
 /// \brief Use integrated LED indicators.
 ///
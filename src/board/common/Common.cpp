@@ -76,6 +76,9 @@ namespace Board
             break;
         }
 
+        //don't lose configuration which hasn't been written yet
+        eeprom::flush();
+
         core::reset::mcuReset();
     }
 
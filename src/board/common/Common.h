@@ -25,4 +25,6 @@ limitations under the License.
 #include "board/avr/Config.h"
 #elif defined(__STM32__)
 #include "board/stm32/Config.h"
+#elif defined(__NATIVE__)
+#include "board/native/Config.h"
 #endif
\ No newline at end of file
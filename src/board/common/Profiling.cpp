@@ -0,0 +1,178 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef PROFILING
+
+#include "board/Board.h"
+#include "board/Internal.h"
+#include "core/src/general/Interrupt.h"
+
+#ifdef UART_INTERFACES
+#define TX_PATHS (1 + UART_INTERFACES)
+#else
+#define TX_PATHS 1
+#endif
+
+//transmit tracking is used from drivers shared with bootloader, interrupt statistics only in application
+
+namespace
+{
+#ifdef FW_APP
+    Board::profiling::stats_t isrStatistics[static_cast<uint8_t>(Board::profiling::isr_t::AMOUNT)];
+#endif
+
+    ///
+    /// \brief Number of units accepted for sending and number of units sent for every transmit path.
+    /// USB is stored first, followed by all UART channels.
+    /// @{
+
+    volatile uint32_t txQueuedCount[TX_PATHS];
+    volatile uint32_t txSentCount[TX_PATHS];
+
+    /// @}
+
+    Board::profiling::txHandler_t txHandler;
+
+    size_t txIndex(Board::profiling::txPath_t path, uint8_t channel)
+    {
+        return path == Board::profiling::txPath_t::usb ? 0 : 1 + channel;
+    }
+}    // namespace
+
+namespace Board
+{
+    namespace profiling
+    {
+#ifdef FW_APP
+        void isrStats(isr_t isr, stats_t& stats)
+        {
+            ATOMIC_SECTION
+            {
+                stats = isrStatistics[static_cast<uint8_t>(isr)];
+            }
+        }
+
+        void resetISRstats()
+        {
+            ATOMIC_SECTION
+            {
+                for (size_t i = 0; i < static_cast<uint8_t>(isr_t::AMOUNT); i++)
+                    isrStatistics[i] = {};
+            }
+        }
+#endif
+
+        uint32_t txQueued(txPath_t path, uint8_t channel)
+        {
+            size_t index = txIndex(path, channel);
+
+            if (index >= TX_PATHS)
+                return 0;
+
+            uint32_t count;
+
+            ATOMIC_SECTION
+            {
+                count = txQueuedCount[index];
+            }
+
+            return count;
+        }
+
+        uint32_t txSent(txPath_t path, uint8_t channel)
+        {
+            size_t index = txIndex(path, channel);
+
+            if (index >= TX_PATHS)
+                return 0;
+
+            uint32_t count;
+
+            ATOMIC_SECTION
+            {
+                count = txSentCount[index];
+            }
+
+            return count;
+        }
+
+        void setTxHandler(txHandler_t handler)
+        {
+            ATOMIC_SECTION
+            {
+                txHandler = handler;
+            }
+        }
+    }    // namespace profiling
+
+    namespace detail
+    {
+        namespace profiling
+        {
+#ifdef FW_APP
+            void record(Board::profiling::isr_t isr, uint32_t start)
+            {
+                uint32_t elapsed = Board::profiling::cycles() - start;
+                auto&    stats   = isrStatistics[static_cast<uint8_t>(isr)];
+
+                if (!stats.count || (elapsed < stats.min))
+                    stats.min = elapsed;
+
+                if (elapsed > stats.max)
+                    stats.max = elapsed;
+
+                stats.total += elapsed;
+                stats.count++;
+            }
+#endif
+
+            void txQueued(Board::profiling::txPath_t path, uint8_t channel, size_t count)
+            {
+                size_t index = txIndex(path, channel);
+
+                if (index >= TX_PATHS)
+                    return;
+
+                //UART loopback queues data from interrupt as well
+                ATOMIC_SECTION
+                {
+                    txQueuedCount[index] += count;
+                }
+            }
+
+            void txSent(Board::profiling::txPath_t path, uint8_t channel, size_t count)
+            {
+                size_t index = txIndex(path, channel);
+
+                if (index >= TX_PATHS)
+                    return;
+
+                //called from main loop as well when the data is written directly or discarded
+                ATOMIC_SECTION
+                {
+                    txSentCount[index] += count;
+
+                    if (txHandler != nullptr)
+                        txHandler(path, channel, txSentCount[index]);
+                }
+            }
+        }    // namespace profiling
+    }        // namespace detail
+}    // namespace Board
+
+#endif
@@ -25,16 +25,23 @@ limitations under the License.
 
 namespace
 {
-    uint8_t           ignoreCounter;
-    uint8_t           analogIndex;
+#ifndef ADC_DMA
+    uint8_t ignoreCounter;
+    uint8_t analogIndex;
+#endif
     volatile uint16_t analogBuffer[ANALOG_IN_BUFFER_SIZE][MAX_NUMBER_OF_ANALOG];
     uint16_t          analogBufferReadOnly[MAX_NUMBER_OF_ANALOG];
 
+#ifdef PROFILING
+    volatile uint32_t analogTimestamp[ANALOG_IN_BUFFER_SIZE];
+    uint32_t          analogTimestampReadOnly;
+#endif
+
     volatile uint8_t aIn_head;
     volatile uint8_t aIn_tail;
     volatile uint8_t aIn_count;
 
-#ifdef NUMBER_OF_MUX
+#if defined(NUMBER_OF_MUX) && !defined(ADC_DMA)
     uint8_t activeMux;
     uint8_t activeMuxInput;
 
@@ -72,6 +79,10 @@ namespace Board
                     for (int i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
                         analogBufferReadOnly[i] = analogBuffer[aIn_tail][i];
 
+#ifdef PROFILING
+                    analogTimestampReadOnly = analogTimestamp[aIn_tail];
+#endif
+
                     aIn_count--;
                 }
 
@@ -80,12 +91,47 @@ namespace Board
 
             return false;
         }
+
+#ifdef PROFILING
+        uint32_t analogDataTimestamp()
+        {
+            return analogTimestampReadOnly;
+        }
+#endif
     }    // namespace io
 
     namespace detail
     {
         namespace isrHandling
         {
+#ifdef ADC_DMA
+            void adcFrame(volatile uint16_t* samples)
+            {
+                //drop the entire frame if there is no room in ring buffer
+                if (aIn_count >= ANALOG_IN_BUFFER_SIZE)
+                    return;
+
+                if (++aIn_head == ANALOG_IN_BUFFER_SIZE)
+                    aIn_head = 0;
+
+#ifdef NUMBER_OF_MUX
+                for (int i = 0; i < NUMBER_OF_MUX_INPUTS; i++)
+                {
+                    for (int j = 0; j < NUMBER_OF_MUX; j++)
+                        analogBuffer[aIn_head][j * NUMBER_OF_MUX_INPUTS + i] = samples[i * NUMBER_OF_MUX + j];
+                }
+#else
+                for (int i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
+                    analogBuffer[aIn_head][i] = samples[i];
+#endif
+
+#ifdef PROFILING
+                analogTimestamp[aIn_head] = Board::profiling::cycles();
+#endif
+
+                aIn_count++;
+            }
+#else
             void adc(uint16_t adcValue)
             {
                 static bool analogSamplingStarted = false;
@@ -130,6 +176,9 @@ namespace Board
 #endif
                                 analogIndex           = 0;
                                 analogSamplingStarted = false;
+#ifdef PROFILING
+                                analogTimestamp[aIn_head] = Board::profiling::cycles();
+#endif
                                 aIn_count++;
 #ifdef NUMBER_OF_MUX
                             }
@@ -152,6 +201,7 @@ namespace Board
 
                 core::adc::startConversion();
             }
+#endif
         }    // namespace isrHandling
     }        // namespace detail
 }    // namespace Board
\ No newline at end of file
@@ -34,11 +34,30 @@ namespace
     volatile uint8_t activeInColumn;
 #endif
 
+#ifdef PROFILING
+    volatile uint32_t digitalInTimestamp[DIGITAL_IN_BUFFER_SIZE];
+    uint32_t          digitalInTimestampReadOnly;
+#endif
+
     volatile uint8_t dIn_head;
     volatile uint8_t dIn_tail;
     volatile uint8_t dIn_count;
 
-#if defined(SR_DIN_CLK_PORT) && defined(SR_DIN_LATCH_PORT) && defined(SR_DIN_DATA_PORT) && !defined(NUMBER_OF_BUTTON_COLUMNS) && !defined(NUMBER_OF_BUTTON_ROWS)
+#if defined(SR_SPI) && defined(NUMBER_OF_IN_SR)
+    ///
+    /// \brief Stores input shift register data received during last SPI transfer
+    /// and starts the next transfer in background.
+    ///
+    inline void storeDigitalIn()
+    {
+        const uint8_t* data = Board::detail::io::sr::inputs();
+
+        for (int j = 0; j < NUMBER_OF_IN_SR; j++)
+            digitalInBuffer[dIn_head][j] = ~data[j];
+
+        Board::detail::io::sr::startTransfer();
+    }
+#elif defined(SR_DIN_CLK_PORT) && defined(SR_DIN_LATCH_PORT) && defined(SR_DIN_DATA_PORT) && !defined(NUMBER_OF_BUTTON_COLUMNS) && !defined(NUMBER_OF_BUTTON_ROWS)
     inline void storeDigitalIn()
     {
         CORE_IO_SET_LOW(SR_DIN_CLK_PORT, SR_DIN_CLK_PIN);
@@ -137,6 +156,34 @@ namespace Board
 #endif
         }
 
+        uint8_t getButtonStates(uint8_t arrayIndex)
+        {
+#ifdef NUMBER_OF_BUTTON_COLUMNS
+            //matrix readings are stored per column: locate the first button of the byte once
+            //and walk through the columns from there, moving to next row on wrap
+            uint8_t states   = 0;
+            uint8_t buttonID = arrayIndex * 8;
+            uint8_t row      = buttonID / NUMBER_OF_BUTTON_COLUMNS;
+            uint8_t column   = buttonID % NUMBER_OF_BUTTON_COLUMNS;
+            uint8_t count    = (MAX_NUMBER_OF_BUTTONS - buttonID) < 8 ? (MAX_NUMBER_OF_BUTTONS - buttonID) : 8;
+
+            for (uint8_t i = 0; i < count; i++)
+            {
+                states |= ((digitalInBufferReadOnly[column] >> row) & 0x01) << i;
+
+                if (++column == NUMBER_OF_BUTTON_COLUMNS)
+                {
+                    column = 0;
+                    row++;
+                }
+            }
+
+            return states;
+#else
+            return digitalInBufferReadOnly[arrayIndex];
+#endif
+        }
+
         uint8_t getEncoderPair(uint8_t buttonID)
         {
 #ifdef NUMBER_OF_BUTTON_COLUMNS
@@ -181,6 +228,10 @@ namespace Board
                     for (int i = 0; i < DIGITAL_IN_ARRAY_SIZE; i++)
                         digitalInBufferReadOnly[i] = digitalInBuffer[dIn_tail][i];
 
+#ifdef PROFILING
+                    digitalInTimestampReadOnly = digitalInTimestamp[dIn_tail];
+#endif
+
                     dIn_count--;
                 }
 
@@ -189,6 +240,13 @@ namespace Board
 
             return false;
         }
+
+#ifdef PROFILING
+        uint32_t inputDataTimestamp()
+        {
+            return digitalInTimestampReadOnly;
+        }
+#endif
     }    // namespace io
 
     namespace detail
@@ -202,6 +260,10 @@ namespace Board
                     if (++dIn_head == DIGITAL_IN_BUFFER_SIZE)
                         dIn_head = 0;
 
+#ifdef PROFILING
+                    digitalInTimestamp[dIn_head] = Board::profiling::cycles();
+#endif
+
                     storeDigitalIn();
 
                     dIn_count++;
@@ -339,6 +339,41 @@ namespace Board
                 if (++activeOutColumn == NUMBER_OF_LED_COLUMNS)
                     activeOutColumn = 0;
             }
+#elif defined(SR_SPI) && defined(NUMBER_OF_OUT_SR)
+            ///
+            /// \brief Checks if any LED state has been changed and prepares new output shift register data.
+            /// Data is sent on next SPI transfer.
+            ///
+            void checkDigitalOutputs()
+            {
+                if (updateOutputs)
+                {
+                    uint8_t* data = Board::detail::io::sr::outputs();
+
+                    for (int j = 0; j < NUMBER_OF_OUT_SR; j++)
+                    {
+                        data[j] = 0;
+
+                        for (int i = 0; i < NUMBER_OF_OUT_SR_INPUTS; i++)
+                        {
+                            ledIndex = i + j * NUMBER_OF_OUT_SR_INPUTS;
+                            BIT_WRITE(data[j], 7 - i, ledState[ledIndex]);
+                        }
+
+#ifdef LED_EXT_INVERT
+                        data[j] = ~data[j];
+#endif
+                    }
+
+                    Board::detail::io::sr::commitOutputs();
+                    updateOutputs = false;
+                }
+
+#ifndef NUMBER_OF_IN_SR
+                //transfers are otherwise started when reading inputs
+                Board::detail::io::sr::startTransfer();
+#endif
+            }
 #elif defined(NUMBER_OF_OUT_SR)
             ///
             /// \brief Checks if any LED state has been changed and writes changed state to output shift registers.
@@ -25,9 +25,7 @@ limitations under the License.
 #include "core/src/general/Helpers.h"
 
 //generic UART driver, arch-independent
-
-#define TX_BUFFER_SIZE 64
-#define RX_BUFFER_SIZE 64
+//buffer sizes are defined in arch configuration and can be overriden by the board
 
 namespace
 {
@@ -45,12 +43,18 @@ namespace
     ///
     /// \brief Buffer in which outgoing UART data is stored.
     ///
-    core::RingBuffer<uint8_t, TX_BUFFER_SIZE> txBuffer[UART_INTERFACES];
+    core::RingBuffer<uint8_t, UART_TX_BUFFER_SIZE> txBuffer[UART_INTERFACES];
+
+    ///
+    /// \brief Buffer in which outgoing high-priority UART data is stored.
+    /// Data from this buffer is always sent before the data in regular TX buffer.
+    ///
+    core::RingBuffer<uint8_t, UART_TX_PRIORITY_BUFFER_SIZE> txPriorityBuffer[UART_INTERFACES];
 
     ///
     /// \brief Buffer in which incoming UART data is stored.
     ///
-    core::RingBuffer<uint8_t, RX_BUFFER_SIZE> rxBuffer[UART_INTERFACES];
+    core::RingBuffer<uint8_t, UART_RX_BUFFER_SIZE> rxBuffer[UART_INTERFACES];
 
     ///
     /// \brief Starts the process of transmitting the data from UART TX buffer to UART interface.
@@ -65,6 +69,29 @@ namespace
 
         Board::detail::UART::ll::enableDataEmptyInt(channel);
     }
+
+    ///
+    /// \brief Writes the byte directly to UART data register if nothing else is being sent.
+    /// @param [in] channel     UART channel on MCU.
+    /// @param [in] data        Byte of data to write.
+    /// \returns True if the byte has been written, false otherwise.
+    ///
+    bool uartDirectWrite(uint8_t channel, uint8_t data)
+    {
+        //if:
+        // *outgoing buffers are empty
+        // * UART data register is empty
+        // txDone is marked as true
+        //write the byte to the data register directly
+        if (txDone[channel] && txBuffer[channel].isEmpty() && txPriorityBuffer[channel].isEmpty())
+        {
+            txDone[channel] = false;
+            Board::detail::UART::ll::directWrite(channel, data);
+            return true;
+        }
+
+        return false;
+    }
 }    // namespace
 
 namespace Board
@@ -88,8 +115,13 @@ namespace Board
 
             if (Board::detail::UART::ll::deInit(channel))
             {
+#ifdef PROFILING
+                Board::detail::profiling::txSent(Board::profiling::txPath_t::uart, channel, txBuffer[channel].count());
+#endif
+
                 rxBuffer[channel].reset();
                 txBuffer[channel].reset();
+                txPriorityBuffer[channel].reset();
 
                 txDone[channel] = true;
 
@@ -125,20 +157,49 @@ namespace Board
             if (channel >= UART_INTERFACES)
                 return false;
 
-            //if:
-            // *outgoing buffer is empty
-            // * UART data register is empty
-            // txDone is marked as true
-            //write the byte to the data register directly
-            if (txDone[channel] && txBuffer[channel].isEmpty())
+            while (!tryWrite(channel, data))
+                ;
+
+            return true;
+        }
+
+        bool tryWrite(uint8_t channel, uint8_t data)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            if (uartDirectWrite(channel, data))
             {
-                txDone[channel] = false;
-                Board::detail::UART::ll::directWrite(channel, data);
+#ifdef PROFILING
+                Board::detail::profiling::txQueued(Board::profiling::txPath_t::uart, channel, 1);
+                Board::detail::profiling::txSent(Board::profiling::txPath_t::uart, channel, 1);
+#endif
                 return true;
             }
 
-            while (!txBuffer[channel].insert(data))
-                ;
+            if (!txBuffer[channel].insert(data))
+                return false;
+
+#ifdef PROFILING
+            //counted before transmission starts so that the byte is never sent before being queued
+            Board::detail::profiling::txQueued(Board::profiling::txPath_t::uart, channel, 1);
+#endif
+
+            uartTransmitStart(channel);
+
+            return true;
+        }
+
+        bool writePriority(uint8_t channel, uint8_t data)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            if (uartDirectWrite(channel, data))
+                return true;
+
+            if (!txPriorityBuffer[channel].insert(data))
+                return false;
 
             uartTransmitStart(channel);
 
@@ -152,6 +213,22 @@ namespace Board
 
             return txDone[channel];
         }
+
+        size_t txSpace(uint8_t channel)
+        {
+            if (channel >= UART_INTERFACES)
+                return 0;
+
+            return UART_TX_BUFFER_SIZE - txBuffer[channel].count();
+        }
+
+        size_t rxCount(uint8_t channel)
+        {
+            if (channel >= UART_INTERFACES)
+                return 0;
+
+            return rxBuffer[channel].count();
+        }
     }    // namespace UART
 
     namespace detail
@@ -175,6 +252,9 @@ namespace Board
                 {
                     if (txBuffer[channel].insert(data))
                     {
+#ifdef PROFILING
+                        Board::detail::profiling::txQueued(Board::profiling::txPath_t::uart, channel, 1);
+#endif
                         Board::detail::UART::ll::enableDataEmptyInt(channel);
 
 #ifdef FW_APP
@@ -189,8 +269,15 @@ namespace Board
 
             bool getNextByteToSend(uint8_t channel, uint8_t& data)
             {
-                if (txBuffer[channel].remove(data))
+                bool priority = txPriorityBuffer[channel].remove(data);
+
+                if (priority || txBuffer[channel].remove(data))
                 {
+#ifdef PROFILING
+                    if (!priority)
+                        Board::detail::profiling::txSent(Board::profiling::txPath_t::uart, channel, 1);
+#endif
+
 #ifdef FW_APP
 #ifdef LED_INDICATORS
                     Board::detail::io::indicateMIDItraffic(MIDI::interface_t::din, Board::detail::midiTrafficDirection_t::outgoing);
@@ -0,0 +1,31 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <inttypes.h>
+
+///
+/// \brief Size of emulated EEPROM in bytes.
+///
+#define EEPROM_SIZE 131072
+
+///
+/// \brief Total number of states between fully off and fully on for LEDs.
+///
+#define NUMBER_OF_LED_TRANSITIONS 64
@@ -0,0 +1,88 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include <inttypes.h>
+#include "board/Board.h"
+
+//for internal usage within native board only
+
+namespace Board
+{
+    namespace detail
+    {
+        namespace native
+        {
+            ///
+            /// \brief Initializes virtual inputs and LEDs.
+            ///
+            void initIO();
+
+#ifdef USB_MIDI_SUPPORTED
+            ///
+            /// \brief Opens files used as USB MIDI endpoints.
+            ///
+            void initUSB();
+#endif
+
+            ///
+            /// \brief Marks new readings of all virtual inputs as available.
+            /// Called every millisecond from timer thread, equivalent of input scanning
+            /// in main timer interrupt on hardware targets.
+            ///
+            void scanInputs();
+
+            ///
+            /// \brief Sets the state of virtual button.
+            ///
+            void setButtonState(uint8_t index, bool state);
+
+            ///
+            /// \brief Sets the value of virtual analog input.
+            ///
+            void setAnalogValue(uint8_t index, uint16_t value);
+
+            ///
+            /// \brief Forwards incoming UART data to outgoing for all channels with enabled loopback.
+            /// Called every millisecond from timer thread.
+            ///
+            void uartLoopback();
+
+            ///
+            /// \brief Saves contents of emulated EEPROM to file if persistence is enabled.
+            ///
+            void saveEEPROM();
+
+            ///
+            /// \brief Terminates the process if termination signal has been received.
+            /// Called from main loop so that files are flushed and EEPROM is saved
+            /// outside of signal handler.
+            ///
+            void checkShutdown();
+
+#ifdef PROFILING
+            ///
+            /// \brief Updates transmit statistics for data written to output file.
+            /// Writes aren't buffered so the data is considered sent right away.
+            ///
+            void txWritten(Board::profiling::txPath_t path, uint8_t channel, size_t count);
+#endif
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
@@ -0,0 +1,214 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <chrono>
+#include <thread>
+#include "board/Board.h"
+#include "board/native/Native.h"
+#include "core/src/general/Timing.h"
+
+//Native board runs the firmware as a regular host process.
+//All the hardware is emulated and configured with the following environment variables:
+//OD_SESSION        Recorded session replayed on virtual inputs. Each line holds single event:
+//                  "<time in ms> <button|analog> <index> <value>". Events need to be sorted by time.
+//OD_LED_OUT        File to which all LED state changes are written.
+//OD_EEPROM         File used to persist emulated EEPROM between runs.
+//OD_USB_IN         File or pipe from which raw USB MIDI packets (4 bytes each) are read.
+//OD_USB_OUT        File or pipe to which raw USB MIDI packets are written.
+//OD_UART<n>_IN     File or pipe from which UART channel n reads.
+//OD_UART<n>_OUT    File or pipe to which UART channel n writes.
+//Reboot request terminates the process: exit status is 0 for application reboot
+//and 1 for bootloader reboot. SIGINT and SIGTERM terminate the process with exit status 0.
+
+namespace core
+{
+    namespace timing
+    {
+        namespace detail
+        {
+            ///
+            /// \brief Implementation of core variable used to keep track of run time in milliseconds.
+            ///
+            volatile uint32_t rTime_ms;
+        }    // namespace detail
+    }        // namespace timing
+}    // namespace core
+
+namespace
+{
+    ///
+    /// \brief Single event from recorded session.
+    ///
+    typedef struct
+    {
+        uint32_t time;
+        bool     analog;
+        uint8_t  index;
+        uint16_t value;
+    } sessionEvent_t;
+
+    FILE*          sessionFile;
+    sessionEvent_t nextEvent;
+    bool           nextEventValid;
+
+    ///
+    /// \brief Set once termination signal is received.
+    /// Only the flag is set in signal handler, the process is shut down from main loop.
+    ///
+    volatile sig_atomic_t shutdownRequested;
+
+    bool readSessionEvent(sessionEvent_t& event)
+    {
+        char line[128];
+
+        while (fgets(line, sizeof(line), sessionFile) != nullptr)
+        {
+            unsigned long time;
+            char          type[16];
+            unsigned int  index;
+            unsigned int  value;
+
+            if (line[0] == '#')
+                continue;
+
+            if (sscanf(line, "%lu %15s %u %u", &time, type, &index, &value) != 4)
+                continue;
+
+            if (!strcmp(type, "button"))
+                event.analog = false;
+            else if (!strcmp(type, "analog"))
+                event.analog = true;
+            else
+                continue;
+
+            event.time  = time;
+            event.index = index;
+            event.value = value;
+
+            return true;
+        }
+
+        return false;
+    }
+
+    ///
+    /// \brief Applies all session events scheduled up to current time and scans the inputs.
+    ///
+    void tick()
+    {
+        while (nextEventValid && (nextEvent.time <= core::timing::currentRunTimeMs()))
+        {
+            if (nextEvent.analog)
+                Board::detail::native::setAnalogValue(nextEvent.index, nextEvent.value);
+            else
+                Board::detail::native::setButtonState(nextEvent.index, nextEvent.value);
+
+            nextEventValid = readSessionEvent(nextEvent);
+        }
+
+        Board::detail::native::scanInputs();
+        Board::detail::native::uartLoopback();
+    }
+
+    ///
+    /// \brief Emulates main timer interrupt.
+    ///
+    void timer()
+    {
+        auto next = std::chrono::steady_clock::now();
+
+        while (true)
+        {
+            next += std::chrono::milliseconds(1);
+            std::this_thread::sleep_until(next);
+
+            core::timing::detail::rTime_ms++;
+            tick();
+        }
+    }
+
+    void shutdown()
+    {
+        fflush(nullptr);
+        Board::detail::native::saveEEPROM();
+    }
+
+    void signalHandler(int signal)
+    {
+        shutdownRequested = 1;
+    }
+}    // namespace
+
+namespace Board
+{
+    void init()
+    {
+        const char* session = getenv("OD_SESSION");
+
+        if (session != nullptr)
+        {
+            sessionFile = fopen(session, "r");
+
+            if (sessionFile == nullptr)
+            {
+                fprintf(stderr, "Unable to open session file %s\n", session);
+                exit(2);
+            }
+
+            nextEventValid = readSessionEvent(nextEvent);
+        }
+
+        detail::native::initIO();
+
+#ifdef USB_MIDI_SUPPORTED
+        detail::native::initUSB();
+#endif
+
+        atexit(shutdown);
+        signal(SIGINT, signalHandler);
+        signal(SIGTERM, signalHandler);
+
+        std::thread(timer).detach();
+    }
+
+    void reboot(rebootType_t type)
+    {
+        exit(type == rebootType_t::rebootApp ? 0 : 1);
+    }
+
+    bool checkNewRevision()
+    {
+        return false;
+    }
+
+    namespace detail
+    {
+        namespace native
+        {
+            void checkShutdown()
+            {
+                if (shutdownRequested)
+                    exit(0);
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
@@ -0,0 +1,184 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "board/Board.h"
+#include "board/native/Native.h"
+
+//EEPROM is emulated in memory. If OD_EEPROM environment variable is set, contents
+//are loaded from the file it points to on init and stored back once the process exits.
+
+namespace
+{
+    uint8_t     memory[EEPROM_SIZE];
+    const char* eepromFile;
+    bool        modified;
+
+    uint32_t readBytes(uint32_t address, uint8_t size)
+    {
+        uint32_t value = 0;
+
+        //little-endian, same as on hardware targets
+        for (uint8_t i = 0; i < size; i++)
+            value |= static_cast<uint32_t>(memory[address + i]) << (8 * i);
+
+        return value;
+    }
+
+    void writeBytes(uint32_t address, uint32_t value, uint8_t size)
+    {
+        for (uint8_t i = 0; i < size; i++)
+        {
+            uint8_t byte = (value >> (8 * i)) & 0xFF;
+
+            if (memory[address + i] != byte)
+            {
+                memory[address + i] = byte;
+                modified            = true;
+            }
+        }
+    }
+}    // namespace
+
+namespace Board
+{
+    namespace eeprom
+    {
+        uint32_t size()
+        {
+            return EEPROM_SIZE;
+        }
+
+        void init()
+        {
+            eepromFile = getenv("OD_EEPROM");
+
+            if (eepromFile == nullptr)
+                return;
+
+            FILE* file = fopen(eepromFile, "rb");
+
+            if (file == nullptr)
+                return;
+
+            if (fread(memory, 1, EEPROM_SIZE, file) != EEPROM_SIZE)
+            {
+                //treat truncated file as uninitialized memory so that database gets formatted
+                memset(memory, 0, EEPROM_SIZE);
+            }
+
+            fclose(file);
+        }
+
+        bool read(uint32_t address, int32_t& value, LESSDB::sectionParameterType_t type)
+        {
+            uint8_t paramSize = paramUsage(type);
+
+            if ((address + paramSize) > EEPROM_SIZE)
+                return false;
+
+            value = readBytes(address, paramSize);
+            return true;
+        }
+
+        bool write(uint32_t address, int32_t value, LESSDB::sectionParameterType_t type)
+        {
+            uint8_t paramSize = paramUsage(type);
+
+            if ((address + paramSize) > EEPROM_SIZE)
+                return false;
+
+            writeBytes(address, value, paramSize);
+            return true;
+        }
+
+        bool flush()
+        {
+            detail::native::saveEEPROM();
+            return true;
+        }
+
+        bool isFlushPending()
+        {
+            return (eepromFile != nullptr) && modified;
+        }
+
+        void update()
+        {
+            //called on every main loop iteration
+            detail::native::checkShutdown();
+        }
+
+        uint8_t usage()
+        {
+            return 0;
+        }
+
+        uint32_t lastTransferTime()
+        {
+            return 0;
+        }
+
+        void clear(uint32_t start, uint32_t end)
+        {
+            for (uint32_t i = start; (i < end) && (i < EEPROM_SIZE); i++)
+                writeBytes(i, 0, 1);
+        }
+
+        size_t paramUsage(LESSDB::sectionParameterType_t type)
+        {
+            switch (type)
+            {
+            case LESSDB::sectionParameterType_t::word:
+                return 2;
+
+            case LESSDB::sectionParameterType_t::dword:
+                return 4;
+
+            case LESSDB::sectionParameterType_t::bit:
+            case LESSDB::sectionParameterType_t::halfByte:
+            case LESSDB::sectionParameterType_t::byte:
+            default:
+                return 1;
+            }
+        }
+    }    // namespace eeprom
+
+    namespace detail
+    {
+        namespace native
+        {
+            void saveEEPROM()
+            {
+                if ((eepromFile == nullptr) || !modified)
+                    return;
+
+                FILE* file = fopen(eepromFile, "wb");
+
+                if (file == nullptr)
+                    return;
+
+                fwrite(memory, 1, EEPROM_SIZE, file);
+                fclose(file);
+                modified = false;
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
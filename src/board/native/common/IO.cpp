@@ -0,0 +1,233 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mutex>
+#include "board/Board.h"
+#include "board/native/Native.h"
+#include "core/src/general/Helpers.h"
+#include "core/src/general/Timing.h"
+
+namespace
+{
+    ///
+    /// \brief Current states of virtual inputs.
+    /// Modified from timer thread and copied to read-only buffers once
+    /// the application checks for new data.
+    /// @{
+
+    uint8_t  digitalIn[DIGITAL_IN_ARRAY_SIZE];
+    uint16_t analogIn[MAX_NUMBER_OF_ANALOG];
+    bool     digitalInAvailable;
+    bool     analogInAvailable;
+
+    /// @}
+
+    uint8_t  digitalInReadOnly[DIGITAL_IN_ARRAY_SIZE];
+    uint16_t analogInReadOnly[MAX_NUMBER_OF_ANALOG];
+
+#ifdef PROFILING
+    uint32_t scanTimestamp;
+    uint32_t digitalInTimestamp;
+    uint32_t analogInTimestamp;
+#endif
+
+    std::mutex inputMutex;
+
+#if MAX_NUMBER_OF_LEDS > 0
+    bool  ledState[MAX_NUMBER_OF_LEDS];
+    FILE* ledFile;
+#endif
+}    // namespace
+
+namespace Board
+{
+    namespace io
+    {
+        void ledFlashStartup(bool fwUpdated)
+        {
+            //nothing to show
+        }
+
+        bool isInputDataAvailable()
+        {
+            std::lock_guard<std::mutex> lock(inputMutex);
+
+            if (!digitalInAvailable)
+                return false;
+
+            for (size_t i = 0; i < DIGITAL_IN_ARRAY_SIZE; i++)
+                digitalInReadOnly[i] = digitalIn[i];
+
+#ifdef PROFILING
+            digitalInTimestamp = scanTimestamp;
+#endif
+
+            digitalInAvailable = false;
+            return true;
+        }
+
+        bool getButtonState(uint8_t buttonIndex)
+        {
+            uint8_t arrayIndex = buttonIndex / 8;
+
+            return BIT_READ(digitalInReadOnly[arrayIndex], buttonIndex - 8 * arrayIndex);
+        }
+
+        uint8_t getButtonStates(uint8_t arrayIndex)
+        {
+            return digitalInReadOnly[arrayIndex];
+        }
+
+        uint8_t getEncoderPair(uint8_t buttonID)
+        {
+            return buttonID / 2;
+        }
+
+        uint8_t getEncoderPairState(uint8_t encoderID)
+        {
+            uint8_t buttonID = encoderID * 2;
+
+            uint8_t pairState = getButtonState(buttonID);
+            pairState <<= 1;
+            pairState |= getButtonState(buttonID + 1);
+
+            return pairState;
+        }
+
+        void writeLEDstate(uint8_t ledID, bool state)
+        {
+#if MAX_NUMBER_OF_LEDS > 0
+            if (ledID >= MAX_NUMBER_OF_LEDS)
+                return;
+
+            if (ledState[ledID] == state)
+                return;
+
+            ledState[ledID] = state;
+
+            if (ledFile != nullptr)
+                fprintf(ledFile, "%lu led %u %u\n", static_cast<unsigned long>(core::timing::currentRunTimeMs()), ledID, state);
+#endif
+        }
+
+        uint8_t getRGBaddress(uint8_t rgbID, rgbIndex_t index)
+        {
+            return rgbID * 3 + static_cast<uint8_t>(index);
+        }
+
+        uint8_t getRGBID(uint8_t ledID)
+        {
+            uint8_t result = ledID / 3;
+
+            if (result >= MAX_NUMBER_OF_RGB_LEDS)
+                return MAX_NUMBER_OF_RGB_LEDS - 1;
+            else
+                return result;
+        }
+
+        void setLEDfadeSpeed(uint8_t transitionSpeed)
+        {
+            //fading isn't emulated
+        }
+
+        bool isAnalogDataAvailable()
+        {
+            std::lock_guard<std::mutex> lock(inputMutex);
+
+            if (!analogInAvailable)
+                return false;
+
+            for (size_t i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
+                analogInReadOnly[i] = analogIn[i];
+
+#ifdef PROFILING
+            analogInTimestamp = scanTimestamp;
+#endif
+
+            analogInAvailable = false;
+            return true;
+        }
+
+        uint16_t getAnalogValue(uint8_t analogID)
+        {
+            return analogInReadOnly[analogID];
+        }
+
+#ifdef PROFILING
+        uint32_t inputDataTimestamp()
+        {
+            return digitalInTimestamp;
+        }
+
+        uint32_t analogDataTimestamp()
+        {
+            return analogInTimestamp;
+        }
+#endif
+    }    // namespace io
+
+    namespace detail
+    {
+        namespace native
+        {
+            void initIO()
+            {
+#if MAX_NUMBER_OF_LEDS > 0
+                const char* ledOut = getenv("OD_LED_OUT");
+
+                if (ledOut != nullptr)
+                    ledFile = fopen(ledOut, "w");
+#endif
+            }
+
+            void scanInputs()
+            {
+                std::lock_guard<std::mutex> lock(inputMutex);
+
+                digitalInAvailable = true;
+                analogInAvailable  = true;
+
+#ifdef PROFILING
+                scanTimestamp = Board::profiling::cycles();
+#endif
+            }
+
+            void setButtonState(uint8_t index, bool state)
+            {
+                if (index >= MAX_NUMBER_OF_BUTTONS)
+                    return;
+
+                std::lock_guard<std::mutex> lock(inputMutex);
+
+                uint8_t arrayIndex = index / 8;
+                BIT_WRITE(digitalIn[arrayIndex], index - 8 * arrayIndex, state);
+            }
+
+            void setAnalogValue(uint8_t index, uint16_t value)
+            {
+                if (index >= MAX_NUMBER_OF_ANALOG)
+                    return;
+
+                std::lock_guard<std::mutex> lock(inputMutex);
+                analogIn[index] = value;
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
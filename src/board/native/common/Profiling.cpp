@@ -0,0 +1,111 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef PROFILING
+
+#include <time.h>
+#include "board/Board.h"
+#include "board/native/Native.h"
+
+//There are no interrupts on native board and no portable way to read CPU cycle
+//counter: monotonic clock in nanoseconds is used instead.
+
+namespace
+{
+    ///
+    /// \brief Number of units written to each output, USB first, followed by all UART channels.
+    /// Same number is reported as queued and as sent since writes aren't buffered.
+    ///
+    uint32_t txCount[1 + UART_INTERFACES];
+
+    Board::profiling::txHandler_t txHandler;
+
+    size_t txIndex(Board::profiling::txPath_t path, uint8_t channel)
+    {
+        return path == Board::profiling::txPath_t::usb ? 0 : 1 + channel;
+    }
+}    // namespace
+
+namespace Board
+{
+    namespace profiling
+    {
+        uint32_t cycles()
+        {
+            timespec now;
+            clock_gettime(CLOCK_MONOTONIC, &now);
+
+            return static_cast<uint32_t>(now.tv_sec * 1000000000ULL + now.tv_nsec);
+        }
+
+        uint32_t cyclesPerUs()
+        {
+            return 1000;
+        }
+
+        void isrStats(isr_t isr, stats_t& stats)
+        {
+            stats = {};
+        }
+
+        void resetISRstats()
+        {
+        }
+
+        uint32_t txQueued(txPath_t path, uint8_t channel)
+        {
+            return txSent(path, channel);
+        }
+
+        uint32_t txSent(txPath_t path, uint8_t channel)
+        {
+            size_t index = txIndex(path, channel);
+
+            if (index > UART_INTERFACES)
+                return 0;
+
+            return txCount[index];
+        }
+
+        void setTxHandler(txHandler_t handler)
+        {
+            txHandler = handler;
+        }
+    }    // namespace profiling
+
+    namespace detail
+    {
+        namespace native
+        {
+            void txWritten(Board::profiling::txPath_t path, uint8_t channel, size_t count)
+            {
+                size_t index = txIndex(path, channel);
+
+                if (index > UART_INTERFACES)
+                    return;
+
+                txCount[index] += count;
+
+                if (txHandler != nullptr)
+                    txHandler(path, channel, txCount[index]);
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
+
+#endif
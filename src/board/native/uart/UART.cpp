@@ -0,0 +1,200 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "board/Board.h"
+#include "board/native/Native.h"
+
+//Each UART channel is backed by a pair of files (or pipes) specified with
+//OD_UART<n>_IN and OD_UART<n>_OUT environment variables. Channels without
+//configured files behave as if nothing is connected to them.
+
+namespace
+{
+    int           inFile[UART_INTERFACES];
+    FILE*         outFile[UART_INTERFACES];
+    bool          initialized[UART_INTERFACES];
+    volatile bool loopbackEnabled[UART_INTERFACES];
+}    // namespace
+
+namespace Board
+{
+    namespace UART
+    {
+        bool init(uint8_t channel, uint32_t baudRate)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            if (initialized[channel])
+                deInit(channel);
+
+            //baud rate doesn't matter here
+            char name[32];
+
+            snprintf(name, sizeof(name), "OD_UART%u_IN", channel);
+            const char* in = getenv(name);
+
+            snprintf(name, sizeof(name), "OD_UART%u_OUT", channel);
+            const char* out = getenv(name);
+
+            inFile[channel]  = (in != nullptr) ? open(in, O_RDONLY | O_NONBLOCK) : -1;
+            outFile[channel] = (out != nullptr) ? fopen(out, "wb") : nullptr;
+
+            if (outFile[channel] != nullptr)
+                setvbuf(outFile[channel], nullptr, _IONBF, 0);
+
+            loopbackEnabled[channel] = false;
+            initialized[channel]     = true;
+
+            return true;
+        }
+
+        bool deInit(uint8_t channel)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            if (!initialized[channel])
+                return true;
+
+            if (inFile[channel] >= 0)
+                close(inFile[channel]);
+
+            if (outFile[channel] != nullptr)
+                fclose(outFile[channel]);
+
+            inFile[channel]      = -1;
+            outFile[channel]     = nullptr;
+            initialized[channel] = false;
+
+            return true;
+        }
+
+        bool read(uint8_t channel, uint8_t& data)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            //in loopback mode, incoming data is consumed internally
+            if (!initialized[channel] || loopbackEnabled[channel])
+                return false;
+
+            if (inFile[channel] < 0)
+                return false;
+
+            return ::read(inFile[channel], &data, 1) == 1;
+        }
+
+        bool write(uint8_t channel, uint8_t data)
+        {
+            if (channel >= UART_INTERFACES)
+                return false;
+
+            if (!initialized[channel] || loopbackEnabled[channel])
+                return false;
+
+            if (outFile[channel] != nullptr)
+                fputc(data, outFile[channel]);
+
+#ifdef PROFILING
+            Board::detail::native::txWritten(Board::profiling::txPath_t::uart, channel, 1);
+#endif
+
+            return true;
+        }
+
+        bool tryWrite(uint8_t channel, uint8_t data)
+        {
+            //writes never block
+            return write(channel, data);
+        }
+
+        bool writePriority(uint8_t channel, uint8_t data)
+        {
+            //nothing is buffered so there is nothing to skip
+            return write(channel, data);
+        }
+
+        void setLoopbackState(uint8_t channel, bool state)
+        {
+            if (channel >= UART_INTERFACES)
+                return;
+
+            loopbackEnabled[channel] = state;
+        }
+
+        bool isTxEmpty(uint8_t channel)
+        {
+            //writes are unbuffered
+            return true;
+        }
+
+        size_t txSpace(uint8_t channel)
+        {
+            if (channel >= UART_INTERFACES)
+                return 0;
+
+            //writes never block
+            return SIZE_MAX;
+        }
+
+        size_t rxCount(uint8_t channel)
+        {
+            if (channel >= UART_INTERFACES)
+                return 0;
+
+            if (!initialized[channel] || loopbackEnabled[channel] || (inFile[channel] < 0))
+                return 0;
+
+            int count = 0;
+
+            if (ioctl(inFile[channel], FIONREAD, &count) < 0)
+                return 0;
+
+            return count;
+        }
+    }    // namespace UART
+
+    namespace detail
+    {
+        namespace native
+        {
+            void uartLoopback()
+            {
+                for (int channel = 0; channel < UART_INTERFACES; channel++)
+                {
+                    if (!initialized[channel] || !loopbackEnabled[channel])
+                        continue;
+
+                    if ((inFile[channel] < 0) || (outFile[channel] == nullptr))
+                        continue;
+
+                    uint8_t data;
+
+                    while (::read(inFile[channel], &data, 1) == 1)
+                        fputc(data, outFile[channel]);
+                }
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
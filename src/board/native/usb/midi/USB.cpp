@@ -0,0 +1,156 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef USB_MIDI_SUPPORTED
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include "board/Board.h"
+#include "board/native/Native.h"
+
+namespace
+{
+    ///
+    /// \brief Descriptor of the incoming endpoint.
+    /// Opened in non-blocking mode so that named pipes can be used as well.
+    ///
+    int   inFile = -1;
+    FILE* outFile;
+
+    ///
+    /// \brief Holds partially received packet since pipe reads can return less data than requested.
+    /// @{
+
+    uint8_t rxPacket[4];
+    uint8_t rxPacketCount;
+
+    /// @}
+}    // namespace
+
+namespace Board
+{
+    namespace USB
+    {
+        bool readMIDI(MIDI::USBMIDIpacket_t& USBMIDIpacket)
+        {
+            if (inFile < 0)
+                return false;
+
+            while (rxPacketCount < sizeof(rxPacket))
+            {
+                ssize_t count = ::read(inFile, &rxPacket[rxPacketCount], sizeof(rxPacket) - rxPacketCount);
+
+                if (count <= 0)
+                    return false;
+
+                rxPacketCount += count;
+            }
+
+            rxPacketCount = 0;
+
+            USBMIDIpacket.Event = rxPacket[0];
+            USBMIDIpacket.Data1 = rxPacket[1];
+            USBMIDIpacket.Data2 = rxPacket[2];
+            USBMIDIpacket.Data3 = rxPacket[3];
+
+            return true;
+        }
+
+        bool writeMIDI(MIDI::USBMIDIpacket_t& USBMIDIpacket)
+        {
+            if (outFile == nullptr)
+                return true;
+
+            uint8_t packet[4] = {
+                USBMIDIpacket.Event,
+                USBMIDIpacket.Data1,
+                USBMIDIpacket.Data2,
+                USBMIDIpacket.Data3,
+            };
+
+            if (fwrite(packet, 1, sizeof(packet), outFile) != sizeof(packet))
+                return false;
+
+#ifdef PROFILING
+            Board::detail::native::txWritten(Board::profiling::txPath_t::usb, 0, 1);
+#endif
+
+            return true;
+        }
+
+        void flush()
+        {
+            if (outFile != nullptr)
+                fflush(outFile);
+        }
+
+        void getTxStats(txStats_t& stats)
+        {
+            //writes never fail due to full buffer
+            stats.overflows = 0;
+            stats.stalls    = 0;
+        }
+
+        size_t rxPending()
+        {
+            if (inFile < 0)
+                return 0;
+
+            int count = 0;
+
+            if (ioctl(inFile, FIONREAD, &count) < 0)
+                return 0;
+
+            return (count + rxPacketCount) / sizeof(rxPacket);
+        }
+
+        bool isConfigured()
+        {
+            return outFile != nullptr;
+        }
+    }    // namespace USB
+
+    namespace detail
+    {
+        namespace native
+        {
+            void initUSB()
+            {
+                const char* in  = getenv("OD_USB_IN");
+                const char* out = getenv("OD_USB_OUT");
+
+                if (in != nullptr)
+                    inFile = open(in, O_RDONLY | O_NONBLOCK);
+
+                if (out != nullptr)
+                {
+                    outFile = fopen(out, "wb");
+
+                    //packets are pushed out on flush, same as on hardware targets
+                    if (outFile != nullptr)
+                        setvbuf(outFile, nullptr, _IOFBF, BUFSIZ);
+                }
+            }
+        }    // namespace native
+    }        // namespace detail
+}    // namespace Board
+
+#endif
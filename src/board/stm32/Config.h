@@ -21,9 +21,10 @@ limitations under the License.
 #include <inttypes.h>
 
 ///
-/// \brief Defines how many analog samples from the same input will be thrown away before storing the read value.
+/// \brief Indicates that all analog inputs are read in background using DMA.
+/// Conversions are timer triggered so there is no need to throw away any samples.
 ///
-#define ADC_IGNORED_SAMPLES_COUNT 5
+#define ADC_DMA
 
 ///
 /// \brief Location at which compiled binary CRC is written in EEPROM.
@@ -34,4 +35,23 @@ limitations under the License.
 ///
 /// \brief Total number of states between fully off and fully on for LEDs.
 ///
-#define NUMBER_OF_LED_TRANSITIONS 64
\ No newline at end of file
+#define NUMBER_OF_LED_TRANSITIONS 64
+
+///
+/// \brief Sizes in bytes of buffers used for each UART channel.
+/// Can be overriden by the board.
+/// @{
+
+#ifndef UART_TX_BUFFER_SIZE
+#define UART_TX_BUFFER_SIZE 256
+#endif
+
+#ifndef UART_TX_PRIORITY_BUFFER_SIZE
+#define UART_TX_PRIORITY_BUFFER_SIZE 8
+#endif
+
+#ifndef UART_RX_BUFFER_SIZE
+#define UART_RX_BUFFER_SIZE 256
+#endif
+
+/// @}
\ No newline at end of file
@@ -96,6 +96,12 @@ namespace Board
         {
             void mainTimer()
             {
+#ifdef FW_APP
+#ifdef PROFILING
+                uint32_t start = Board::profiling::cycles();
+#endif
+#endif
+
                 static bool _1ms = true;
 
                 _1ms = !_1ms;
@@ -116,6 +122,10 @@ namespace Board
                 }
 #ifdef FW_APP
                 Board::detail::io::checkDigitalInputs();
+
+#ifdef PROFILING
+                Board::detail::profiling::record(Board::profiling::isr_t::mainTimer, start);
+#endif
 #endif
             }
         }    // namespace isrHandling
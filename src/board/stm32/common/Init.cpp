@@ -34,10 +34,20 @@ namespace Board
 #ifdef FW_APP
         eeprom::init();
         detail::setup::adc();
+
+#ifdef SR_SPI
+        detail::setup::shiftRegisters();
+#endif
 #endif
 
         detail::setup::timers();
 
+#ifdef FW_APP
+#ifdef PROFILING
+        detail::setup::profiling();
+#endif
+#endif
+
 #ifdef USB_MIDI_SUPPORTED
         detail::setup::usb();
 #endif
@@ -0,0 +1,55 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef PROFILING
+
+#include "board/Board.h"
+#include "board/Internal.h"
+#include "stm32f4xx_hal.h"
+
+namespace Board
+{
+    namespace profiling
+    {
+        uint32_t cycles()
+        {
+            return DWT->CYCCNT;
+        }
+
+        uint32_t cyclesPerUs()
+        {
+            return SystemCoreClock / 1000000;
+        }
+    }    // namespace profiling
+
+    namespace detail
+    {
+        namespace setup
+        {
+            void profiling()
+            {
+                //enable trace and debug blocks, then start DWT cycle counter
+                CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+                DWT->CYCCNT = 0;
+                DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+            }
+        }    // namespace setup
+    }        // namespace detail
+}    // namespace Board
+
+#endif
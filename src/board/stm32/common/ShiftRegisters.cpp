@@ -0,0 +1,250 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef SR_SPI
+
+#include "board/Board.h"
+#include "board/Internal.h"
+#include "core/src/general/Helpers.h"
+#include "core/src/general/IO.h"
+#include "Pins.h"
+
+//Input (74HC165) and output (74HC595) shift register chains share the SPI clock line:
+//input chain is connected to MISO and output chain to MOSI. Both chains are clocked
+//with a single DMA transfer which is started from main timer interrupt. Latching of
+//outputs is done once the transfer is complete. SPI mode 0 is used: outputs sample the
+//data on rising edge, and inputs shift out the next bit on the same edge (after the
+//master has already sampled the current one).
+//To use this, board needs to define SR_SPI and latch pins for both chains, provide
+//srSPIDescriptor and srSPIDMA in its map and call isrHandling::srDMAtx/srDMArx
+//from the interrupt handlers of used DMA streams. HAL SPI module needs to be enabled
+//in board HAL configuration. See discovery_sr variant for reference.
+
+#ifndef SR_SPI_PRESCALER
+#define SR_SPI_PRESCALER SPI_BAUDRATEPRESCALER_16
+#endif
+
+namespace
+{
+#if defined(NUMBER_OF_IN_SR) && defined(NUMBER_OF_OUT_SR)
+    constexpr size_t TRANSFER_SIZE = NUMBER_OF_IN_SR > NUMBER_OF_OUT_SR ? NUMBER_OF_IN_SR : NUMBER_OF_OUT_SR;
+#elif defined(NUMBER_OF_IN_SR)
+    constexpr size_t TRANSFER_SIZE = NUMBER_OF_IN_SR;
+#else
+    constexpr size_t TRANSFER_SIZE = NUMBER_OF_OUT_SR;
+#endif
+
+    SPI_HandleTypeDef hspi;
+    DMA_HandleTypeDef hdmaTx;
+    DMA_HandleTypeDef hdmaRx;
+
+    ///
+    /// \brief Double buffers used for SPI transfers.
+    /// DMA always works on one buffer while the other one is accessed from application ISR.
+    /// @{
+
+    uint8_t txBuffer[2][TRANSFER_SIZE];
+    uint8_t rxBuffer[2][TRANSFER_SIZE];
+
+    /// @}
+
+    volatile uint8_t txActive;
+    volatile uint8_t rxActive;
+    volatile bool    outputsPending;
+    volatile bool    transferActive;
+}    // namespace
+
+extern "C" void HAL_SPI_MspInit(SPI_HandleTypeDef* hspi)
+{
+    auto descriptor = Board::detail::map::srSPIDescriptor();
+    auto dma        = Board::detail::map::srSPIDMA();
+
+    descriptor->enableClock();
+
+    for (size_t i = 0; i < descriptor->pins().size(); i++)
+        CORE_IO_CONFIG(descriptor->pins().at(i));
+
+    hdmaTx.Instance                 = dma.txStream;
+    hdmaTx.Init.Channel             = dma.txChannel;
+    hdmaTx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    hdmaTx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdmaTx.Init.MemInc              = DMA_MINC_ENABLE;
+    hdmaTx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdmaTx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    hdmaTx.Init.Mode                = DMA_NORMAL;
+    hdmaTx.Init.Priority            = DMA_PRIORITY_LOW;
+    hdmaTx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&hdmaTx) != HAL_OK)
+        Board::detail::errorHandler();
+
+    __HAL_LINKDMA(hspi, hdmatx, hdmaTx);
+
+    hdmaRx.Instance                 = dma.rxStream;
+    hdmaRx.Init.Channel             = dma.rxChannel;
+    hdmaRx.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    hdmaRx.Init.PeriphInc           = DMA_PINC_DISABLE;
+    hdmaRx.Init.MemInc              = DMA_MINC_ENABLE;
+    hdmaRx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    hdmaRx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    hdmaRx.Init.Mode                = DMA_NORMAL;
+    hdmaRx.Init.Priority            = DMA_PRIORITY_HIGH;
+    hdmaRx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+    if (HAL_DMA_Init(&hdmaRx) != HAL_OK)
+        Board::detail::errorHandler();
+
+    __HAL_LINKDMA(hspi, hdmarx, hdmaRx);
+
+    HAL_NVIC_SetPriority(dma.txIrqn, 0, 0);
+    HAL_NVIC_EnableIRQ(dma.txIrqn);
+    HAL_NVIC_SetPriority(dma.rxIrqn, 0, 0);
+    HAL_NVIC_EnableIRQ(dma.rxIrqn);
+}
+
+extern "C" void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi)
+{
+#ifdef NUMBER_OF_OUT_SR
+    //transfer new data from shift registers to outputs
+    CORE_IO_SET_LOW(SR_OUT_LATCH_PORT, SR_OUT_LATCH_PIN);
+    CORE_IO_SET_HIGH(SR_OUT_LATCH_PORT, SR_OUT_LATCH_PIN);
+#endif
+
+    rxActive ^= 1;
+    transferActive = false;
+}
+
+extern "C" void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)
+{
+    //drop the data from failed transfer and try again on next timer tick
+    transferActive = false;
+}
+
+namespace Board
+{
+    namespace detail
+    {
+        namespace setup
+        {
+            void shiftRegisters()
+            {
+                //DMA clocks are always enabled: there are only two controllers
+                __HAL_RCC_DMA1_CLK_ENABLE();
+                __HAL_RCC_DMA2_CLK_ENABLE();
+
+                hspi.Instance               = static_cast<SPI_TypeDef*>(map::srSPIDescriptor()->interface());
+                hspi.Init.Mode              = SPI_MODE_MASTER;
+                hspi.Init.Direction         = SPI_DIRECTION_2LINES;
+                hspi.Init.DataSize          = SPI_DATASIZE_8BIT;
+                hspi.Init.CLKPolarity       = SPI_POLARITY_LOW;
+                hspi.Init.CLKPhase          = SPI_PHASE_1EDGE;
+                hspi.Init.NSS               = SPI_NSS_SOFT;
+                hspi.Init.BaudRatePrescaler = SR_SPI_PRESCALER;
+                hspi.Init.FirstBit          = SPI_FIRSTBIT_MSB;
+                hspi.Init.TIMode            = SPI_TIMODE_DISABLE;
+                hspi.Init.CRCCalculation    = SPI_CRCCALCULATION_DISABLE;
+                hspi.Init.CRCPolynomial     = 10;
+
+                if (HAL_SPI_Init(&hspi) != HAL_OK)
+                    Board::detail::errorHandler();
+
+#ifdef NUMBER_OF_IN_SR
+                CORE_IO_SET_HIGH(SR_DIN_LATCH_PORT, SR_DIN_LATCH_PIN);
+
+                //inputs are active low: make sure nothing is reported as pressed before first transfer
+                for (size_t i = 0; i < TRANSFER_SIZE; i++)
+                    rxBuffer[0][i] = rxBuffer[1][i] = 0xFF;
+#endif
+
+#ifdef NUMBER_OF_OUT_SR
+                CORE_IO_SET_HIGH(SR_OUT_LATCH_PORT, SR_OUT_LATCH_PIN);
+#endif
+            }
+        }    // namespace setup
+
+        namespace isrHandling
+        {
+            void srDMAtx()
+            {
+                HAL_DMA_IRQHandler(&hdmaTx);
+            }
+
+            void srDMArx()
+            {
+                HAL_DMA_IRQHandler(&hdmaRx);
+            }
+        }    // namespace isrHandling
+
+        namespace io
+        {
+            namespace sr
+            {
+                bool startTransfer()
+                {
+                    if (transferActive)
+                        return false;
+
+#ifdef NUMBER_OF_IN_SR
+                    //load parallel inputs into the input chain
+                    CORE_IO_SET_LOW(SR_DIN_LATCH_PORT, SR_DIN_LATCH_PIN);
+                    _NOP();
+                    CORE_IO_SET_HIGH(SR_DIN_LATCH_PORT, SR_DIN_LATCH_PIN);
+#endif
+
+                    if (outputsPending)
+                    {
+                        txActive ^= 1;
+                        outputsPending = false;
+                    }
+
+                    transferActive = true;
+
+                    if (HAL_SPI_TransmitReceive_DMA(&hspi, txBuffer[txActive], rxBuffer[!rxActive], TRANSFER_SIZE) != HAL_OK)
+                    {
+                        transferActive = false;
+                        return false;
+                    }
+
+                    return true;
+                }
+
+                const uint8_t* inputs()
+                {
+                    return rxBuffer[rxActive];
+                }
+
+                uint8_t* outputs()
+                {
+#ifdef NUMBER_OF_OUT_SR
+                    //if output chain is shorter than input chain, leading bytes are shifted out of the chain
+                    return &txBuffer[!txActive][TRANSFER_SIZE - NUMBER_OF_OUT_SR];
+#else
+                    return txBuffer[!txActive];
+#endif
+                }
+
+                void commitOutputs()
+                {
+                    outputsPending = true;
+                }
+            }    // namespace sr
+        }        // namespace io
+    }            // namespace detail
+}    // namespace Board
+
+#endif
@@ -23,10 +23,214 @@ limitations under the License.
 #include "board/Internal.h"
 #include "core/src/general/Atomic.h"
 
+//When UART_DMA is defined by the board, incoming data is stored by DMA in circular buffer
+//which is processed on half/full transfer and on idle line, and outgoing data is moved
+//from TX buffers in chunks which are then sent with DMA. This way, only one interrupt
+//is generated for each received burst and for each sent chunk instead of every byte.
+//Boards need to provide uartDMA in their map and call isrHandling::uartDMAtx/uartDMArx
+//from the interrupt handlers of used DMA streams.
+
+#ifdef UART_DMA
+#ifndef UART_DMA_RX_BUFFER_SIZE
+#define UART_DMA_RX_BUFFER_SIZE 64
+#endif
+
+///
+/// \brief Maximum number of bytes sent in a single DMA transfer.
+/// Data written with Board::UART::writePriority can't be sent before the
+/// transfer already in progress is done, so this shouldn't be too large.
+///
+#ifndef UART_DMA_TX_CHUNK_SIZE
+#define UART_DMA_TX_CHUNK_SIZE 8
+#endif
+#endif
+
 namespace
 {
     UART_HandleTypeDef uartHandler[UART_INTERFACES];
-}
+
+#ifdef UART_DMA
+    DMA_HandleTypeDef hdmaTx[UART_INTERFACES];
+    DMA_HandleTypeDef hdmaRx[UART_INTERFACES];
+
+    uint8_t         rxDMAbuffer[UART_INTERFACES][UART_DMA_RX_BUFFER_SIZE];
+    uint8_t         txDMAbuffer[UART_INTERFACES][UART_DMA_TX_CHUNK_SIZE];
+    volatile size_t rxDMAposition[UART_INTERFACES];
+    volatile bool   txDMAactive[UART_INTERFACES];
+
+    uint8_t channelFromDMA(DMA_HandleTypeDef* hdma)
+    {
+        return static_cast<UART_HandleTypeDef*>(hdma->Parent) - uartHandler;
+    }
+
+    ///
+    /// \brief Passes all the data received by DMA since the last call on to the UART driver.
+    /// Must be called from UART or DMA interrupt.
+    ///
+    void processReceived(uint8_t channel)
+    {
+        size_t position = UART_DMA_RX_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(&hdmaRx[channel]);
+
+        if (position == UART_DMA_RX_BUFFER_SIZE)
+            position = 0;
+
+        while (rxDMAposition[channel] != position)
+        {
+            Board::detail::UART::storeIncomingData(channel, rxDMAbuffer[channel][rxDMAposition[channel]]);
+
+            if (++rxDMAposition[channel] == UART_DMA_RX_BUFFER_SIZE)
+                rxDMAposition[channel] = 0;
+        }
+    }
+
+    ///
+    /// \brief Starts new DMA transfer with the data waiting in TX buffers unless transfer is already in progress.
+    /// Must be called with interrupts disabled or from UART or DMA interrupt.
+    ///
+    void startTransfer(uint8_t channel)
+    {
+        if (txDMAactive[channel])
+            return;
+
+        size_t size = 0;
+
+        while (size < UART_DMA_TX_CHUNK_SIZE)
+        {
+            if (!Board::detail::UART::getNextByteToSend(channel, txDMAbuffer[channel][size]))
+                break;
+
+            size++;
+        }
+
+        if (!size)
+            return;
+
+        txDMAactive[channel] = true;
+
+        if (HAL_DMA_Start_IT(&hdmaTx[channel], reinterpret_cast<uint32_t>(txDMAbuffer[channel]), reinterpret_cast<uint32_t>(&uartHandler[channel].Instance->DR), size) != HAL_OK)
+        {
+            //data is lost, but at least transfers won't be stuck
+            txDMAactive[channel] = false;
+            return;
+        }
+
+        //transmission complete flag needs to be cleared before the transfer: it's used to detect the end of transmission
+        __HAL_UART_CLEAR_FLAG(&uartHandler[channel], UART_FLAG_TC);
+    }
+
+    void txDMAcomplete(DMA_HandleTypeDef* hdma)
+    {
+        auto channel = channelFromDMA(hdma);
+
+        txDMAactive[channel] = false;
+
+        //continue with the data queued in the meantime
+        startTransfer(channel);
+    }
+
+    void txDMAerror(DMA_HandleTypeDef* hdma)
+    {
+        txDMAactive[channelFromDMA(hdma)] = false;
+    }
+
+    void rxDMAevent(DMA_HandleTypeDef* hdma)
+    {
+        processReceived(channelFromDMA(hdma));
+    }
+
+    bool startReception(uint8_t channel)
+    {
+        rxDMAposition[channel] = 0;
+
+        return HAL_DMA_Start_IT(&hdmaRx[channel], reinterpret_cast<uint32_t>(&uartHandler[channel].Instance->DR), reinterpret_cast<uint32_t>(rxDMAbuffer[channel]), UART_DMA_RX_BUFFER_SIZE) == HAL_OK;
+    }
+
+    void rxDMAerror(DMA_HandleTypeDef* hdma)
+    {
+        //stream is disabled on error: drop whatever has been received and start over
+        startReception(channelFromDMA(hdma));
+    }
+
+    bool initDMA(uint8_t channel)
+    {
+        auto& dma = Board::detail::map::uartDMA(channel);
+
+        //DMA clocks are always enabled: there are only two controllers
+        __HAL_RCC_DMA1_CLK_ENABLE();
+        __HAL_RCC_DMA2_CLK_ENABLE();
+
+        hdmaTx[channel].Instance                 = dma.txStream;
+        hdmaTx[channel].Init.Channel             = dma.txChannel;
+        hdmaTx[channel].Init.Direction           = DMA_MEMORY_TO_PERIPH;
+        hdmaTx[channel].Init.PeriphInc           = DMA_PINC_DISABLE;
+        hdmaTx[channel].Init.MemInc              = DMA_MINC_ENABLE;
+        hdmaTx[channel].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdmaTx[channel].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+        hdmaTx[channel].Init.Mode                = DMA_NORMAL;
+        hdmaTx[channel].Init.Priority            = DMA_PRIORITY_LOW;
+        hdmaTx[channel].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+        if (HAL_DMA_Init(&hdmaTx[channel]) != HAL_OK)
+            return false;
+
+        __HAL_LINKDMA(&uartHandler[channel], hdmatx, hdmaTx[channel]);
+        hdmaTx[channel].XferCpltCallback  = txDMAcomplete;
+        hdmaTx[channel].XferErrorCallback = txDMAerror;
+
+        hdmaRx[channel].Instance                 = dma.rxStream;
+        hdmaRx[channel].Init.Channel             = dma.rxChannel;
+        hdmaRx[channel].Init.Direction           = DMA_PERIPH_TO_MEMORY;
+        hdmaRx[channel].Init.PeriphInc           = DMA_PINC_DISABLE;
+        hdmaRx[channel].Init.MemInc              = DMA_MINC_ENABLE;
+        hdmaRx[channel].Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+        hdmaRx[channel].Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+        hdmaRx[channel].Init.Mode                = DMA_CIRCULAR;
+        hdmaRx[channel].Init.Priority            = DMA_PRIORITY_HIGH;
+        hdmaRx[channel].Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+        if (HAL_DMA_Init(&hdmaRx[channel]) != HAL_OK)
+            return false;
+
+        __HAL_LINKDMA(&uartHandler[channel], hdmarx, hdmaRx[channel]);
+        hdmaRx[channel].XferHalfCpltCallback = rxDMAevent;
+        hdmaRx[channel].XferCpltCallback     = rxDMAevent;
+        hdmaRx[channel].XferErrorCallback    = rxDMAerror;
+
+        HAL_NVIC_SetPriority(dma.txIrqn, 0, 0);
+        HAL_NVIC_EnableIRQ(dma.txIrqn);
+        HAL_NVIC_SetPriority(dma.rxIrqn, 0, 0);
+        HAL_NVIC_EnableIRQ(dma.rxIrqn);
+
+        txDMAactive[channel] = false;
+
+        if (!startReception(channel))
+            return false;
+
+        SET_BIT(uartHandler[channel].Instance->CR3, USART_CR3_DMAR | USART_CR3_DMAT);
+
+        return true;
+    }
+
+    void deInitDMA(uint8_t channel)
+    {
+        //never initialized
+        if (hdmaRx[channel].Instance == nullptr)
+            return;
+
+        auto& dma = Board::detail::map::uartDMA(channel);
+
+        HAL_NVIC_DisableIRQ(dma.txIrqn);
+        HAL_NVIC_DisableIRQ(dma.rxIrqn);
+
+        HAL_DMA_Abort(&hdmaTx[channel]);
+        HAL_DMA_Abort(&hdmaRx[channel]);
+        HAL_DMA_DeInit(&hdmaTx[channel]);
+        HAL_DMA_DeInit(&hdmaRx[channel]);
+
+        txDMAactive[channel] = false;
+    }
+#endif
+}    // namespace
 
 namespace Board
 {
@@ -41,7 +245,14 @@ namespace Board
                     if (channel >= UART_INTERFACES)
                         return;
 
+#ifdef UART_DMA
+                    ATOMIC_SECTION
+                    {
+                        startTransfer(channel);
+                    }
+#else
                     __HAL_UART_ENABLE_IT(&uartHandler[channel], UART_IT_TXE);
+#endif
                 }
 
                 void disableDataEmptyInt(uint8_t channel)
@@ -49,7 +260,9 @@ namespace Board
                     if (channel >= UART_INTERFACES)
                         return;
 
+#ifndef UART_DMA
                     __HAL_UART_DISABLE_IT(&uartHandler[channel], UART_IT_TXE);
+#endif
                 }
 
                 bool deInit(uint8_t channel)
@@ -57,6 +270,10 @@ namespace Board
                     if (channel >= UART_INTERFACES)
                         return false;
 
+#ifdef UART_DMA
+                    deInitDMA(channel);
+#endif
+
                     return HAL_UART_DeInit(&uartHandler[channel]) == HAL_OK;
                 }
 
@@ -83,8 +300,16 @@ namespace Board
                     //enable transmission done interrupt
                     __HAL_UART_ENABLE_IT(&uartHandler[channel], UART_IT_TC);
 
+#ifdef UART_DMA
+                    if (!initDMA(channel))
+                        return false;
+
+                    //received data is processed once the line becomes idle, even if DMA buffer isn't half full
+                    __HAL_UART_ENABLE_IT(&uartHandler[channel], UART_IT_IDLE);
+#else
                     //enable data not empty interrupt
                     __HAL_UART_ENABLE_IT(&uartHandler[channel], UART_IT_RXNE);
+#endif
 
                     return true;
                 }
@@ -98,6 +323,41 @@ namespace Board
 
         namespace isrHandling
         {
+#ifdef UART_DMA
+            void uart(uint8_t channel)
+            {
+                uint32_t isrflags = READ_REG(uartHandler[channel].Instance->SR);
+                uint32_t cr1its   = READ_REG(uartHandler[channel].Instance->CR1);
+
+                if (isrflags & (USART_SR_IDLE | USART_SR_PE | USART_SR_FE | USART_SR_ORE | USART_SR_NE))
+                {
+                    //idle and error flags are cleared by reading status and then data register
+                    __HAL_UART_CLEAR_PEFLAG(&uartHandler[channel]);
+
+                    if (isrflags & USART_SR_IDLE)
+                        processReceived(channel);
+                }
+
+                if (((isrflags & USART_SR_TC) != RESET) && ((cr1its & USART_CR1_TCIE) != RESET))
+                {
+                    __HAL_UART_CLEAR_FLAG(&uartHandler[channel], UART_FLAG_TC);
+
+                    //transmission is done only if no more data is being sent by DMA
+                    if (!txDMAactive[channel])
+                        Board::detail::UART::indicateTxComplete(channel);
+                }
+            }
+
+            void uartDMAtx(uint8_t channel)
+            {
+                HAL_DMA_IRQHandler(&hdmaTx[channel]);
+            }
+
+            void uartDMArx(uint8_t channel)
+            {
+                HAL_DMA_IRQHandler(&hdmaRx[channel]);
+            }
+#else
             void uart(uint8_t channel)
             {
                 uint32_t isrflags     = READ_REG(uartHandler[channel].Instance->SR);
@@ -137,6 +397,7 @@ namespace Board
                     }
                 }
             }
+#endif
         }    // namespace isrHandling
     }        // namespace detail
 }    // namespace Board
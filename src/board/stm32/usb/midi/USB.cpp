@@ -35,22 +35,115 @@ limitations under the License.
 
 /// @}
 
+///
+/// \brief Number of USB MIDI packets which can be queued for sending.
+///
+#define TX_RING_SIZE 256
+
+///
+/// \brief Time in milliseconds after which pending transfer which hasn't been collected by host is considered stalled.
+///
+#define TX_STALL_TIMEOUT 100
+
 namespace
 {
     USBD_HandleTypeDef             hUsbDeviceFS;
     volatile bool                  TxDone;
     __ALIGN_BEGIN volatile uint8_t rxBuffer[RX_BUFFER_SIZE] __ALIGN_END;
 
+    //USBD_LL_Transmit doesn't copy the data - buffer must remain intact until the transfer is complete
+    __ALIGN_BEGIN uint8_t txBuffer[TX_BUFFER_SIZE] __ALIGN_END;
+
     //rxBuffer is overriden every time RxCallback is called
     //save results in ring buffer and remove them as needed in readMIDI
     //not really the most optimized way, however, we are not in AVR land anymore
     core::RingBuffer<uint8_t, RX_BUFFER_SIZE> rxBufferRing;
 
+    //outgoing packets are queued here and sent in as few transfers as possible
+    //new transfer is started either from flush or from TxCompleteCallback once previous one is done
+    core::RingBuffer<MIDI::USBMIDIpacket_t, TX_RING_SIZE> txBufferRing;
+
+    ///
+    /// \brief Time in milliseconds when last transfer has been started.
+    ///
+    uint32_t txStartTime;
+
+    ///
+    /// \brief Set to true once pending transfer has been counted as stalled so that it's counted only once.
+    ///
+    bool txStallCounted;
+
+    Board::USB::txStats_t usbTxStats;
+
+#ifdef PROFILING
+    ///
+    /// \brief Number of packets in transfer which is currently in progress.
+    ///
+    uint8_t txTransferPackets;
+#endif
+
+    ///
+    /// \brief Sends as many queued packets as possible in single transfer.
+    /// Must be called with interrupts disabled or from USB interrupt.
+    ///
+    void startTransfer()
+    {
+        if (!TxDone)
+            return;
+
+        size_t size = 0;
+
+        while (size < TX_BUFFER_SIZE)
+        {
+            MIDI::USBMIDIpacket_t packet;
+
+            if (!txBufferRing.remove(packet))
+                break;
+
+            txBuffer[size++] = packet.Event;
+            txBuffer[size++] = packet.Data1;
+            txBuffer[size++] = packet.Data2;
+            txBuffer[size++] = packet.Data3;
+        }
+
+        if (!size)
+            return;
+
+#ifdef PROFILING
+        txTransferPackets = size / sizeof(MIDI::USBMIDIpacket_t);
+#endif
+
+        TxDone         = false;
+        txStallCounted = false;
+        txStartTime    = core::timing::currentRunTimeMs();
+        USBD_LL_Transmit(&hUsbDeviceFS, MIDI_STREAM_IN_EPADDR, txBuffer, size);
+    }
+
+#ifdef PROFILING
+    ///
+    /// \brief Reports all packets which are about to be discarded as sent.
+    ///
+    void discardTx()
+    {
+        size_t discarded = txBufferRing.count();
+
+        if (!TxDone)
+            discarded += txTransferPackets;
+
+        Board::detail::profiling::txSent(Board::profiling::txPath_t::usb, 0, discarded);
+    }
+#endif
+
     uint8_t initCallback(USBD_HandleTypeDef* pdev, uint8_t cfgidx)
     {
         USBD_LL_OpenEP(pdev, MIDI_STREAM_IN_EPADDR, USBD_EP_TYPE_BULK, TX_BUFFER_SIZE);
         USBD_LL_OpenEP(pdev, MIDI_STREAM_OUT_EPADDR, USBD_EP_TYPE_BULK, RX_BUFFER_SIZE);
         USBD_LL_PrepareReceive(pdev, MIDI_STREAM_OUT_EPADDR, (uint8_t*)(rxBuffer), RX_BUFFER_SIZE);
+#ifdef PROFILING
+        discardTx();
+#endif
+
+        txBufferRing.reset();
         TxDone = true;
         return 0;
     }
@@ -59,12 +152,26 @@ namespace
     {
         USBD_LL_CloseEP(pdev, MIDI_STREAM_IN_EPADDR);
         USBD_LL_CloseEP(pdev, MIDI_STREAM_OUT_EPADDR);
+#ifdef PROFILING
+        discardTx();
+#endif
+
+        txBufferRing.reset();
+        TxDone = true;
         return 0;
     }
 
     uint8_t TxCompleteCallback(USBD_HandleTypeDef* pdev, uint8_t epnum)
     {
         TxDone = true;
+
+#ifdef PROFILING
+        Board::detail::profiling::txSent(Board::profiling::txPath_t::usb, 0, txTransferPackets);
+#endif
+
+        //continue with the packets queued in the meantime
+        startTransfer();
+
         return USBD_OK;
     }
 
@@ -214,12 +321,32 @@ namespace Board
 
         bool writeMIDI(MIDI::USBMIDIpacket_t& USBMIDIpacket)
         {
-            while (!TxDone)
+            if (hUsbDeviceFS.dev_state != USBD_STATE_CONFIGURED)
+                return false;
+
+            bool returnValue = true;
+
+            ATOMIC_SECTION
             {
+                if (!txBufferRing.insert(USBMIDIpacket))
+                {
+                    usbTxStats.overflows++;
+                    returnValue = false;
+                }
+                else
+                {
+#ifdef PROFILING
+                    Board::detail::profiling::txQueued(Board::profiling::txPath_t::usb, 0, 1);
+#endif
+
+                    //enough data for full transfer - no point in waiting for flush
+                    if (txBufferRing.count() >= (TX_BUFFER_SIZE / sizeof(MIDI::USBMIDIpacket_t)))
+                        startTransfer();
+                }
             }
 
-            TxDone = false;
-            USBD_LL_Transmit(&hUsbDeviceFS, MIDI_STREAM_IN_EPADDR, (uint8_t*)&USBMIDIpacket, 4);
+            if (!returnValue)
+                return false;
 
 #ifdef LED_INDICATORS
             Board::detail::io::indicateMIDItraffic(MIDI::interface_t::usb, Board::detail::midiTrafficDirection_t::outgoing);
@@ -227,5 +354,46 @@ namespace Board
 
             return true;
         }
+
+        void flush()
+        {
+            ATOMIC_SECTION
+            {
+                if (TxDone)
+                {
+                    startTransfer();
+                }
+                else if (!txStallCounted && ((core::timing::currentRunTimeMs() - txStartTime) > TX_STALL_TIMEOUT))
+                {
+                    usbTxStats.stalls++;
+                    txStallCounted = true;
+                }
+            }
+        }
+
+        void getTxStats(txStats_t& stats)
+        {
+            ATOMIC_SECTION
+            {
+                stats = usbTxStats;
+            }
+        }
+
+        size_t rxPending()
+        {
+            size_t pending;
+
+            ATOMIC_SECTION
+            {
+                pending = rxBufferRing.count() / 4;
+            }
+
+            return pending;
+        }
+
+        bool isConfigured()
+        {
+            return hUsbDeviceFS.dev_state == USBD_STATE_CONFIGURED;
+        }
     }    // namespace USB
 }    // namespace Board
\ No newline at end of file
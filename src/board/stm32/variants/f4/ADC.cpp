@@ -0,0 +1,270 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#ifdef FW_APP
+#if MAX_NUMBER_OF_ANALOG > 0
+
+#include "stm32f4xx_hal.h"
+#include "board/Board.h"
+#include "board/Internal.h"
+#include "core/src/general/Helpers.h"
+#include "Pins.h"
+
+//ADC conversions are triggered with TIM8 and stored with DMA2 in circular mode, so that
+//the CPU is interrupted only once all the analog inputs have been read.
+//When multiplexers are used, all multiplexers are read in a single scan for each
+//multiplexer input. Multiplexer inputs are switched with another DMA stream which
+//writes to GPIO port on each timer update, and the conversion is triggered by timer
+//compare event later in the same period, giving the multiplexer time to settle.
+//All multiplexer select pins need to be on the same port.
+
+namespace
+{
+#ifdef NUMBER_OF_MUX
+    ///
+    /// \brief Time in microseconds spent on a single multiplexer input.
+    ///
+    constexpr uint32_t SCAN_PERIOD_US = 100;
+
+    ///
+    /// \brief Delay in microseconds between multiplexer input switch and start of conversion.
+    ///
+    constexpr uint32_t SCAN_SETTLE_TIME_US = 10;
+
+    constexpr size_t FRAME_SIZE = NUMBER_OF_MUX * NUMBER_OF_MUX_INPUTS;
+
+    ///
+    /// \brief Values written to GPIO BSRR register to select multiplexer inputs.
+    /// Value at index N selects input N+1 since it's written at the end of the period
+    /// in which input N is being read.
+    ///
+    uint32_t          muxSelect[NUMBER_OF_MUX_INPUTS];
+    DMA_HandleTypeDef hdmaMux;
+#else
+    ///
+    /// \brief Time in microseconds between two scans of all analog inputs.
+    ///
+    constexpr uint32_t SCAN_PERIOD_US = 250;
+
+    constexpr size_t FRAME_SIZE = MAX_NUMBER_OF_ANALOG;
+#endif
+
+    TIM_HandleTypeDef  htim8;
+    DMA_HandleTypeDef  hdmaADC;
+    ADC_HandleTypeDef* hadc;
+
+    volatile uint16_t samples[FRAME_SIZE];
+
+#ifdef NUMBER_OF_MUX
+    uint32_t muxSelectValue(uint8_t muxInput)
+    {
+        uint8_t  channel = Board::detail::map::muxChannel(muxInput);
+        uint32_t value   = 0;
+
+        //lower half of BSRR sets the pin, upper half resets it
+        value |= BIT_READ(channel, 0) ? MUX_S0_PIN : (MUX_S0_PIN << 16);
+        value |= BIT_READ(channel, 1) ? MUX_S1_PIN : (MUX_S1_PIN << 16);
+        value |= BIT_READ(channel, 2) ? MUX_S2_PIN : (MUX_S2_PIN << 16);
+        value |= BIT_READ(channel, 3) ? MUX_S3_PIN : (MUX_S3_PIN << 16);
+
+        return value;
+    }
+#endif
+
+    ///
+    /// \brief Returns the amount of TIM8 ticks in one microsecond.
+    /// Bus clocks differ between boards: TIM8 runs from APB2 clock, which is doubled
+    /// for timers whenever APB2 prescaler isn't 1.
+    ///
+    uint32_t timerTicksPerUs()
+    {
+        uint32_t clock = HAL_RCC_GetPCLK2Freq();
+
+        if (RCC->CFGR & RCC_CFGR_PPRE2)
+            clock *= 2;
+
+        return clock / 1000000;
+    }
+
+    ///
+    /// \brief Starts (or restarts) the entire scanning chain from the first analog input.
+    ///
+    void startScan()
+    {
+        HAL_TIM_Base_Stop(&htim8);
+        __HAL_TIM_SET_COUNTER(&htim8, 0);
+        HAL_ADC_Stop_DMA(hadc);
+
+#ifdef NUMBER_OF_MUX
+        HAL_TIM_PWM_Stop(&htim8, TIM_CHANNEL_1);
+        HAL_DMA_Abort(&hdmaMux);
+
+        MUX_S0_PORT->BSRR = muxSelect[NUMBER_OF_MUX_INPUTS - 1];
+
+        if (HAL_DMA_Start(&hdmaMux, reinterpret_cast<uint32_t>(muxSelect), reinterpret_cast<uint32_t>(&MUX_S0_PORT->BSRR), NUMBER_OF_MUX_INPUTS) != HAL_OK)
+            Board::detail::errorHandler();
+
+        __HAL_TIM_ENABLE_DMA(&htim8, TIM_DMA_UPDATE);
+#endif
+
+        if (HAL_ADC_Start_DMA(hadc, reinterpret_cast<uint32_t*>(const_cast<uint16_t*>(samples)), FRAME_SIZE) != HAL_OK)
+            Board::detail::errorHandler();
+
+        //only full frames are of interest
+        __HAL_DMA_DISABLE_IT(&hdmaADC, DMA_IT_HT);
+
+#ifdef NUMBER_OF_MUX
+        HAL_TIM_PWM_Start(&htim8, TIM_CHANNEL_1);
+#else
+        HAL_TIM_Base_Start(&htim8);
+#endif
+    }
+}    // namespace
+
+extern "C" void DMA2_Stream0_IRQHandler(void)
+{
+#ifdef PROFILING
+    uint32_t start = Board::profiling::cycles();
+#endif
+
+    if (__HAL_DMA_GET_FLAG(&hdmaADC, __HAL_DMA_GET_TC_FLAG_INDEX(&hdmaADC)))
+    {
+        __HAL_DMA_CLEAR_FLAG(&hdmaADC, __HAL_DMA_GET_TC_FLAG_INDEX(&hdmaADC));
+
+        //next frame starts only after the next timer period so there is
+        //plenty of time to copy the samples before they get overwritten
+        Board::detail::isrHandling::adcFrame(samples);
+    }
+    else
+    {
+        //errors
+        HAL_DMA_IRQHandler(&hdmaADC);
+    }
+
+#ifdef PROFILING
+    Board::detail::profiling::record(Board::profiling::isr_t::adc, start);
+#endif
+}
+
+extern "C" void ADC_IRQHandler(void)
+{
+    if (__HAL_ADC_GET_FLAG(hadc, ADC_FLAG_OVR))
+    {
+        //DMA requests are stopped on overrun: clear the flag and restart everything
+        //so that the samples are aligned with multiplexer inputs again
+        __HAL_ADC_CLEAR_FLAG(hadc, ADC_FLAG_OVR);
+        startScan();
+    }
+}
+
+namespace Board
+{
+    namespace detail
+    {
+        namespace setup
+        {
+            void adcScan(ADC_HandleTypeDef& adcHandle)
+            {
+                hadc = &adcHandle;
+
+                __HAL_RCC_DMA2_CLK_ENABLE();
+                __HAL_RCC_TIM8_CLK_ENABLE();
+
+                hdmaADC.Instance                 = DMA2_Stream0;
+                hdmaADC.Init.Channel             = DMA_CHANNEL_0;
+                hdmaADC.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+                hdmaADC.Init.PeriphInc           = DMA_PINC_DISABLE;
+                hdmaADC.Init.MemInc              = DMA_MINC_ENABLE;
+                hdmaADC.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+                hdmaADC.Init.MemDataAlignment    = DMA_MDATAALIGN_HALFWORD;
+                hdmaADC.Init.Mode                = DMA_CIRCULAR;
+                hdmaADC.Init.Priority            = DMA_PRIORITY_HIGH;
+                hdmaADC.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+                if (HAL_DMA_Init(&hdmaADC) != HAL_OK)
+                    Board::detail::errorHandler();
+
+                __HAL_LINKDMA(hadc, DMA_Handle, hdmaADC);
+
+                HAL_NVIC_SetPriority(DMA2_Stream0_IRQn, 0, 0);
+                HAL_NVIC_EnableIRQ(DMA2_Stream0_IRQn);
+
+                htim8.Instance               = TIM8;
+                htim8.Init.Prescaler         = 0;
+                htim8.Init.CounterMode       = TIM_COUNTERMODE_UP;
+                htim8.Init.Period            = (SCAN_PERIOD_US * timerTicksPerUs()) - 1;
+                htim8.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+                htim8.Init.RepetitionCounter = 0;
+                htim8.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+#ifdef NUMBER_OF_MUX
+                if ((MUX_S1_PORT != MUX_S0_PORT) || (MUX_S2_PORT != MUX_S0_PORT) || (MUX_S3_PORT != MUX_S0_PORT))
+                    Board::detail::errorHandler();
+
+                for (int i = 0; i < NUMBER_OF_MUX_INPUTS; i++)
+                    muxSelect[i] = muxSelectValue((i + 1) % NUMBER_OF_MUX_INPUTS);
+
+                //TIM8 update request
+                hdmaMux.Instance                 = DMA2_Stream1;
+                hdmaMux.Init.Channel             = DMA_CHANNEL_7;
+                hdmaMux.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+                hdmaMux.Init.PeriphInc           = DMA_PINC_DISABLE;
+                hdmaMux.Init.MemInc              = DMA_MINC_ENABLE;
+                hdmaMux.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+                hdmaMux.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+                hdmaMux.Init.Mode                = DMA_CIRCULAR;
+                hdmaMux.Init.Priority            = DMA_PRIORITY_MEDIUM;
+                hdmaMux.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+                if (HAL_DMA_Init(&hdmaMux) != HAL_OK)
+                    Board::detail::errorHandler();
+
+                if (HAL_TIM_PWM_Init(&htim8) != HAL_OK)
+                    Board::detail::errorHandler();
+
+                //conversion is started on rising edge of channel 1, after multiplexer has settled
+                TIM_OC_InitTypeDef sConfigOC = { 0 };
+
+                sConfigOC.OCMode     = TIM_OCMODE_PWM2;
+                sConfigOC.Pulse      = (SCAN_SETTLE_TIME_US * timerTicksPerUs()) - 1;
+                sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+                sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+
+                if (HAL_TIM_PWM_ConfigChannel(&htim8, &sConfigOC, TIM_CHANNEL_1) != HAL_OK)
+                    Board::detail::errorHandler();
+#else
+                if (HAL_TIM_Base_Init(&htim8) != HAL_OK)
+                    Board::detail::errorHandler();
+
+                TIM_MasterConfigTypeDef sMasterConfig = { 0 };
+
+                sMasterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+                sMasterConfig.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+
+                if (HAL_TIMEx_MasterConfigSynchronization(&htim8, &sMasterConfig) != HAL_OK)
+                    Board::detail::errorHandler();
+#endif
+
+                startScan();
+            }
+        }    // namespace setup
+    }        // namespace detail
+}    // namespace Board
+
+#endif
+#endif
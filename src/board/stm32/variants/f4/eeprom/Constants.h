@@ -24,4 +24,16 @@
 ///
 /// \brief MCU voltage needed in order to write words to flash memory (2.7V to 3.6V).
 ///
-#define EEPROM_VOLTAGE_RANGE (uint8_t) FLASH_VOLTAGE_RANGE_3
\ No newline at end of file
+#define EEPROM_VOLTAGE_RANGE (uint8_t) FLASH_VOLTAGE_RANGE_3
+
+///
+/// \brief Percentage of the active page which needs to be filled before its contents
+/// are transferred to the other page.
+///
+#define EEPROM_TRANSFER_THRESHOLD 75
+
+///
+/// \brief Number of records from the active page processed in single update call while
+/// the page transfer is in progress.
+///
+#define EEPROM_TRANSFER_STEP 32
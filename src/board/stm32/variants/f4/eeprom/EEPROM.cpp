@@ -3,6 +3,7 @@
 #include "EmuEEPROM/src/EmuEEPROM.h"
 #include "stm32f4xx.h"
 #include "Constants.h"
+#include "core/src/general/Timing.h"
 
 namespace
 {
@@ -39,7 +40,7 @@ namespace
             pEraseInit.TypeErase    = FLASH_TYPEERASE_SECTORS;
 
             uint32_t          eraseStatus;
-            HAL_StatusTypeDef halStatus = HAL_FLASH_Unlock();
+            HAL_StatusTypeDef halStatus = unlock();
 
             if (halStatus == HAL_OK)
             {
@@ -47,13 +48,13 @@ namespace
                 halStatus = HAL_FLASHEx_Erase(&pEraseInit, &eraseStatus);
             }
 
-            HAL_FLASH_Lock();
+            lock();
             return (halStatus == HAL_OK) && (eraseStatus == 0xFFFFFFFFU);
         }
 
         bool write16(uint32_t address, uint16_t data) override
         {
-            HAL_StatusTypeDef halStatus = HAL_FLASH_Unlock();
+            HAL_StatusTypeDef halStatus = unlock();
 
             if (halStatus == HAL_OK)
             {
@@ -61,13 +62,13 @@ namespace
                 halStatus = HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, address, data);
             }
 
-            HAL_FLASH_Lock();
+            lock();
             return (halStatus == HAL_OK);
         }
 
         bool write32(uint32_t address, uint32_t data) override
         {
-            HAL_StatusTypeDef halStatus = HAL_FLASH_Unlock();
+            HAL_StatusTypeDef halStatus = unlock();
 
             if (halStatus == HAL_OK)
             {
@@ -75,7 +76,7 @@ namespace
                 halStatus = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address, data);
             }
 
-            HAL_FLASH_Lock();
+            lock();
             return (halStatus == HAL_OK);
         }
 
@@ -119,27 +120,520 @@ namespace
             return EEPROM_SIZE;
         }
 
+        ///
+        /// \brief Keeps the flash unlocked until endBatch is called.
+        /// Used to avoid unlocking and locking the flash for each written value.
+        ///
+        bool beginBatch()
+        {
+            if (HAL_FLASH_Unlock() != HAL_OK)
+                return false;
+
+            batchActive = true;
+            return true;
+        }
+
+        void endBatch()
+        {
+            batchActive = false;
+            HAL_FLASH_Lock();
+        }
+
         private:
+        HAL_StatusTypeDef unlock()
+        {
+            if (batchActive)
+                return HAL_OK;
+
+            return HAL_FLASH_Unlock();
+        }
+
+        void lock()
+        {
+            if (!batchActive)
+                HAL_FLASH_Lock();
+        }
+
         pageDescriptor_t& page1;
         pageDescriptor_t& page2;
         const size_t      totalSize;
+        bool              batchActive = false;
+    };
+
+
+    ///
+    /// \brief Emulated EEPROM stored in two flash pages.
+    /// First word in each page holds the page status and is followed by 32-bit records: upper
+    /// half-word of each record holds the variable address and lower half-word its value.
+    /// New values are appended to the active page, so the last record for an address holds its
+    /// current value. Once the active page is filled over EEPROM_TRANSFER_THRESHOLD, latest values
+    /// are transferred to the other page a few records at a time while new values are written
+    /// to the other page already. Old page is erased only once everything has been transferred.
+    ///
+    class PageStorage
+    {
+        public:
+        using page_t = EmuEEPROM::StorageAccess::page_t;
+
+        ///
+        /// \brief Total number of records which fit in a single page.
+        ///
+        static constexpr uint32_t NUMBER_OF_RECORDS = (EEPROM_PAGE_SIZE / 4) - 1;
+
+        PageStorage(STM32F4EEPROM& flash)
+            : flash(flash)
+        {}
+
+        bool init()
+        {
+            auto status1 = flash.pageStatus(page_t::page1);
+            auto status2 = flash.pageStatus(page_t::page2);
+
+            state = state_t::idle;
+
+            if ((status1 == EmuEEPROM::pageStatus_t::valid) && (status2 != EmuEEPROM::pageStatus_t::valid))
+            {
+                activePage = page_t::page1;
+            }
+            else if ((status2 == EmuEEPROM::pageStatus_t::valid) && (status1 != EmuEEPROM::pageStatus_t::valid))
+            {
+                activePage = page_t::page2;
+            }
+            else if ((status1 == EmuEEPROM::pageStatus_t::receiving) && (status2 == EmuEEPROM::pageStatus_t::erased))
+            {
+                //old page has already been erased, only the status of new page is missing
+                activePage = page_t::page1;
+
+                if (!setStatus(activePage, EmuEEPROM::pageStatus_t::valid))
+                    return format();
+            }
+            else if ((status2 == EmuEEPROM::pageStatus_t::receiving) && (status1 == EmuEEPROM::pageStatus_t::erased))
+            {
+                activePage = page_t::page2;
+
+                if (!setStatus(activePage, EmuEEPROM::pageStatus_t::valid))
+                    return format();
+            }
+            else
+            {
+                return format();
+            }
+
+            activeRecords = countRecords(activePage);
+
+            if (flash.pageStatus(otherPage()) == EmuEEPROM::pageStatus_t::receiving)
+            {
+                //transfer has been interrupted: values already found in the new page are
+                //the same or newer than the ones in active page so it's safe to continue
+                targetRecords = countRecords(otherPage());
+                beginTransfer();
+
+                for (uint32_t i = 0; i < targetRecords; i++)
+                {
+                    uint32_t record;
+                    flash.read32(recordAddress(otherPage(), i), record);
+
+                    if ((record >> 16) < NUMBER_OF_RECORDS)
+                        setCopied(record >> 16);
+                }
+
+                if (!completeTransfer())
+                    return format();
+            }
+            else if (!isErased(otherPage()))
+            {
+                //old page erase has been interrupted
+                if (!flash.erasePage(otherPage()))
+                    return false;
+            }
+
+            updateThreshold();
+            return true;
+        }
+
+        bool format()
+        {
+            //erasing takes a while, skip it for pages which don't hold anything
+            bool result = (isErased(page_t::page1) || flash.erasePage(page_t::page1)) &&
+                          (isErased(page_t::page2) || flash.erasePage(page_t::page2)) &&
+                          setStatus(page_t::page1, EmuEEPROM::pageStatus_t::valid);
+
+            activePage    = page_t::page1;
+            activeRecords = 0;
+            state         = state_t::idle;
+            updateThreshold();
+
+            return result;
+        }
+
+        ///
+        /// \brief Reads the latest values of all variables in a single pass through the active page.
+        /// Must be called after init, when no transfer is in progress.
+        /// @param [in,out] values  Array in which read values are stored, indexed by variable address.
+        ///                         Values of variables which aren't found are left untouched.
+        /// @param [in,out] valid   Bitmap in which bits of all found addresses are set.
+        ///
+        void load(uint16_t* values, uint32_t* valid)
+        {
+            uint32_t record;
+
+            //records are appended so the last one for each address wins
+            for (uint32_t i = 0; i < activeRecords; i++)
+            {
+                flash.read32(recordAddress(activePage, i), record);
+
+                uint32_t address = record >> 16;
+
+                if (address >= NUMBER_OF_RECORDS)
+                    continue;
+
+                values[address] = record & 0xFFFF;
+                valid[address / 32] |= static_cast<uint32_t>(1) << (address % 32);
+            }
+        }
+
+        bool write(uint32_t address, uint16_t data)
+        {
+            if (address >= NUMBER_OF_RECORDS)
+                return false;
+
+            if ((state == state_t::idle) && (activeRecords >= transferThreshold))
+                startTransfer();
+
+            if (state == state_t::idle)
+            {
+                if (append(activePage, activeRecords, address, data))
+                    return true;
+
+                //page is full and the transfer couldn't be started earlier, do it right away
+                if (!startTransfer() || !completeTransfer())
+                    return false;
+
+                return write(address, data);
+            }
+
+            if (!append(otherPage(), targetRecords, address, data))
+            {
+                //new page got filled before the transfer has been completed
+                if (!completeTransfer())
+                    return false;
+
+                return write(address, data);
+            }
+
+            if (state == state_t::copying)
+            {
+                //older value from active page mustn't overwrite this one
+                setCopied(address);
+
+                //keep the transfer ahead of new writes so that the new page can't be
+                //filled with them before all the values from active page are copied
+                copy(EEPROM_TRANSFER_STEP);
+            }
+
+            return true;
+        }
+
+        ///
+        /// \brief Transfers next EEPROM_TRANSFER_STEP records from active page if the transfer is in progress.
+        ///
+        void update()
+        {
+            if (state != state_t::copying)
+                return;
+
+            if (!flash.beginBatch())
+                return;
+
+            copy(EEPROM_TRANSFER_STEP);
+            flash.endBatch();
+        }
+
+        ///
+        /// \brief Transfers all the remaining records, erases old page and marks the new one as valid.
+        /// Blocks until the page is erased.
+        ///
+        bool completeTransfer()
+        {
+            if ((state == state_t::copying) && !copy(transferCursor))
+                return false;
+
+            if (state != state_t::erasePending)
+                return true;
+
+            if (!flash.erasePage(activePage))
+                return false;
+
+            if (!setStatus(otherPage(), EmuEEPROM::pageStatus_t::valid))
+                return false;
+
+            activePage           = otherPage();
+            activeRecords        = targetRecords;
+            state                = state_t::idle;
+            lastTransferDuration = core::timing::currentRunTimeMs() - transferStartTime;
+            updateThreshold();
+
+            return true;
+        }
+
+        bool isErasePending()
+        {
+            return state == state_t::erasePending;
+        }
+
+        uint8_t usage()
+        {
+            uint32_t records = (state == state_t::idle) ? activeRecords : targetRecords;
+            return (records * 100) / NUMBER_OF_RECORDS;
+        }
+
+        uint32_t lastTransferTime()
+        {
+            return lastTransferDuration;
+        }
+
+        private:
+        enum class state_t : uint8_t
+        {
+            idle,
+            copying,
+            erasePending
+        };
+
+        page_t otherPage()
+        {
+            return activePage == page_t::page1 ? page_t::page2 : page_t::page1;
+        }
+
+        uint32_t recordAddress(page_t page, uint32_t index)
+        {
+            //first word is used for page status
+            return flash.startAddress(page) + 4 + (index * 4);
+        }
+
+        bool setStatus(page_t page, EmuEEPROM::pageStatus_t status)
+        {
+            return flash.write32(flash.startAddress(page), static_cast<uint32_t>(status));
+        }
+
+        uint32_t countRecords(page_t page)
+        {
+            uint32_t record;
+
+            for (uint32_t i = 0; i < NUMBER_OF_RECORDS; i++)
+            {
+                flash.read32(recordAddress(page, i), record);
+
+                if (record == 0xFFFFFFFF)
+                    return i;
+            }
+
+            return NUMBER_OF_RECORDS;
+        }
+
+        bool isErased(page_t page)
+        {
+            uint32_t data;
+
+            for (uint32_t address = flash.startAddress(page); address < flash.startAddress(page) + EEPROM_PAGE_SIZE; address += 4)
+            {
+                flash.read32(address, data);
+
+                if (data != 0xFFFFFFFF)
+                    return false;
+            }
+
+            return true;
+        }
+
+        bool append(page_t page, uint32_t& records, uint32_t address, uint16_t data)
+        {
+            if (records >= NUMBER_OF_RECORDS)
+                return false;
+
+            //skip the record even if the write fails since it isn't erased anymore
+            return flash.write32(recordAddress(page, records++), (address << 16) | data);
+        }
+
+        bool startTransfer()
+        {
+            if (!setStatus(otherPage(), EmuEEPROM::pageStatus_t::receiving))
+                return false;
+
+            targetRecords = 0;
+            beginTransfer();
+
+            return true;
+        }
+
+        void beginTransfer()
+        {
+            for (size_t i = 0; i < sizeof(copied) / sizeof(copied[0]); i++)
+                copied[i] = 0;
+
+            transferCursor    = activeRecords;
+            transferStartTime = core::timing::currentRunTimeMs();
+            state             = state_t::copying;
+        }
+
+        ///
+        /// \brief Copies latest values from specified amount of records to the new page.
+        /// Active page is processed from the end so that only the first found record
+        /// for each address needs to be copied.
+        ///
+        bool copy(uint32_t amount)
+        {
+            uint32_t record;
+
+            while (amount && transferCursor)
+            {
+                amount--;
+                flash.read32(recordAddress(activePage, --transferCursor), record);
+
+                uint32_t address = record >> 16;
+
+                if ((address >= NUMBER_OF_RECORDS) || isCopied(address))
+                    continue;
+
+                if (!append(otherPage(), targetRecords, address, record & 0xFFFF))
+                {
+                    //process the same record again next time
+                    transferCursor++;
+                    return false;
+                }
+
+                setCopied(address);
+            }
+
+            if (!transferCursor)
+                state = state_t::erasePending;
+
+            return true;
+        }
+
+        bool isCopied(uint32_t address)
+        {
+            return copied[address / 32] & (static_cast<uint32_t>(1) << (address % 32));
+        }
+
+        void setCopied(uint32_t address)
+        {
+            copied[address / 32] |= static_cast<uint32_t>(1) << (address % 32);
+        }
+
+        ///
+        /// \brief Sets the amount of records in active page after which the transfer is started.
+        /// If the page is already filled over threshold after the transfer, next one is
+        /// started after half of the remaining space is used.
+        ///
+        void updateThreshold()
+        {
+            transferThreshold = (NUMBER_OF_RECORDS * EEPROM_TRANSFER_THRESHOLD) / 100;
+
+            if (activeRecords >= transferThreshold)
+                transferThreshold = activeRecords + ((NUMBER_OF_RECORDS - activeRecords) / 2);
+        }
+
+        STM32F4EEPROM& flash;
+        page_t         activePage           = page_t::page1;
+        uint32_t       activeRecords        = 0;
+        uint32_t       targetRecords        = 0;
+        uint32_t       transferThreshold    = 0;
+        uint32_t       transferCursor       = 0;
+        uint32_t       transferStartTime    = 0;
+        uint32_t       lastTransferDuration = 0;
+        state_t        state                = state_t::idle;
+
+        ///
+        /// \brief Bitmap of addresses which have already been written to the new page during the transfer.
+        ///
+        uint32_t copied[(NUMBER_OF_RECORDS + 31) / 32] = {};
     };
 
 #ifdef EEPROM_RAM_CACHE
     ///
     /// \brief Memory array stored in RAM holding all the values stored in virtual EEPROM.
-    /// Used to avoid constant lookups in the flash.
+    /// Filled from flash once on init, so that flash is accessed only when writing.
+    /// Variables which aren't stored in flash at all have the value 0, same as cleared
+    /// memory on other boards, so values equal to 0 are written to flash only when
+    /// they change some other stored value.
     ///
     uint16_t eepromMemory[(EEPROM_SIZE / 4) - 1];
+
+    ///
+    /// \brief Bitmap of addresses for which a value has been stored in flash or queued for it.
+    /// Used to tell variables which read as 0 because they aren't stored at all apart
+    /// from the ones which have 0 stored explicitly.
+    ///
+    uint32_t validMemory[(sizeof(eepromMemory) / sizeof(eepromMemory[0]) + 31) / 32];
+
+    ///
+    /// \brief Bitmap of values which have been written to RAM cache only.
+    /// These values are written to flash in a single batch once Board::eeprom::flush is called.
+    ///
+    uint32_t dirtyMemory[(sizeof(eepromMemory) / sizeof(eepromMemory[0]) + 31) / 32];
+
+    ///
+    /// \brief Total number of values waiting to be written to flash.
+    ///
+    size_t dirtyCount;
+
+    bool isDirty(uint32_t address)
+    {
+        return dirtyMemory[address / 32] & (static_cast<uint32_t>(1) << (address % 32));
+    }
+
+    bool isValid(uint32_t address)
+    {
+        return validMemory[address / 32] & (static_cast<uint32_t>(1) << (address % 32));
+    }
 #endif
 
     STM32F4EEPROM stm32EEPROM(Board::detail::map::eepromFlashPage1(),
                               Board::detail::map::eepromFlashPage2(),
                               EEPROM_SIZE);
 
-    EmuEEPROM emuEEPROM(stm32EEPROM);
-}    // namespace
+    PageStorage pageStorage(stm32EEPROM);
+
+    ///
+    /// \brief Writes all the values held only in RAM cache to flash.
+    ///
+    bool flushValues()
+    {
+        if (!stm32EEPROM.beginBatch())
+            return false;
 
+        bool result = true;
+
+        for (size_t i = 0; i < sizeof(dirtyMemory) / sizeof(dirtyMemory[0]); i++)
+        {
+            //skip 32 clean values at once
+            if (!dirtyMemory[i])
+                continue;
+
+            for (size_t bit = 0; bit < 32; bit++)
+            {
+                if (!(dirtyMemory[i] & (static_cast<uint32_t>(1) << bit)))
+                    continue;
+
+                uint32_t address = (i * 32) + bit;
+
+                if (!pageStorage.write(address, eepromMemory[address]))
+                {
+                    //keep the value in queue and try again on next flush
+                    result = false;
+                    continue;
+                }
+
+                dirtyMemory[i] &= ~(static_cast<uint32_t>(1) << bit);
+                dirtyCount--;
+            }
+        }
+
+        stm32EEPROM.endBatch();
+        return result;
+    }
+}    // namespace
 namespace Board
 {
     namespace eeprom
@@ -152,38 +646,20 @@ namespace Board
 
         void init()
         {
-            emuEEPROM.init();
-
-            for (size_t i = 0; i < (EEPROM_SIZE / 4) - 1; i++)
-                eepromMemory[i] = 0xFFFF;
+            pageStorage.init();
+            pageStorage.load(eepromMemory, validMemory);
         }
 
         bool read(uint32_t address, int32_t& value, LESSDB::sectionParameterType_t type)
         {
-            uint16_t tempData;
-
             switch (type)
             {
             case LESSDB::sectionParameterType_t::bit:
             case LESSDB::sectionParameterType_t::byte:
             case LESSDB::sectionParameterType_t::halfByte:
             case LESSDB::sectionParameterType_t::word:
-                if (eepromMemory[address] != 0xFFFF)
-                {
-                    value = eepromMemory[address];
-                }
-                else
-                {
-                    if (emuEEPROM.read(address, tempData) != EmuEEPROM::readStatus_t::ok)
-                    {
-                        return false;
-                    }
-                    else
-                    {
-                        value                 = tempData;
-                        eepromMemory[address] = tempData;
-                    }
-                }
+                //all the values are loaded to RAM on init
+                value = eepromMemory[address];
                 break;
 
             default:
@@ -196,18 +672,29 @@ namespace Board
 
         bool write(uint32_t address, int32_t value, LESSDB::sectionParameterType_t type)
         {
-            uint16_t tempData;
-
             switch (type)
             {
             case LESSDB::sectionParameterType_t::bit:
             case LESSDB::sectionParameterType_t::byte:
             case LESSDB::sectionParameterType_t::halfByte:
             case LESSDB::sectionParameterType_t::word:
-                tempData              = value;
+                //value already stored, either in flash or in the queue for it
+                if (isValid(address) && (eepromMemory[address] == static_cast<uint16_t>(value)))
+                    return true;
+
+                //no need to store 0 for variables which aren't stored, these read as 0 anyway
+                if (!isValid(address) && !value)
+                    return true;
+
+                //write to RAM only, the value is written to flash on next flush
                 eepromMemory[address] = value;
-                if (emuEEPROM.write(address, tempData) != EmuEEPROM::writeStatus_t::ok)
-                    return false;
+                validMemory[address / 32] |= static_cast<uint32_t>(1) << (address % 32);
+
+                if (!isDirty(address))
+                {
+                    dirtyMemory[address / 32] |= static_cast<uint32_t>(1) << (address % 32);
+                    dirtyCount++;
+                }
                 break;
 
             default:
@@ -218,10 +705,56 @@ namespace Board
             return true;
         }
 
+        bool flush()
+        {
+            bool result = true;
+
+            if (dirtyCount)
+                result = flushValues();
+
+            //flash can't be read while it's being erased so old page is erased only here
+            if (pageStorage.isErasePending() && !pageStorage.completeTransfer())
+                result = false;
+
+            return result;
+        }
+
+        bool isFlushPending()
+        {
+            return (dirtyCount != 0) || pageStorage.isErasePending();
+        }
+
+        void update()
+        {
+            pageStorage.update();
+        }
+
+        uint8_t usage()
+        {
+            return pageStorage.usage();
+        }
+
+        uint32_t lastTransferTime()
+        {
+            return pageStorage.lastTransferTime();
+        }
+
         void clear(uint32_t start, uint32_t end)
         {
             //ignore start/end markers on stm32 for now
-            emuEEPROM.format();
+            pageStorage.format();
+
+            //formatted flash holds no values, drop everything which hasn't been written yet
+            for (size_t i = 0; i < (EEPROM_SIZE / 4) - 1; i++)
+                eepromMemory[i] = 0;
+
+            for (size_t i = 0; i < sizeof(dirtyMemory) / sizeof(dirtyMemory[0]); i++)
+            {
+                validMemory[i] = 0;
+                dirtyMemory[i] = 0;
+            }
+
+            dirtyCount = 0;
         }
 
         size_t paramUsage(LESSDB::sectionParameterType_t type)
@@ -240,4 +773,4 @@ namespace Board
             }
         }
     }    // namespace eeprom
-}    // namespace Board
\ No newline at end of file
+}    // namespace Board
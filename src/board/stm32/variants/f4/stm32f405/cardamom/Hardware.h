@@ -44,6 +44,11 @@ limitations under the License.
 ///
 #define UART_INTERFACES                 1
 
+///
+/// \brief Use DMA for UART transfers.
+///
+#define UART_DMA
+
 ///
 /// \brief Constant used to debounce button readings.
 ///
@@ -171,6 +171,17 @@ namespace Board
 
                     const IRQn_Type _irqn = USART1_IRQn;
                 } _uartDescriptor0;
+
+#ifdef UART_DMA
+                DMAstreams_t uartDMA0 = {
+                    .txStream  = DMA2_Stream7,
+                    .txChannel = DMA_CHANNEL_4,
+                    .txIrqn    = DMA2_Stream7_IRQn,
+                    .rxStream  = DMA2_Stream2,
+                    .rxChannel = DMA_CHANNEL_4,
+                    .rxIrqn    = DMA2_Stream2_IRQn,
+                };
+#endif
             }    // namespace
 
             uint8_t muxChannel(uint8_t index)
@@ -213,6 +224,14 @@ namespace Board
                 return returnValue;
             }
 
+#ifdef UART_DMA
+            DMAstreams_t& uartDMA(uint8_t channel)
+            {
+                //only one uart
+                return uartDMA0;
+            }
+#endif
+
             ADC_TypeDef* adcInterface()
             {
                 return ADC1;
@@ -23,7 +23,6 @@ limitations under the License.
 #include "board/common/io/Helpers.h"
 #include "core/src/general/IO.h"
 #include "core/src/general/Atomic.h"
-#include "core/src/general/ADC.h"
 #include "core/src/general/Timing.h"
 
 namespace
@@ -41,11 +40,18 @@ extern "C" void USART1_IRQHandler(void)
     Board::detail::isrHandling::uart(0);
 }
 
-extern "C" void ADC_IRQHandler(void)
+#ifdef UART_DMA
+extern "C" void DMA2_Stream7_IRQHandler(void)
 {
-    Board::detail::isrHandling::adc(hadc1.Instance->DR);
+    Board::detail::isrHandling::uartDMAtx(0);
+}
+
+extern "C" void DMA2_Stream2_IRQHandler(void)
+{
+    Board::detail::isrHandling::uartDMArx(0);
 }
 #endif
+#endif
 
 extern "C" void TIM7_IRQHandler(void)
 {
@@ -127,29 +133,26 @@ namespace Board
                 hadc1.Instance                   = ADC1;
                 hadc1.Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV4;
                 hadc1.Init.Resolution            = ADC_RESOLUTION_12B;
-                hadc1.Init.ScanConvMode          = DISABLE;
+                hadc1.Init.ScanConvMode          = ENABLE;
                 hadc1.Init.ContinuousConvMode    = DISABLE;
                 hadc1.Init.DiscontinuousConvMode = DISABLE;
-                hadc1.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
-                hadc1.Init.ExternalTrigConv      = ADC_SOFTWARE_START;
+                hadc1.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+                hadc1.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T8_CC1;
                 hadc1.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
-                hadc1.Init.NbrOfConversion       = 1;
-                hadc1.Init.DMAContinuousRequests = DISABLE;
-                hadc1.Init.EOCSelection          = ADC_EOC_SINGLE_CONV;
+                hadc1.Init.NbrOfConversion       = NUMBER_OF_MUX;
+                hadc1.Init.DMAContinuousRequests = ENABLE;
+                hadc1.Init.EOCSelection          = ADC_EOC_SEQ_CONV;
                 HAL_ADC_Init(&hadc1);
 
                 for (int i = 0; i < NUMBER_OF_MUX; i++)
                 {
                     sConfig.Channel      = map::adcChannel(i);
-                    sConfig.Rank         = 1;
+                    sConfig.Rank         = i + 1;
                     sConfig.SamplingTime = ADC_SAMPLETIME_480CYCLES;
                     HAL_ADC_ConfigChannel(&hadc1, &sConfig);
                 }
 
-                //set first channel
-                core::adc::setChannel(map::adcChannel(0));
-
-                HAL_ADC_Start_IT(&hadc1);
+                adcScan(hadc1);
             }
 
             void timers()
@@ -54,6 +54,11 @@ limitations under the License.
 ///
 #define UART_MIDI_CHANNEL               0
 
+///
+/// \brief Use DMA for UART transfers.
+///
+#define UART_DMA
+
 ///
 /// \brief Constant used to debounce button readings.
 ///
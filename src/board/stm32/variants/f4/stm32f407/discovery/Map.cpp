@@ -282,6 +282,17 @@ namespace Board
 
                     const IRQn_Type _irqn = USART3_IRQn;
                 } _uartDescriptor0;
+
+#ifdef UART_DMA
+                DMAstreams_t uartDMA0 = {
+                    .txStream  = DMA1_Stream3,
+                    .txChannel = DMA_CHANNEL_4,
+                    .txIrqn    = DMA1_Stream3_IRQn,
+                    .rxStream  = DMA1_Stream1,
+                    .rxChannel = DMA_CHANNEL_4,
+                    .rxIrqn    = DMA1_Stream1_IRQn,
+                };
+#endif
             }    // namespace
 
             uint32_t adcChannel(uint8_t index)
@@ -324,6 +335,14 @@ namespace Board
                 return returnValue;
             }
 
+#ifdef UART_DMA
+            DMAstreams_t& uartDMA(uint8_t channel)
+            {
+                //only one uart
+                return uartDMA0;
+            }
+#endif
+
             ADC_TypeDef* adcInterface()
             {
                 return ADC1;
@@ -0,0 +1,260 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "Pins.h"
+#include "board/Internal.h"
+#include "board/stm32/variants/f4/eeprom/Constants.h"
+
+namespace Board
+{
+    namespace detail
+    {
+        namespace map
+        {
+            namespace
+            {
+                const uint32_t aInChannels[MAX_NUMBER_OF_ANALOG] = {
+                    ADC_CHANNEL_1,
+                    ADC_CHANNEL_2,
+                    ADC_CHANNEL_3,
+                    ADC_CHANNEL_8,
+                    ADC_CHANNEL_9,
+                    ADC_CHANNEL_11,
+                    ADC_CHANNEL_12,
+                    ADC_CHANNEL_14,
+                };
+
+                EmuEEPROM::StorageAccess::pageDescriptor_t flashPage1 = {
+                    .startAddress = EEPROM_PAGE1_START_ADDRESS,
+                    .sector       = EEPROM_PAGE1_SECTOR
+                };
+
+                EmuEEPROM::StorageAccess::pageDescriptor_t flashPage2 = {
+                    .startAddress = EEPROM_PAGE2_START_ADDRESS,
+                    .sector       = EEPROM_PAGE2_SECTOR
+                };
+
+                class UARTdescriptor0 : public Board::detail::map::STMPeripheral
+                {
+                    public:
+                    UARTdescriptor0() {}
+
+                    std::vector<core::io::mcuPin_t> pins() override
+                    {
+                        return _pins;
+                    }
+
+                    void* interface() override
+                    {
+                        return USART3;
+                    }
+
+                    IRQn_Type irqn() override
+                    {
+                        return _irqn;
+                    }
+
+                    void enableClock() override
+                    {
+                        __HAL_RCC_USART3_CLK_ENABLE();
+                    }
+
+                    void disableClock() override
+                    {
+                        __HAL_RCC_USART3_CLK_DISABLE();
+                    }
+
+                    private:
+                    std::vector<core::io::mcuPin_t> _pins = {
+                        {
+                            .port      = UART_0_RX_PORT,
+                            .index     = UART_0_RX_PIN,
+                            .mode      = core::io::pinMode_t::alternatePP,
+                            .pull      = core::io::pullMode_t::none,
+                            .speed     = core::io::gpioSpeed_t::veryHigh,
+                            .alternate = GPIO_AF7_USART3,
+                        },
+
+                        {
+                            .port      = UART_0_TX_PORT,
+                            .index     = UART_0_TX_PIN,
+                            .mode      = core::io::pinMode_t::alternatePP,
+                            .pull      = core::io::pullMode_t::none,
+                            .speed     = core::io::gpioSpeed_t::veryHigh,
+                            .alternate = GPIO_AF7_USART3,
+                        },
+                    };
+
+                    const IRQn_Type _irqn = USART3_IRQn;
+                } _uartDescriptor0;
+
+                class SRSPIdescriptor : public Board::detail::map::STMPeripheral
+                {
+                    public:
+                    SRSPIdescriptor() {}
+
+                    std::vector<core::io::mcuPin_t> pins() override
+                    {
+                        return _pins;
+                    }
+
+                    void* interface() override
+                    {
+                        return SPI1;
+                    }
+
+                    IRQn_Type irqn() override
+                    {
+                        return _irqn;
+                    }
+
+                    void enableClock() override
+                    {
+                        __HAL_RCC_SPI1_CLK_ENABLE();
+                    }
+
+                    void disableClock() override
+                    {
+                        __HAL_RCC_SPI1_CLK_DISABLE();
+                    }
+
+                    private:
+                    std::vector<core::io::mcuPin_t> _pins = {
+                        {
+                            .port      = SR_SPI_SCK_PORT,
+                            .index     = SR_SPI_SCK_PIN,
+                            .mode      = core::io::pinMode_t::alternatePP,
+                            .pull      = core::io::pullMode_t::none,
+                            .speed     = core::io::gpioSpeed_t::veryHigh,
+                            .alternate = GPIO_AF5_SPI1,
+                        },
+
+                        {
+                            .port      = SR_SPI_MISO_PORT,
+                            .index     = SR_SPI_MISO_PIN,
+                            .mode      = core::io::pinMode_t::alternatePP,
+                            .pull      = core::io::pullMode_t::none,
+                            .speed     = core::io::gpioSpeed_t::veryHigh,
+                            .alternate = GPIO_AF5_SPI1,
+                        },
+
+                        {
+                            .port      = SR_SPI_MOSI_PORT,
+                            .index     = SR_SPI_MOSI_PIN,
+                            .mode      = core::io::pinMode_t::alternatePP,
+                            .pull      = core::io::pullMode_t::none,
+                            .speed     = core::io::gpioSpeed_t::veryHigh,
+                            .alternate = GPIO_AF5_SPI1,
+                        },
+                    };
+
+                    const IRQn_Type _irqn = SPI1_IRQn;
+                } _srSPIDescriptor;
+
+                //DMA2 stream 0 is used by ADC and DMA1 stream 3 by UART: use the remaining SPI1 streams
+                DMAstreams_t srSPIDMA0 = {
+                    .txStream  = DMA2_Stream3,
+                    .txChannel = DMA_CHANNEL_3,
+                    .txIrqn    = DMA2_Stream3_IRQn,
+                    .rxStream  = DMA2_Stream2,
+                    .rxChannel = DMA_CHANNEL_3,
+                    .rxIrqn    = DMA2_Stream2_IRQn,
+                };
+
+#ifdef UART_DMA
+                DMAstreams_t uartDMA0 = {
+                    .txStream  = DMA1_Stream3,
+                    .txChannel = DMA_CHANNEL_4,
+                    .txIrqn    = DMA1_Stream3_IRQn,
+                    .rxStream  = DMA1_Stream1,
+                    .rxChannel = DMA_CHANNEL_4,
+                    .rxIrqn    = DMA1_Stream1_IRQn,
+                };
+#endif
+            }    // namespace
+
+            uint32_t adcChannel(uint8_t index)
+            {
+                return aInChannels[index];
+            }
+
+            STMPeripheral* uartDescriptor(uint8_t channel)
+            {
+                if (channel >= UART_INTERFACES)
+                    return nullptr;
+
+                //only one uart
+                return &_uartDescriptor0;
+            }
+
+            bool uartChannel(USART_TypeDef* interface, uint8_t& channel)
+            {
+                bool returnValue = true;
+
+                if (interface == USART3)
+                {
+                    channel = 0;
+                }
+                else
+                {
+                    returnValue = false;
+                }
+
+                return returnValue;
+            }
+
+            STMPeripheral* srSPIDescriptor()
+            {
+                return &_srSPIDescriptor;
+            }
+
+            DMAstreams_t& srSPIDMA()
+            {
+                return srSPIDMA0;
+            }
+
+#ifdef UART_DMA
+            DMAstreams_t& uartDMA(uint8_t channel)
+            {
+                //only one uart
+                return uartDMA0;
+            }
+#endif
+
+            ADC_TypeDef* adcInterface()
+            {
+                return ADC1;
+            }
+
+            TIM_TypeDef* mainTimerInstance()
+            {
+                return TIM7;
+            }
+
+            EmuEEPROM::StorageAccess::pageDescriptor_t& eepromFlashPage1()
+            {
+                return flashPage1;
+            }
+
+            EmuEEPROM::StorageAccess::pageDescriptor_t& eepromFlashPage2()
+            {
+                return flashPage2;
+            }
+        }    // namespace map
+    }        // namespace detail
+}    // namespace Board
\ No newline at end of file
@@ -0,0 +1,88 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#pragma once
+
+#include "stm32f4xx_hal.h"
+
+#define SR_SPI_SCK_PORT         GPIOB
+#define SR_SPI_SCK_PIN          GPIO_PIN_3
+
+#define SR_SPI_MISO_PORT        GPIOB
+#define SR_SPI_MISO_PIN         GPIO_PIN_4
+
+#define SR_SPI_MOSI_PORT        GPIOB
+#define SR_SPI_MOSI_PIN         GPIO_PIN_5
+
+#define SR_DIN_LATCH_PORT       GPIOE
+#define SR_DIN_LATCH_PIN        GPIO_PIN_7
+
+#define SR_OUT_LATCH_PORT       GPIOE
+#define SR_OUT_LATCH_PIN        GPIO_PIN_9
+
+
+#define AI_1_PORT               GPIOA
+#define AI_1_PIN                GPIO_PIN_1
+
+#define AI_2_PORT               GPIOA
+#define AI_2_PIN                GPIO_PIN_2
+
+#define AI_3_PORT               GPIOA
+#define AI_3_PIN                GPIO_PIN_3
+
+#define AI_4_PORT               GPIOB
+#define AI_4_PIN                GPIO_PIN_0
+
+#define AI_5_PORT               GPIOB
+#define AI_5_PIN                GPIO_PIN_1
+
+#define AI_6_PORT               GPIOC
+#define AI_6_PIN                GPIO_PIN_1
+
+#define AI_7_PORT               GPIOC
+#define AI_7_PIN                GPIO_PIN_2
+
+#define AI_8_PORT               GPIOC
+#define AI_8_PIN                GPIO_PIN_4
+
+
+#define LED_MIDI_IN_DIN_PORT    GPIOD
+#define LED_MIDI_IN_DIN_PIN     GPIO_PIN_15
+
+#define LED_MIDI_OUT_DIN_PORT   GPIOD
+#define LED_MIDI_OUT_DIN_PIN    GPIO_PIN_13
+
+#define LED_MIDI_IN_USB_PORT    GPIOD
+#define LED_MIDI_IN_USB_PIN     GPIO_PIN_14
+
+#define LED_MIDI_OUT_USB_PORT   GPIOD
+#define LED_MIDI_OUT_USB_PIN    GPIO_PIN_12
+
+
+#define UART_0_RX_PORT          GPIOB
+#define UART_0_RX_PIN           GPIO_PIN_11
+
+#define UART_0_TX_PORT          GPIOD
+#define UART_0_TX_PIN           GPIO_PIN_8
+
+
+#define I2C_SDA_PORT            GPIOC
+#define I2C_SDA_PIN             GPIO_PIN_9
+
+#define I2C_SDL_PORT            GPIOA
+#define I2C_SDL_PIN             GPIO_PIN_8
@@ -0,0 +1,201 @@
+/*
+
+Copyright 2015-2020 Igor Petrovic
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+
+*/
+
+#include "board/Board.h"
+#include "board/Internal.h"
+#include "Pins.h"
+#include "board/Internal.h"
+#include "board/common/io/Helpers.h"
+#include "core/src/general/IO.h"
+#include "core/src/general/Atomic.h"
+#include "core/src/general/Timing.h"
+
+namespace
+{
+    TIM_HandleTypeDef htim7;
+    ADC_HandleTypeDef hadc1;
+}    // namespace
+
+//UART3 on this board maps to UART channel 0 in application
+
+#ifdef FW_APP
+//not needed in bootloader
+extern "C" void USART3_IRQHandler(void)
+{
+    Board::detail::isrHandling::uart(0);
+}
+
+#ifdef UART_DMA
+extern "C" void DMA1_Stream3_IRQHandler(void)
+{
+    Board::detail::isrHandling::uartDMAtx(0);
+}
+
+extern "C" void DMA1_Stream1_IRQHandler(void)
+{
+    Board::detail::isrHandling::uartDMArx(0);
+}
+#endif
+
+extern "C" void DMA2_Stream3_IRQHandler(void)
+{
+    Board::detail::isrHandling::srDMAtx();
+}
+
+extern "C" void DMA2_Stream2_IRQHandler(void)
+{
+    Board::detail::isrHandling::srDMArx();
+}
+#endif
+
+extern "C" void TIM7_IRQHandler(void)
+{
+    __HAL_TIM_CLEAR_IT(&htim7, TIM_IT_UPDATE);
+    Board::detail::isrHandling::mainTimer();
+}
+
+namespace Board
+{
+    namespace detail
+    {
+        namespace setup
+        {
+            void clocks()
+            {
+                RCC_OscInitTypeDef RCC_OscInitStruct = { 0 };
+                RCC_ClkInitTypeDef RCC_ClkInitStruct = { 0 };
+
+                /* Configure the main internal regulator output voltage */
+                __HAL_RCC_PWR_CLK_ENABLE();
+                __HAL_PWR_VOLTAGESCALING_CONFIG(PWR_REGULATOR_VOLTAGE_SCALE1);
+
+                /* Initializes the CPU, AHB and APB busses clocks */
+                RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+                RCC_OscInitStruct.HSEState       = RCC_HSE_BYPASS;
+                RCC_OscInitStruct.PLL.PLLState   = RCC_PLL_ON;
+                RCC_OscInitStruct.PLL.PLLSource  = RCC_PLLSOURCE_HSE;
+                RCC_OscInitStruct.PLL.PLLM       = 4;
+                RCC_OscInitStruct.PLL.PLLN       = 168;
+                RCC_OscInitStruct.PLL.PLLP       = RCC_PLLP_DIV2;
+                RCC_OscInitStruct.PLL.PLLQ       = 7;
+
+                if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
+                    Board::detail::errorHandler();
+
+                /* Initializes the CPU, AHB and APB busses clocks */
+                RCC_ClkInitStruct.ClockType      = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+                RCC_ClkInitStruct.SYSCLKSource   = RCC_SYSCLKSOURCE_PLLCLK;
+                RCC_ClkInitStruct.AHBCLKDivider  = RCC_SYSCLK_DIV2;
+                RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
+                RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV2;
+
+                if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
+                    Board::detail::errorHandler();
+            }
+
+            void io()
+            {
+                //SPI pins are configured once the peripheral is initialized
+                CORE_IO_CONFIG({ SR_DIN_LATCH_PORT, SR_DIN_LATCH_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_HIGH(SR_DIN_LATCH_PORT, SR_DIN_LATCH_PIN);
+
+                CORE_IO_CONFIG({ SR_OUT_LATCH_PORT, SR_OUT_LATCH_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_HIGH(SR_OUT_LATCH_PORT, SR_OUT_LATCH_PIN);
+
+                CORE_IO_CONFIG({ AI_1_PORT, AI_1_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_1_PORT, AI_1_PIN);
+
+                CORE_IO_CONFIG({ AI_2_PORT, AI_2_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_2_PORT, AI_2_PIN);
+
+                CORE_IO_CONFIG({ AI_3_PORT, AI_3_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_3_PORT, AI_3_PIN);
+
+                CORE_IO_CONFIG({ AI_4_PORT, AI_4_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_4_PORT, AI_4_PIN);
+
+                CORE_IO_CONFIG({ AI_5_PORT, AI_5_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_5_PORT, AI_5_PIN);
+
+                CORE_IO_CONFIG({ AI_6_PORT, AI_6_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_6_PORT, AI_6_PIN);
+
+                CORE_IO_CONFIG({ AI_7_PORT, AI_7_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_7_PORT, AI_7_PIN);
+
+                CORE_IO_CONFIG({ AI_8_PORT, AI_8_PIN, core::io::pinMode_t::analog, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                CORE_IO_SET_LOW(AI_8_PORT, AI_8_PIN);
+
+                CORE_IO_CONFIG({ LED_MIDI_IN_DIN_PORT, LED_MIDI_IN_DIN_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                INT_LED_OFF(LED_MIDI_IN_DIN_PORT, LED_MIDI_IN_DIN_PIN);
+
+                CORE_IO_CONFIG({ LED_MIDI_OUT_DIN_PORT, LED_MIDI_OUT_DIN_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                INT_LED_OFF(LED_MIDI_OUT_DIN_PORT, LED_MIDI_OUT_DIN_PIN);
+
+                CORE_IO_CONFIG({ LED_MIDI_IN_USB_PORT, LED_MIDI_IN_USB_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                INT_LED_OFF(LED_MIDI_IN_USB_PORT, LED_MIDI_IN_USB_PIN);
+
+                CORE_IO_CONFIG({ LED_MIDI_OUT_USB_PORT, LED_MIDI_OUT_USB_PIN, core::io::pinMode_t::outputPP, core::io::pullMode_t::none, core::io::gpioSpeed_t::medium, 0x00 });
+                INT_LED_OFF(LED_MIDI_OUT_USB_PORT, LED_MIDI_OUT_USB_PIN);
+            }
+
+            void adc()
+            {
+                ADC_ChannelConfTypeDef sConfig = { 0 };
+
+                hadc1.Instance                   = ADC1;
+                hadc1.Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV2;
+                hadc1.Init.Resolution            = ADC_RESOLUTION_12B;
+                hadc1.Init.ScanConvMode          = ENABLE;
+                hadc1.Init.ContinuousConvMode    = DISABLE;
+                hadc1.Init.DiscontinuousConvMode = DISABLE;
+                hadc1.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_RISING;
+                hadc1.Init.ExternalTrigConv      = ADC_EXTERNALTRIGCONV_T8_TRGO;
+                hadc1.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
+                hadc1.Init.NbrOfConversion       = MAX_NUMBER_OF_ANALOG;
+                hadc1.Init.DMAContinuousRequests = ENABLE;
+                hadc1.Init.EOCSelection          = ADC_EOC_SEQ_CONV;
+                HAL_ADC_Init(&hadc1);
+
+                for (int i = 0; i < MAX_NUMBER_OF_ANALOG; i++)
+                {
+                    sConfig.Channel      = map::adcChannel(i);
+                    sConfig.Rank         = i + 1;
+                    sConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
+                    HAL_ADC_ConfigChannel(&hadc1, &sConfig);
+                }
+
+                adcScan(hadc1);
+            }
+
+            void timers()
+            {
+                htim7.Instance               = TIM7;
+                htim7.Init.Prescaler         = 0;
+                htim7.Init.CounterMode       = TIM_COUNTERMODE_UP;
+                htim7.Init.Period            = 41999;
+                htim7.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
+                htim7.Init.RepetitionCounter = 0;
+                htim7.Init.AutoReloadPreload = 0;
+                HAL_TIM_Base_Init(&htim7);
+
+                HAL_TIM_Base_Start_IT(&htim7);
+            }
+        }    // namespace setup
+    }        // namespace detail
+}    // namespace Board
\ No newline at end of file
@@ -15,13 +15,24 @@ See the License for the specific language governing permissions and
 limitations under the License.
 
 */
-
 #ifdef UART_INTERFACES
 #if UART_INTERFACES > 0
 
 #include "OpenDeckMIDIformat.h"
 #include "board/Board.h"
 
+//Two formats are supported on each channel.
+//Legacy format uses 6 bytes for every event: packet type, 4 bytes of USB MIDI event and XOR of event bytes.
+//Framed format packs up to OD_FORMAT_FRAME_EVENTS events of the same packet type into a single frame:
+//packet type, 4 bytes for each event and CRC-8 of all previous bytes, COBS encoded and terminated with 0x00.
+//Since 0x00 can only appear as frame delimiter, parser resynchronizes on the first delimiter after corrupted data.
+//Both sides start with legacy format. Framed format is used in one direction only after the receiving side
+//has confirmed it with framingEnable command, which is always sent in legacy format. When legacy internal
+//command is received while framed format is used, the other side has restarted: both directions fall back
+//to legacy format until the framing is negotiated again.
+//Once framed format is used, each side grants credit to the other one as it reads the events, starting
+//with OD_FORMAT_CREDIT_WINDOW events. Sender which can delay its events checks the credit with canWrite.
+
 namespace OpenDeckMIDIformat
 {
     namespace
@@ -39,9 +50,96 @@ namespace OpenDeckMIDIformat
             dataXor
         };
 
-        uint8_t incomingBytesCount = 0;
-        uint8_t readBytes[6]       = {};
-        uint8_t tempArray[5];
+        constexpr uint8_t LEGACY_PACKET_SIZE = 6;
+        constexpr uint8_t EVENT_SIZE         = 4;
+        constexpr uint8_t FRAME_SIZE         = 1 + (OD_FORMAT_FRAME_EVENTS * EVENT_SIZE) + 1;
+        constexpr uint8_t FRAME_DELIMITER    = 0x00;
+        constexpr uint8_t CRC8_POLYNOMIAL    = 0x07;
+
+        static_assert((1 + (OD_FORMAT_FRAME_EVENTS * EVENT_SIZE) + 1) < 254, "Frame must fit into single COBS block.");
+
+        typedef struct
+        {
+            bool txFramed;
+            bool rxFramed;
+
+            ///
+            /// \brief Number of events which the other side can still receive.
+            ///
+            uint8_t txCredit;
+
+            ///
+            /// \brief Number of events read since the last credit has been granted.
+            ///
+            uint8_t rxConsumed;
+
+            stats_t localStats;
+            stats_t remoteStats;
+            stats_t reportedStats;
+
+            ///
+            /// \brief Events queued for next frame.
+            /// @{
+
+            packetType_t txType;
+            uint8_t      txEvents;
+            uint8_t      txData[OD_FORMAT_FRAME_EVENTS * EVENT_SIZE];
+
+            /// @}
+
+            ///
+            /// \brief Frame decoding state.
+            /// rxData holds decoded packet type, events and CRC.
+            /// @{
+
+            uint8_t rxData[FRAME_SIZE];
+            uint8_t rxSize;
+            uint8_t rxCode;
+            uint8_t rxBlockRemaining;
+            uint8_t rxCRC;
+            bool    rxDiscard;
+
+            /// @}
+
+            ///
+            /// \brief Decoded events which haven't been read yet.
+            /// @{
+
+            uint8_t rxEvents;
+            uint8_t rxEventIndex;
+
+            /// @}
+
+            ///
+            /// \brief Matching of legacy internal commands while framed format is used.
+            /// @{
+
+            uint8_t legacyMatchIndex;
+            uint8_t legacyMatchCommand;
+
+            /// @}
+
+            uint8_t incomingBytesCount;
+            uint8_t readBytes[LEGACY_PACKET_SIZE];
+        } channelState_t;
+
+        channelState_t channelState[UART_INTERFACES] = {};
+
+        void increment(uint16_t& counter)
+        {
+            if (counter < 0xFFFF)
+                counter++;
+        }
+
+        uint8_t crc8(uint8_t crc, uint8_t data)
+        {
+            crc ^= data;
+
+            for (int i = 0; i < 8; i++)
+                crc = (crc & 0x80) ? ((crc << 1) ^ CRC8_POLYNOMIAL) : (crc << 1);
+
+            return crc;
+        }
 
         ///
         /// \brief Appends read byte into internal storage.
@@ -50,22 +148,19 @@ namespace OpenDeckMIDIformat
         /// position to the left and write current byte to the
         /// last position.
         ///
-        void appendIncoming(uint8_t byte)
+        void appendIncoming(channelState_t& state, uint8_t byte)
         {
-            if (incomingBytesCount >= 6)
+            if (state.incomingBytesCount >= LEGACY_PACKET_SIZE)
             {
                 //shift data
-                for (int i = 0; i < 5; i++)
-                    tempArray[i] = readBytes[i + 1];
-
-                for (int i = 0; i < 5; i++)
-                    readBytes[i] = tempArray[i];
+                for (int i = 0; i < LEGACY_PACKET_SIZE - 1; i++)
+                    state.readBytes[i] = state.readBytes[i + 1];
 
-                readBytes[5] = byte;
+                state.readBytes[LEGACY_PACKET_SIZE - 1] = byte;
             }
             else
             {
-                readBytes[incomingBytesCount++] = byte;
+                state.readBytes[state.incomingBytesCount++] = byte;
             }
         }
 
@@ -73,125 +168,619 @@ namespace OpenDeckMIDIformat
         /// \brief Clears the entire incoming buffer.
         /// Should be called when valid packet has been processed.
         ///
-        void clearIncomingCount()
+        void clearIncomingCount(channelState_t& state)
         {
-            incomingBytesCount = 0;
+            state.incomingBytesCount = 0;
 
-            for (int i = 0; i < 6; i++)
-                readBytes[i] = 0;
+            for (int i = 0; i < LEGACY_PACKET_SIZE; i++)
+                state.readBytes[i] = 0;
         }
-    }    // namespace
 
-    bool write(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t packetType)
-    {
-        if (channel >= UART_INTERFACES)
-            return false;
+        void resetFrameDecoder(channelState_t& state)
+        {
+            state.rxSize           = 0;
+            state.rxCode           = 0;
+            state.rxBlockRemaining = 0;
+            state.rxCRC            = 0;
+            state.rxDiscard        = false;
+        }
 
-        Board::UART::write(channel, static_cast<uint8_t>(packetType));
-        Board::UART::write(channel, USBMIDIpacket.Event);
-        Board::UART::write(channel, USBMIDIpacket.Data1);
-        Board::UART::write(channel, USBMIDIpacket.Data2);
-        Board::UART::write(channel, USBMIDIpacket.Data3);
-        Board::UART::write(channel, USBMIDIpacket.Event ^ USBMIDIpacket.Data1 ^ USBMIDIpacket.Data2 ^ USBMIDIpacket.Data3);
+        void writeLegacy(uint8_t channel, packetType_t packetType, uint8_t event, uint8_t data1, uint8_t data2, uint8_t data3)
+        {
+            Board::UART::write(channel, static_cast<uint8_t>(packetType));
+            Board::UART::write(channel, event);
+            Board::UART::write(channel, data1);
+            Board::UART::write(channel, data2);
+            Board::UART::write(channel, data3);
+            Board::UART::write(channel, event ^ data1 ^ data2 ^ data3);
+        }
 
-        return true;
-    }
+        void writeLegacyCommand(uint8_t channel, command_t command)
+        {
+            writeLegacy(channel, packetType_t::internalCommand, static_cast<uint8_t>(command), 0x00, 0x00, 0x00);
+        }
 
-    bool read(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t& packetType)
-    {
-        if (channel >= UART_INTERFACES)
-            return false;
+        ///
+        /// \brief Writes COBS encoded frame with trailing delimiter.
+        /// Blocks are written directly from the source data so no
+        /// additional buffer for encoded frame is needed.
+        ///
+        void writeCOBS(uint8_t channel, const uint8_t* data, uint8_t size)
+        {
+            uint8_t start = 0;
+
+            while (true)
+            {
+                uint8_t end = start;
+
+                while ((end < size) && (data[end] != FRAME_DELIMITER) && ((end - start) < 254))
+                    end++;
+
+                Board::UART::write(channel, end - start + 1);
+
+                for (uint8_t i = start; i < end; i++)
+                    Board::UART::write(channel, data[i]);
 
-        for (int i = 0; i < 6; i++)
+                if (end >= size)
+                    break;
+
+                //full block has no implicit zero after it
+                start = (data[end] == FRAME_DELIMITER) ? end + 1 : end;
+            }
+
+            Board::UART::write(channel, FRAME_DELIMITER);
+        }
+
+        void sendFrame(uint8_t channel)
         {
-            uint8_t value;
+            auto& state = channelState[channel];
 
-            if (!Board::UART::read(channel, value))
-                break;
-            else
-                appendIncoming(value);
+            if (!state.txEvents)
+                return;
 
-            if (incomingBytesCount == 6)
-                break;
+            uint8_t frame[FRAME_SIZE];
+            uint8_t size = 0;
+            uint8_t crc  = 0;
+
+            frame[size++] = static_cast<uint8_t>(state.txType);
+
+            for (int i = 0; i < state.txEvents * EVENT_SIZE; i++)
+                frame[size++] = state.txData[i];
+
+            for (int i = 0; i < size; i++)
+                crc = crc8(crc, frame[i]);
+
+            frame[size++] = crc;
+
+            writeCOBS(channel, frame, size);
+            state.txEvents = 0;
         }
 
-        if (incomingBytesCount != 6)
-            return false;
+        ///
+        /// \brief Switches transmission on specified channel back to legacy format.
+        /// Events which are already queued are sent in legacy format.
+        ///
+        void useLegacyTx(uint8_t channel)
+        {
+            auto& state = channelState[channel];
 
-        bool packetTypeValid = true;
+            for (int i = 0; i < state.txEvents; i++)
+            {
+                uint8_t* event = &state.txData[i * EVENT_SIZE];
+                writeLegacy(channel, state.txType, event[0], event[1], event[2], event[3]);
+            }
+
+            state.txEvents = 0;
+            state.txFramed = false;
+        }
+
+        void writeCommand(uint8_t channel, command_t command, uint8_t data1, uint8_t data2, uint8_t data3)
+        {
+            MIDI::USBMIDIpacket_t packet;
+
+            packet.Event = static_cast<uint8_t>(command);
+            packet.Data1 = data1;
+            packet.Data2 = data2;
+            packet.Data3 = data3;
 
-        if ((readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::midi)) || (readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::midiDaisyChain)))
-            packetType = static_cast<packetType_t>(readBytes[static_cast<uint8_t>(packet_t::packetType)]);
-        else if (readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::internalCommand))
-            packetType = packetType_t::internalCommand;
-        else
-            packetTypeValid = false;
+            write(channel, packet, packetType_t::internalCommand);
+        }
 
-        if (packetTypeValid)
+        void grantCredit(uint8_t channel)
         {
-            //read the rest of the packet
-            for (int i = 0; i < 5; i++)
+            auto& state = channelState[channel];
+
+            writeCommand(channel, command_t::credit, state.rxConsumed, 0x00, 0x00);
+            state.rxConsumed = 0;
+        }
+
+        void processCommand(uint8_t channel, const MIDI::USBMIDIpacket_t& USBMIDIpacket)
+        {
+            auto& state = channelState[channel];
+
+            switch (static_cast<command_t>(USBMIDIpacket.Event))
             {
-                switch (i)
+            case command_t::fwUpdated:
+                Board::io::ledFlashStartup(true);
+                break;
+
+            case command_t::fwNotUpdated:
+                Board::io::ledFlashStartup(false);
+                break;
+
+            case command_t::btldrReboot:
+                Board::reboot(Board::rebootType_t::rebootBtldr);
+                break;
+
+            case command_t::appReboot:
+                Board::reboot(Board::rebootType_t::rebootApp);
+                break;
+
+            case command_t::framingRequest:
+                //other side is receiving legacy format at this point
+                useLegacyTx(channel);
+                writeLegacyCommand(channel, command_t::framingEnable);
+                state.txFramed = true;
+                state.txCredit = 0;
+                break;
+
+            case command_t::framingEnable:
+                resetFrameDecoder(state);
+                state.rxEvents     = 0;
+                state.rxEventIndex = 0;
+                state.rxFramed     = true;
+
+                //confirm only if this side hasn't switched already so that the exchange ends here
+                if (!state.txFramed)
+                {
+                    writeLegacyCommand(channel, command_t::framingEnable);
+                    state.txFramed = true;
+                    state.txCredit = 0;
+                }
+
+                //transmission is framed at this point in both cases
+                state.rxConsumed = OD_FORMAT_CREDIT_WINDOW;
+                grantCredit(channel);
+                break;
+
+            case command_t::credit:
+                state.txCredit = (state.txCredit + USBMIDIpacket.Data1) > 0xFF ? 0xFF : state.txCredit + USBMIDIpacket.Data1;
+                break;
+
+            case command_t::linkStats:
+            {
+                uint16_t value = (USBMIDIpacket.Data2 << 8) | USBMIDIpacket.Data3;
+
+                switch (USBMIDIpacket.Data1)
                 {
                 case 0:
-                    USBMIDIpacket.Event = readBytes[static_cast<uint8_t>(packet_t::event)];
+                    state.remoteStats.overrun = value;
                     break;
 
                 case 1:
-                    USBMIDIpacket.Data1 = readBytes[static_cast<uint8_t>(packet_t::data1)];
+                    state.remoteStats.invalid = value;
                     break;
 
                 case 2:
-                    USBMIDIpacket.Data2 = readBytes[static_cast<uint8_t>(packet_t::data2)];
+                    state.remoteStats.forwardFailed = value;
                     break;
 
-                case 3:
-                    USBMIDIpacket.Data3 = readBytes[static_cast<uint8_t>(packet_t::data3)];
-                    break;
-
-                case 4:
-                    //xor byte - do nothing
+                default:
                     break;
                 }
             }
+            break;
 
-            if (readBytes[static_cast<uint8_t>(packet_t::dataXor)] == (USBMIDIpacket.Event ^ USBMIDIpacket.Data1 ^ USBMIDIpacket.Data2 ^ USBMIDIpacket.Data3))
+            default:
+                break;
+            }
+        }
+
+        ///
+        /// \brief Checks whether the incoming byte completes legacy internal command.
+        /// Used while framed format is received: legacy command can't appear
+        /// within framed data since it contains several consecutive zeros.
+        /// \returns True if legacy internal command has been received.
+        ///
+        bool matchLegacyCommand(channelState_t& state, uint8_t byte)
+        {
+            bool match;
+
+            switch (state.legacyMatchIndex)
             {
-                clearIncomingCount();
+            case static_cast<uint8_t>(packet_t::packetType):
+                match = byte == static_cast<uint8_t>(packetType_t::internalCommand);
+                break;
 
-                if (packetType == packetType_t::internalCommand)
-                {
-                    switch (static_cast<command_t>(USBMIDIpacket.Event))
-                    {
-                    case command_t::fwUpdated:
-                        Board::io::ledFlashStartup(true);
-                        break;
+            case static_cast<uint8_t>(packet_t::event):
+                //commands are always smaller than packet type so restarting the match on mismatch is enough
+                match                    = byte < static_cast<uint8_t>(packetType_t::midi);
+                state.legacyMatchCommand = byte;
+                break;
 
-                    case command_t::fwNotUpdated:
-                        Board::io::ledFlashStartup(false);
-                        break;
+            case static_cast<uint8_t>(packet_t::dataXor):
+                match = byte == state.legacyMatchCommand;
+                break;
 
-                    case command_t::btldrReboot:
-                        Board::reboot(Board::rebootType_t::rebootBtldr);
-                        break;
+            default:
+                match = byte == 0x00;
+                break;
+            }
+
+            if (!match)
+            {
+                state.legacyMatchIndex = (byte == static_cast<uint8_t>(packetType_t::internalCommand)) ? 1 : 0;
+                return false;
+            }
+
+            if (++state.legacyMatchIndex < LEGACY_PACKET_SIZE)
+                return false;
 
-                    case command_t::appReboot:
-                        Board::reboot(Board::rebootType_t::rebootApp);
+            state.legacyMatchIndex = 0;
+            return true;
+        }
+
+        ///
+        /// \brief Decodes single byte of COBS encoded frame.
+        /// \returns True if complete and valid frame has been decoded.
+        ///
+        bool decodeFrame(channelState_t& state, uint8_t byte)
+        {
+            if (byte == FRAME_DELIMITER)
+            {
+                //CRC over data including its own CRC is zero for valid frame
+                bool valid = !state.rxDiscard &&
+                             !state.rxBlockRemaining &&
+                             (state.rxSize >= (1 + EVENT_SIZE + 1)) &&
+                             !((state.rxSize - 2) % EVENT_SIZE) &&
+                             !state.rxCRC;
+
+                if (valid)
+                {
+                    switch (static_cast<packetType_t>(state.rxData[0]))
+                    {
+                    case packetType_t::midi:
+                    case packetType_t::internalCommand:
+                    case packetType_t::midiDaisyChain:
+                        state.rxEvents     = (state.rxSize - 2) / EVENT_SIZE;
+                        state.rxEventIndex = 0;
                         break;
 
                     default:
+                        valid = false;
                         break;
                     }
                 }
 
+                //empty frames are just repeated delimiters
+                if (!valid && (state.rxSize || state.rxDiscard))
+                    increment(state.localStats.invalid);
+
+                resetFrameDecoder(state);
+                return valid;
+            }
+
+            if (state.rxDiscard)
+                return false;
+
+            uint8_t decoded[2];
+            uint8_t decodedSize = 0;
+
+            if (!state.rxBlockRemaining)
+            {
+                //new block: previous one ends with implicit zero unless it was full or this is the first one
+                if (state.rxCode && (state.rxCode != 0xFF))
+                    decoded[decodedSize++] = 0x00;
+
+                state.rxCode           = byte;
+                state.rxBlockRemaining = byte - 1;
+            }
+            else
+            {
+                decoded[decodedSize++] = byte;
+                state.rxBlockRemaining--;
+            }
+
+            for (int i = 0; i < decodedSize; i++)
+            {
+                if (state.rxSize >= FRAME_SIZE)
+                {
+                    //too large: ignore everything until next delimiter
+                    state.rxDiscard = true;
+                    return false;
+                }
+
+                state.rxData[state.rxSize++] = decoded[i];
+                state.rxCRC                  = crc8(state.rxCRC, decoded[i]);
+            }
+
+            return false;
+        }
+
+        enum class receiveResult_t : uint8_t
+        {
+            none,             ///< No more incoming data.
+            events,           ///< Decoded frame has unread events.
+            legacyCommand,    ///< Other side has restarted and sent legacy internal command.
+        };
+
+        ///
+        /// \brief Feeds incoming bytes to frame decoder until decoded frame has unread events.
+        /// Legacy internal command received in the meantime is processed and stored in USBMIDIpacket.
+        ///
+        receiveResult_t receiveFrame(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket)
+        {
+            auto& state = channelState[channel];
+
+            while (state.rxEventIndex >= state.rxEvents)
+            {
+                uint8_t value;
+
+                if (!Board::UART::read(channel, value))
+                    return receiveResult_t::none;
+
+                if (matchLegacyCommand(state, value))
+                {
+                    //other side has restarted
+                    resetFrameDecoder(state);
+                    state.rxFramed = false;
+                    useLegacyTx(channel);
+
+                    USBMIDIpacket.Event = state.legacyMatchCommand;
+                    USBMIDIpacket.Data1 = 0x00;
+                    USBMIDIpacket.Data2 = 0x00;
+                    USBMIDIpacket.Data3 = 0x00;
+
+                    processCommand(channel, USBMIDIpacket);
+                    return receiveResult_t::legacyCommand;
+                }
+
+                decodeFrame(state, value);
+            }
+
+            return receiveResult_t::events;
+        }
+
+        bool readFramed(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t& packetType)
+        {
+            auto& state = channelState[channel];
+
+            switch (receiveFrame(channel, USBMIDIpacket))
+            {
+            case receiveResult_t::none:
+                return false;
+
+            case receiveResult_t::legacyCommand:
+                packetType = packetType_t::internalCommand;
                 return true;
+
+            default:
+                break;
             }
+
+            uint8_t* event = &state.rxData[1 + (state.rxEventIndex++ * EVENT_SIZE)];
+
+            USBMIDIpacket.Event = event[0];
+            USBMIDIpacket.Data1 = event[1];
+            USBMIDIpacket.Data2 = event[2];
+            USBMIDIpacket.Data3 = event[3];
+            packetType          = static_cast<packetType_t>(state.rxData[0]);
+
+            if (packetType == packetType_t::internalCommand)
+            {
+                processCommand(channel, USBMIDIpacket);
+            }
+            else if (++state.rxConsumed >= (OD_FORMAT_CREDIT_WINDOW / 2))
+            {
+                //grant in batches to keep the link free for events
+                grantCredit(channel);
+            }
+
+            return true;
+        }
+
+        bool readLegacy(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t& packetType)
+        {
+            auto& state = channelState[channel];
+
+            for (int i = 0; i < LEGACY_PACKET_SIZE; i++)
+            {
+                uint8_t value;
+
+                if (!Board::UART::read(channel, value))
+                    break;
+                else
+                    appendIncoming(state, value);
+
+                if (state.incomingBytesCount == LEGACY_PACKET_SIZE)
+                    break;
+            }
+
+            if (state.incomingBytesCount != LEGACY_PACKET_SIZE)
+                return false;
+
+            auto readBytes = state.readBytes;
+
+            if ((readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::midi)) || (readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::midiDaisyChain)))
+                packetType = static_cast<packetType_t>(readBytes[static_cast<uint8_t>(packet_t::packetType)]);
+            else if (readBytes[static_cast<uint8_t>(packet_t::packetType)] == static_cast<uint8_t>(packetType_t::internalCommand))
+                packetType = packetType_t::internalCommand;
+            else
+                return false;
+
+            USBMIDIpacket.Event = readBytes[static_cast<uint8_t>(packet_t::event)];
+            USBMIDIpacket.Data1 = readBytes[static_cast<uint8_t>(packet_t::data1)];
+            USBMIDIpacket.Data2 = readBytes[static_cast<uint8_t>(packet_t::data2)];
+            USBMIDIpacket.Data3 = readBytes[static_cast<uint8_t>(packet_t::data3)];
+
+            if (readBytes[static_cast<uint8_t>(packet_t::dataXor)] != (USBMIDIpacket.Event ^ USBMIDIpacket.Data1 ^ USBMIDIpacket.Data2 ^ USBMIDIpacket.Data3))
+                return false;
+
+            clearIncomingCount(state);
+
+            if (packetType == packetType_t::internalCommand)
+                processCommand(channel, USBMIDIpacket);
+
+            return true;
+        }
+    }    // namespace
+
+    bool write(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t packetType)
+    {
+        if (channel >= UART_INTERFACES)
+            return false;
+
+        auto& state = channelState[channel];
+
+        if (!state.txFramed)
+        {
+            writeLegacy(channel, packetType, USBMIDIpacket.Event, USBMIDIpacket.Data1, USBMIDIpacket.Data2, USBMIDIpacket.Data3);
+            return true;
         }
 
-        return false;
+        if (packetType != packetType_t::internalCommand)
+        {
+            if (state.txCredit)
+                state.txCredit--;
+            else
+                increment(state.localStats.overrun);
+        }
+
+        //frame holds events of single type only
+        if (state.txEvents && (state.txType != packetType))
+            sendFrame(channel);
+
+        uint8_t* event = &state.txData[state.txEvents++ * EVENT_SIZE];
+
+        event[0]     = USBMIDIpacket.Event;
+        event[1]     = USBMIDIpacket.Data1;
+        event[2]     = USBMIDIpacket.Data2;
+        event[3]     = USBMIDIpacket.Data3;
+        state.txType = packetType;
+
+        //don't delay anything if the link isn't busy
+        if ((state.txEvents == OD_FORMAT_FRAME_EVENTS) || (packetType == packetType_t::internalCommand) || Board::UART::isTxEmpty(channel))
+            sendFrame(channel);
+
+        return true;
+    }
+
+    bool read(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t& packetType)
+    {
+        if (channel >= UART_INTERFACES)
+            return false;
+
+        if (channelState[channel].rxFramed)
+            return readFramed(channel, USBMIDIpacket, packetType);
+
+        return readLegacy(channel, USBMIDIpacket, packetType);
+    }
+
+    void flush(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return;
+
+        sendFrame(channel);
+
+        auto& state = channelState[channel];
+
+        //older firmware doesn't know about this command so report only when framed format is used
+        if (!state.txFramed)
+            return;
+
+        if (state.localStats.overrun != state.reportedStats.overrun)
+        {
+            state.reportedStats.overrun = state.localStats.overrun;
+            writeCommand(channel, command_t::linkStats, 0, state.reportedStats.overrun >> 8, state.reportedStats.overrun & 0xFF);
+        }
+
+        if (state.localStats.invalid != state.reportedStats.invalid)
+        {
+            state.reportedStats.invalid = state.localStats.invalid;
+            writeCommand(channel, command_t::linkStats, 1, state.reportedStats.invalid >> 8, state.reportedStats.invalid & 0xFF);
+        }
+
+        if (state.localStats.forwardFailed != state.reportedStats.forwardFailed)
+        {
+            state.reportedStats.forwardFailed = state.localStats.forwardFailed;
+            writeCommand(channel, command_t::linkStats, 2, state.reportedStats.forwardFailed >> 8, state.reportedStats.forwardFailed & 0xFF);
+        }
+    }
+
+    size_t pendingBytes(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return 0;
+
+        auto& state = channelState[channel];
+
+        if (!state.txEvents)
+            return 0;
+
+        //packet type, events and CRC, increased by COBS code byte and delimiter
+        return 1 + (state.txEvents * EVENT_SIZE) + 1 + 2;
+    }
+
+    void requestFraming(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return;
+
+        //other side could still expect legacy format
+        useLegacyTx(channel);
+        writeLegacyCommand(channel, command_t::framingRequest);
+    }
+
+    bool canWrite(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return false;
+
+        if (!channelState[channel].txFramed)
+            return true;
+
+        return channelState[channel].txCredit;
+    }
+
+    void receiveCommands(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return;
+
+        auto&                 state = channelState[channel];
+        MIDI::USBMIDIpacket_t USBMIDIpacket;
+        packetType_t          packetType;
+
+        while (state.rxFramed)
+        {
+            if (receiveFrame(channel, USBMIDIpacket) != receiveResult_t::events)
+                return;
+
+            if (static_cast<packetType_t>(state.rxData[0]) != packetType_t::internalCommand)
+                return;
+
+            readFramed(channel, USBMIDIpacket, packetType);
+        }
+    }
+
+    void reportForwardFailure(uint8_t channel)
+    {
+        if (channel >= UART_INTERFACES)
+            return;
+
+        increment(channelState[channel].localStats.forwardFailed);
+    }
+
+    void stats(uint8_t channel, stats_t& local, stats_t& remote)
+    {
+        if (channel >= UART_INTERFACES)
+            return;
+
+        local  = channelState[channel].localStats;
+        remote = channelState[channel].remoteStats;
     }
 }    // namespace OpenDeckMIDIformat
 
 #endif
-#endif
\ No newline at end of file
+#endif
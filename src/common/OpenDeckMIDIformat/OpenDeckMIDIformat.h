@@ -20,6 +20,23 @@ limitations under the License.
 
 #include "midi/src/MIDI.h"
 
+#ifndef OD_FORMAT_FRAME_EVENTS
+///
+/// \brief Maximum number of events packed into a single frame once framed format is in use.
+/// Determines the size of transmit and receive frame buffers for each UART channel.
+///
+#define OD_FORMAT_FRAME_EVENTS 8
+#endif
+
+#ifndef OD_FORMAT_CREDIT_WINDOW
+///
+/// \brief Number of events the other side is allowed to send before it receives more credit.
+/// Single event frame takes 8 bytes on the link in the worst case, so all the events
+/// from the window need to fit into UART RX buffer along with few internal commands.
+///
+#define OD_FORMAT_CREDIT_WINDOW 6
+#endif
+
 namespace OpenDeckMIDIformat
 {
     ///
@@ -30,7 +47,13 @@ namespace OpenDeckMIDIformat
         fwUpdated,       ///< Signal to USB link MCU that the firmware has been updated on main MCU.
         fwNotUpdated,    ///< Signal to USB link MCU that the firmware hasn't been updated on main MCU.
         btldrReboot,     ///< Signal to USB link MCU to reboot to bootloader mode.
-        appReboot        ///< Signal to USB link MCU to reboot to application mode.
+        appReboot,       ///< Signal to USB link MCU to reboot to application mode.
+        framingRequest,  ///< Request to switch to framed format. Always sent in legacy format.
+        framingEnable,   ///< Confirmation that framed format will be used by the sender from now on.
+                         ///< Always sent in legacy format.
+        credit,          ///< Number of additional events (Data1) which can be sent to the sender.
+        linkStats        ///< Sender drop counter: counter index (Data1), MSB (Data2) and LSB (Data3).
+                         ///< Counters are indexed in the same order as in stats_t.
     };
 
     enum class packetType_t : uint8_t
@@ -45,6 +68,17 @@ namespace OpenDeckMIDIformat
                                    ///< last slave back to USB master (filter out).
     };
 
+    ///
+    /// \brief Counters of events which could have been lost on the link.
+    /// Counters saturate instead of wrapping around.
+    ///
+    typedef struct
+    {
+        uint16_t overrun;          ///< Events sent without credit from the other side.
+        uint16_t invalid;          ///< Received frames dropped due to corruption or lost bytes.
+        uint16_t forwardFailed;    ///< Received events which couldn't be forwarded further, eg. to USB on USB link.
+    } stats_t;
+
     ///
     /// \brief Used to read data using custom OpenDeck format from UART interface.
     /// @param [in] channel         UART channel on MCU.
@@ -56,10 +90,67 @@ namespace OpenDeckMIDIformat
 
     ///
     /// \brief Used to write data using custom OpenDeck format to UART interface.
+    /// When framed format is used, packet can be queued until the frame is full,
+    /// UART transmitter becomes idle or flush is called.
     /// @param [in] channel         UART channel on MCU.
     /// @param [in] USBMIDIpacket   Pointer to structure holding MIDI data to write.
     /// @param [in] packetType      Type of OpenDeck packet to send.
     /// \returns True on success, false otherwise.
     ///
     bool write(uint8_t channel, MIDI::USBMIDIpacket_t& USBMIDIpacket, packetType_t packetType);
+
+    ///
+    /// \brief Sends all events queued for framed transmission on specified channel.
+    /// Has no effect when legacy format is used on the channel.
+    /// @param [in] channel UART channel on MCU.
+    ///
+    void flush(uint8_t channel);
+
+    ///
+    /// \brief Returns number of bytes which will be written to UART once the events
+    /// queued for framed transmission on specified channel are sent.
+    /// @param [in] channel UART channel on MCU.
+    ///
+    size_t pendingBytes(uint8_t channel);
+
+    ///
+    /// \brief Asks the other side to switch to framed format on specified channel.
+    /// Legacy format is used in both directions until the other side confirms that
+    /// framed format is supported, so older firmware on other side simply ignores this.
+    /// @param [in] channel UART channel on MCU.
+    ///
+    void requestFraming(uint8_t channel);
+
+    ///
+    /// \brief Checks whether the other side is guaranteed to have space for another event.
+    /// Credits are used only with framed format: events written without credit are
+    /// still sent, but the other side could drop them. Internal commands don't need credit.
+    /// @param [in] channel UART channel on MCU.
+    /// \returns True if another event can be written without the risk of being dropped.
+    ///
+    bool canWrite(uint8_t channel);
+
+    ///
+    /// \brief Processes internal commands received on specified channel without reading any other events.
+    /// Decoding stops at the first frame with other events, which stay queued for the next read.
+    /// Used by the side which delays its reads so that it still receives credit from the other side.
+    /// Has no effect when legacy format is used on the channel.
+    /// @param [in] channel UART channel on MCU.
+    ///
+    void receiveCommands(uint8_t channel);
+
+    ///
+    /// \brief Counts the event read from specified channel which couldn't be forwarded further.
+    /// Counter is reported to the other side along with the link drop counters.
+    /// @param [in] channel UART channel on MCU.
+    ///
+    void reportForwardFailure(uint8_t channel);
+
+    ///
+    /// \brief Retrieves drop counters for specified channel.
+    /// @param [in] channel UART channel on MCU.
+    /// @param [in,out] local   Counters of this side.
+    /// @param [in,out] remote  Last counters reported by the other side.
+    ///
+    void stats(uint8_t channel, stats_t& local, stats_t& remote);
 }    // namespace OpenDeckMIDIformat
\ No newline at end of file
@@ -29,15 +29,39 @@ int main(void)
 {
     Board::init();
 
+    //main MCU will respond only if it supports framed format
+    OpenDeckMIDIformat::requestFraming(UART_USB_LINK_CHANNEL);
+
     while (1)
     {
-        if (Board::USB::readMIDI(USBMIDIpacket))
+        //forward several packets in each pass so that they can share a single frame
+        for (int i = 0; i < OD_FORMAT_FRAME_EVENTS; i++)
+        {
+            //leave the data in USB endpoint if main MCU can't receive it yet so that host waits
+            if (!OpenDeckMIDIformat::canWrite(UART_USB_LINK_CHANNEL))
+                break;
+
+            if (!Board::USB::readMIDI(USBMIDIpacket))
+                break;
+
             OpenDeckMIDIformat::write(UART_USB_LINK_CHANNEL, USBMIDIpacket, OpenDeckMIDIformat::packetType_t::midi);
+        }
 
-        if (OpenDeckMIDIformat::read(UART_USB_LINK_CHANNEL, USBMIDIpacket, packetType))
+        OpenDeckMIDIformat::flush(UART_USB_LINK_CHANNEL);
+
+        for (int i = 0; i < OD_FORMAT_FRAME_EVENTS; i++)
         {
-            if (packetType != OpenDeckMIDIformat::packetType_t::internalCommand)
-                Board::USB::writeMIDI(USBMIDIpacket);
+            if (!OpenDeckMIDIformat::read(UART_USB_LINK_CHANNEL, USBMIDIpacket, packetType))
+                break;
+
+            if (packetType == OpenDeckMIDIformat::packetType_t::internalCommand)
+                continue;
+
+            //host isn't reading the data fast enough: main MCU reports this along with link counters
+            if (!Board::USB::writeMIDI(USBMIDIpacket))
+                OpenDeckMIDIformat::reportForwardFailure(UART_USB_LINK_CHANNEL);
         }
+
+        Board::USB::flush();
     }
 }
\ No newline at end of file
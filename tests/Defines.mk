@@ -31,4 +31,12 @@ DEFINES_COMMON += DATABASE_SIZE=$(DATABASE_SIZE)
 
 ifeq ($(ARCH), stm32)
     DEFINES_COMMON += STM32_EMU_EEPROM
+endif
+
+ifneq ($(filter $(MCU), atmega2560 at90usb1286 stm32f405 stm32f407), )
+    DEFINES_COMMON += DATABASE_CONFIG_CACHE
+endif
+
+ifeq ($(SPARSE_PRESETS), 1)
+    DEFINES_COMMON += DATABASE_SPARSE_PRESETS
 endif
\ No newline at end of file
@@ -78,6 +78,11 @@ TEST_CASE(ReadInitialValues)
         TEST_ASSERT_EQUAL_UINT32(0, database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(SysConfig::midiMerge_t::mergeType)));
         TEST_ASSERT_EQUAL_UINT32(0, database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(SysConfig::midiMerge_t::mergeUSBchannel)));
         TEST_ASSERT_EQUAL_UINT32(0, database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(SysConfig::midiMerge_t::mergeDINchannel)));
+        TEST_ASSERT_EQUAL_UINT32(0, database.read(Database::Section::global_t::midiMerge, static_cast<size_t>(SysConfig::midiMerge_t::mergeDINoutChannel)));
+
+        //midi input limit sections
+        TEST_ASSERT_EQUAL_UINT32(16, database.read(Database::Section::global_t::midiInputMessages, 0));
+        TEST_ASSERT_EQUAL_UINT32(1, database.read(Database::Section::global_t::midiInputTime, 0));
 
         //button block
         //type section
@@ -136,6 +141,11 @@ TEST_CASE(ReadInitialValues)
         for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
             TEST_ASSERT_EQUAL_UINT32(4, database.read(Database::Section::encoder_t::pulsesPerStep, i));
 
+        //aggregation time section
+        //all values should be set to 0
+        for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+            TEST_ASSERT_EQUAL_UINT32(0, database.read(Database::Section::encoder_t::aggregationTime, i));
+
         //analog block
         //enable section
         //all values should be set to 0
@@ -278,6 +288,26 @@ TEST_CASE(FactoryReset)
     TEST_ASSERT(database.getPresetPreserveState() == false);
 }
 
+TEST_CASE(FirstBootInit)
+{
+    //blank storage has no valid signature: init should format it and write all defaults,
+    //same as after firmware update which changes the database layout
+    dbStorageMock.clear();
+
+    TEST_ASSERT(database.init() == true);
+    TEST_ASSERT(dbStorageMock.writeCount > 0);
+
+    TEST_ASSERT(database.isSignatureValid() == true);
+    TEST_ASSERT(database.getPreset() == 0);
+    TEST_ASSERT(database.read(Database::Section::button_t::velocity, 0) == 127);
+
+    //signature is now valid, init mustn't write the defaults again:
+    //only the active preset setting can be rewritten
+    size_t writes = dbStorageMock.writeCount;
+    TEST_ASSERT(database.init() == true);
+    TEST_ASSERT((dbStorageMock.writeCount - writes) <= 1);
+}
+
 TEST_CASE(LEDs)
 {
     //regression test
@@ -290,4 +320,79 @@ TEST_CASE(LEDs)
     //rgb state shouldn't change
     for (int i = 0; i < MAX_NUMBER_OF_RGB_LEDS; i++)
         TEST_ASSERT(database.read(Database::Section::leds_t::rgbEnable, i) == false);
-}
\ No newline at end of file
+}
+
+TEST_CASE(CachedValues)
+{
+    database.factoryReset(LESSDB::factoryResetType_t::full);
+
+    //word values should be retrieved without truncation
+    TEST_ASSERT(database.update(Database::Section::analog_t::upperLimit, 0, 12345) == true);
+    TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 0) == 12345);
+
+    if (database.getSupportedPresets() > 1)
+    {
+        //value set in one preset shouldn't be visible in another one
+        TEST_ASSERT(database.setPreset(1) == true);
+        TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 0) == 16383);
+        TEST_ASSERT(database.update(Database::Section::button_t::velocity, 0, 100) == true);
+
+        TEST_ASSERT(database.setPreset(0) == true);
+        TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 0) == 12345);
+        TEST_ASSERT(database.read(Database::Section::button_t::velocity, 0) == 127);
+
+        TEST_ASSERT(database.setPreset(1) == true);
+        TEST_ASSERT(database.read(Database::Section::button_t::velocity, 0) == 100);
+        TEST_ASSERT(database.setPreset(0) == true);
+    }
+
+    //partial factory reset should restore defaults in cache as well
+    database.factoryReset(LESSDB::factoryResetType_t::partial);
+    TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 0) == 16383);
+}
+
+#ifdef DATABASE_SPARSE_PRESETS
+TEST_CASE(SparsePresets)
+{
+    database.factoryReset(LESSDB::factoryResetType_t::full);
+
+    //presets are much smaller when only changes are stored
+    TEST_ASSERT(database.getSupportedPresets() > 10);
+
+    TEST_ASSERT(database.update(Database::Section::button_t::velocity, 0, 100) == true);
+    TEST_ASSERT(database.update(Database::Section::analog_t::upperLimit, 1, 12345) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, 2, 5) == true);
+
+    //setting the default value removes the entry, other entries should stay intact
+    TEST_ASSERT(database.update(Database::Section::button_t::velocity, 0, 127) == true);
+
+    TEST_ASSERT(database.setPreset(1) == true);
+    TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 1) == 16383);
+    TEST_ASSERT(database.setPreset(0) == true);
+
+    TEST_ASSERT(database.read(Database::Section::button_t::velocity, 0) == 127);
+    TEST_ASSERT(database.read(Database::Section::analog_t::upperLimit, 1) == 12345);
+    TEST_ASSERT(database.read(Database::Section::encoder_t::midiChannel, 2) == 5);
+
+    //auto-incremented defaults are resolved as well
+    TEST_ASSERT(database.read(Database::Section::button_t::midiID, 3) == 3);
+
+    database.factoryReset(LESSDB::factoryResetType_t::full);
+
+    //fill the preset with changes: once it's full only existing entries can be changed
+    size_t entries = 0;
+
+    for (int i = 0; (i < MAX_NUMBER_OF_BUTTONS + MAX_NUMBER_OF_ANALOG + MAX_TOUCHSCREEN_BUTTONS) && (entries < SPARSE_PRESET_ENTRIES); i++, entries++)
+        TEST_ASSERT(database.update(Database::Section::button_t::velocity, i, 100) == true);
+
+    for (int i = 0; (i < MAX_NUMBER_OF_ENCODERS) && (entries < SPARSE_PRESET_ENTRIES); i++, entries++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, i, 5) == true);
+
+    if (entries == SPARSE_PRESET_ENTRIES)
+    {
+        TEST_ASSERT(database.update(Database::Section::analog_t::upperLimit, 0, 12345) == false);
+        TEST_ASSERT(database.update(Database::Section::button_t::velocity, 0, 50) == true);
+        TEST_ASSERT(database.read(Database::Section::button_t::velocity, 0) == 50);
+    }
+}
+#endif
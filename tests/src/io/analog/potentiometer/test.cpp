@@ -657,4 +657,48 @@ TEST_CASE(Scaling)
         TEST_ASSERT_EQUAL_UINT32(scaledUpperValue, midiPacket.at(i).Data3);
         TEST_ASSERT_EQUAL_UINT32(scaledUpperLower, midiPacket.at(midiPacket.size() - MAX_NUMBER_OF_ANALOG + i).Data3);
     }
+}
+
+TEST_CASE(ScalingMatchesMapRange)
+{
+    using namespace IO;
+
+    //conversion of raw ADC reading to MIDI value, for all supported ADC resolutions
+    const uint16_t adcMaxValues[]  = { 1023, 4095 };
+    const uint16_t midiMaxValues[] = { MIDI_7_BIT_VALUE_MAX, MIDI_14_BIT_VALUE_MAX };
+
+    for (size_t adc = 0; adc < sizeof(adcMaxValues) / sizeof(adcMaxValues[0]); adc++)
+    {
+        for (size_t midi = 0; midi < sizeof(midiMaxValues) / sizeof(midiMaxValues[0]); midi++)
+        {
+            uint32_t factor = Analog::scaleFactor(midiMaxValues[midi], adcMaxValues[adc]);
+
+            for (uint32_t value = 0; value <= adcMaxValues[adc]; value++)
+            {
+                uint32_t expected = core::misc::mapRange(value, static_cast<uint32_t>(0), static_cast<uint32_t>(adcMaxValues[adc]), static_cast<uint32_t>(0), static_cast<uint32_t>(midiMaxValues[midi]));
+
+                if (Analog::scale(value, factor, midiMaxValues[midi], adcMaxValues[adc]) != expected)
+                    TEST_ASSERT_EQUAL_UINT32(expected, Analog::scale(value, factor, midiMaxValues[midi], adcMaxValues[adc]));
+            }
+        }
+    }
+
+    //scaling of MIDI value to configured limits: lower and upper limit only set the base value
+    //and the direction, the scaled part depends on their difference only, so checking every
+    //possible difference covers every lower/upper limit pair
+    for (size_t midi = 0; midi < sizeof(midiMaxValues) / sizeof(midiMaxValues[0]); midi++)
+    {
+        for (uint32_t range = 0; range <= midiMaxValues[midi]; range++)
+        {
+            uint32_t factor = Analog::scaleFactor(range, midiMaxValues[midi]);
+
+            for (uint32_t value = 0; value <= midiMaxValues[midi]; value++)
+            {
+                uint32_t expected = core::misc::mapRange(value, static_cast<uint32_t>(0), static_cast<uint32_t>(midiMaxValues[midi]), static_cast<uint32_t>(0), range);
+
+                if (Analog::scale(value, factor, range, midiMaxValues[midi]) != expected)
+                    TEST_ASSERT_EQUAL_UINT32(expected, Analog::scale(value, factor, range, midiMaxValues[midi]));
+            }
+        }
+    }
 }
\ No newline at end of file
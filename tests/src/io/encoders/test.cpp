@@ -1,6 +1,8 @@
 #include "unity/src/unity.h"
 #include "unity/Helpers.h"
+#include <vector>
 #include "io/encoders/Encoders.h"
+#include "io/buttons/Buttons.h"
 #include "io/leds/LEDs.h"
 #include "io/common/CInfo.h"
 #include "midi/src/MIDI.h"
@@ -110,10 +112,46 @@ namespace
         };
     } hwaEncoders;
 
+    class HWALEDs : public IO::LEDs::HWA
+    {
+        public:
+        HWALEDs() {}
+
+        void setState(size_t index, bool state) override
+        {
+        }
+
+        size_t rgbSingleComponentIndex(size_t rgbIndex, IO::LEDs::rgbIndex_t rgbComponent) override
+        {
+            return 0;
+        }
+
+        size_t rgbIndex(size_t singleLEDindex) override
+        {
+            return 0;
+        }
+
+        void setFadeSpeed(size_t transitionSpeed) override
+        {
+        }
+    } ledsHWA;
+
+    class HWAButtons : public IO::Buttons::HWA
+    {
+        public:
+        HWAButtons() {}
+
+        bool state(size_t index) override
+        {
+            return false;
+        }
+    } hwaButtons;
+
     DBstorageMock dbStorageMock;
     Database      database = Database(dbHandlers, dbStorageMock);
     MIDI          midi;
     ComponentInfo cInfo;
+    IO::LEDs      leds(ledsHWA, database);
 
 #ifdef DISPLAY_SUPPORTED
     class HWAU8X8 : public IO::U8X8::HWAI2C
@@ -143,8 +181,10 @@ namespace
     IO::U8X8     u8x8(hwaU8X8);
     IO::Display  display(u8x8, database);
     IO::Encoders encoders = IO::Encoders(hwaEncoders, database, midi, display, cInfo);
+    IO::Buttons  buttons  = IO::Buttons(hwaButtons, database, midi, leds, display, cInfo);
 #else
     IO::Encoders encoders = IO::Encoders(hwaEncoders, database, midi, cInfo);
+    IO::Buttons  buttons  = IO::Buttons(hwaButtons, database, midi, leds, cInfo);
 #endif
 }    // namespace
 
@@ -731,4 +771,270 @@ TEST_CASE(Acceleration)
     accelerationTest(4);
     accelerationTest(3);
     accelerationTest(2);
-}
\ No newline at end of file
+}
+
+TEST_CASE(Aggregation)
+{
+    using namespace IO;
+
+    auto aggregationTest = [&](Encoders::type_t type, uint8_t expectedValue) {
+        //set known state
+        for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        {
+            TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 1) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::invert, i, 0) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::mode, i, static_cast<int32_t>(type)) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::acceleration, i, 0) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::pulsesPerStep, i, 1) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, i, 1) == true);
+            TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, i, 10) == true);
+        }
+
+        encoders.init();
+
+        for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+            hwaEncoders.setEncoderState(i, Encoders::position_t::cw);
+
+        messageCounter                 = 0;
+        core::timing::detail::rTime_ms = 1;
+
+        //first reading is only stored, each following one is a single step
+        //nothing should be sent until aggregation time passes
+        for (int i = 0; i < 5; i++)
+            encoders.update();
+
+        TEST_ASSERT(messageCounter == 0);
+
+        //one more step, after which all the steps should be sent in a single message
+        core::timing::detail::rTime_ms += 10;
+        encoders.update();
+
+        TEST_ASSERT(messageCounter == MAX_NUMBER_OF_ENCODERS);
+
+        for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+            TEST_ASSERT(controlValue[i] == expectedValue);
+
+        for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+            TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, i, 0) == true);
+    };
+
+    //relative modes: accumulated steps are sent as single value
+    aggregationTest(Encoders::type_t::t3Fh41h, 64 + 5);
+    aggregationTest(Encoders::type_t::t7Fh01h, 5);
+
+    //absolute mode: only the last value is sent
+    aggregationTest(Encoders::type_t::tControlChange, 5);
+}
+
+TEST_CASE(AggregationResetOnConfigurationChange)
+{
+    using namespace IO;
+
+    //set known state
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+    {
+        TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 1) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::invert, i, 0) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::mode, i, static_cast<int32_t>(Encoders::type_t::t3Fh41h)) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::acceleration, i, 0) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::pulsesPerStep, i, 1) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, i, 1) == true);
+        TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, i, 10) == true);
+    }
+
+    encoders.init();
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        hwaEncoders.setEncoderState(i, Encoders::position_t::cw);
+
+    messageCounter                 = 0;
+    core::timing::detail::rTime_ms = 1;
+
+    //collect 4 steps
+    for (int i = 0; i < 5; i++)
+        encoders.update();
+
+    //disable and enable the encoders again: collected steps should be dropped
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 0) == true);
+
+    core::timing::detail::rTime_ms += 10;
+    encoders.update();
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 1) == true);
+
+    //two new steps, only these should be sent once aggregation time passes
+    encoders.update();
+    TEST_ASSERT(messageCounter == 0);
+
+    core::timing::detail::rTime_ms += 10;
+    encoders.update();
+
+    TEST_ASSERT(messageCounter == MAX_NUMBER_OF_ENCODERS);
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(controlValue[i] == 64 + 2);
+
+    //collect 4 steps again, then change the mode
+    messageCounter = 0;
+
+    for (int i = 0; i < 4; i++)
+        encoders.update();
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::mode, i, static_cast<int32_t>(Encoders::type_t::t7Fh01h)) == true);
+
+    encoders.update();
+    TEST_ASSERT(messageCounter == 0);
+
+    core::timing::detail::rTime_ms += 10;
+    encoders.update();
+
+    TEST_ASSERT(messageCounter == MAX_NUMBER_OF_ENCODERS);
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(controlValue[i] == 2);
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, i, 0) == true);
+}
+
+TEST_CASE(NRPNSelectionAfterControlChange)
+{
+    using namespace IO;
+
+    //controller numbers and values of all sent control change messages
+    static std::vector<std::pair<uint8_t, uint8_t>> controlChanges;
+
+    midi.handleUSBwrite([](MIDI::USBMIDIpacket_t& USBMIDIpacket) {
+        controlChanges.push_back({ USBMIDIpacket.Data2, USBMIDIpacket.Data3 });
+        return true;
+    });
+
+    //only first encoder is used, as NRPN encoder
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 0) == true);
+
+    TEST_ASSERT(database.update(Database::Section::encoder_t::enable, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::invert, 0, 0) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::mode, 0, static_cast<int32_t>(Encoders::type_t::tNRPN7bit)) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::midiID, 0, 5) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::acceleration, 0, 0) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::pulsesPerStep, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, 0, 0) == true);
+
+    //first button sends CC 99 on the same channel
+    TEST_ASSERT(database.update(Database::Section::button_t::type, 0, static_cast<int32_t>(Buttons::type_t::momentary)) == true);
+    TEST_ASSERT(database.update(Database::Section::button_t::midiMessage, 0, static_cast<int32_t>(Buttons::messageType_t::controlChange)) == true);
+    TEST_ASSERT(database.update(Database::Section::button_t::midiID, 0, 99) == true);
+    TEST_ASSERT(database.update(Database::Section::button_t::velocity, 0, 10) == true);
+    TEST_ASSERT(database.update(Database::Section::button_t::midiChannel, 0, 1) == true);
+
+    encoders.init();
+    Common::resetNRPNselection();
+    hwaEncoders.setEncoderState(0, Encoders::position_t::cw);
+    core::timing::detail::rTime_ms = 1;
+
+    //first reading is only stored
+    encoders.update();
+
+    auto step = [&]() {
+        controlChanges.clear();
+        core::timing::detail::rTime_ms += ENCODERS_SPEED_TIMEOUT;
+        encoders.update();
+    };
+
+    //parameter isn't selected yet: full selection is sent
+    step();
+    TEST_ASSERT(controlChanges.size() == 3);
+    TEST_ASSERT(controlChanges.at(0).first == 99);
+    TEST_ASSERT(controlChanges.at(0).second == 0);
+    TEST_ASSERT(controlChanges.at(1).first == 98);
+    TEST_ASSERT(controlChanges.at(1).second == 5);
+    TEST_ASSERT(controlChanges.at(2).first == 6);
+
+    //same parameter: only data entry is sent
+    step();
+    TEST_ASSERT(controlChanges.size() == 1);
+    TEST_ASSERT(controlChanges.at(0).first == 6);
+
+    //button changes NRPN MSB on the channel
+    controlChanges.clear();
+    buttons.processButton(0, true);
+    TEST_ASSERT(controlChanges.size() == 1);
+    TEST_ASSERT(controlChanges.at(0).first == 99);
+    TEST_ASSERT(controlChanges.at(0).second == 10);
+
+    //encoder needs to select its parameter again
+    step();
+    TEST_ASSERT(controlChanges.size() == 3);
+    TEST_ASSERT(controlChanges.at(0).first == 99);
+    TEST_ASSERT(controlChanges.at(0).second == 0);
+    TEST_ASSERT(controlChanges.at(1).first == 98);
+    TEST_ASSERT(controlChanges.at(1).second == 5);
+    TEST_ASSERT(controlChanges.at(2).first == 6);
+
+    //same for RPN selection
+    TEST_ASSERT(database.update(Database::Section::button_t::midiID, 0, 101) == true);
+    controlChanges.clear();
+    buttons.processButton(0, false);
+    buttons.processButton(0, true);
+
+    step();
+    TEST_ASSERT(controlChanges.size() == 3);
+    TEST_ASSERT(controlChanges.at(0).first == 99);
+    TEST_ASSERT(controlChanges.at(1).first == 98);
+
+    midi.handleUSBwrite(midiDataHandler);
+}
+
+TEST_CASE(NRPNSelectionCacheDisabled)
+{
+    using namespace IO;
+
+    //controller numbers of all sent control change messages
+    static std::vector<uint8_t> controlChanges;
+
+    midi.handleUSBwrite([](MIDI::USBMIDIpacket_t& USBMIDIpacket) {
+        controlChanges.push_back(USBMIDIpacket.Data2);
+        return true;
+    });
+
+    for (int i = 0; i < MAX_NUMBER_OF_ENCODERS; i++)
+        TEST_ASSERT(database.update(Database::Section::encoder_t::enable, i, 0) == true);
+
+    TEST_ASSERT(database.update(Database::Section::encoder_t::enable, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::invert, 0, 0) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::mode, 0, static_cast<int32_t>(Encoders::type_t::tNRPN7bit)) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::midiID, 0, 5) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::acceleration, 0, 0) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::pulsesPerStep, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::midiChannel, 0, 1) == true);
+    TEST_ASSERT(database.update(Database::Section::encoder_t::aggregationTime, 0, 0) == true);
+
+    encoders.init();
+    hwaEncoders.setEncoderState(0, Encoders::position_t::cw);
+    core::timing::detail::rTime_ms = 1;
+
+    //with cache disabled (hardware DIN loopback), selection must be sent on every step
+    Common::setNRPNselectionCache(false);
+
+    //first reading is only stored
+    encoders.update();
+
+    for (int i = 0; i < 3; i++)
+    {
+        controlChanges.clear();
+        core::timing::detail::rTime_ms += ENCODERS_SPEED_TIMEOUT;
+        encoders.update();
+        TEST_ASSERT(controlChanges.size() == 3);
+        TEST_ASSERT(controlChanges.at(0) == 99);
+        TEST_ASSERT(controlChanges.at(1) == 98);
+        TEST_ASSERT(controlChanges.at(2) == 6);
+    }
+
+    Common::setNRPNselectionCache(true);
+    midi.handleUSBwrite(midiDataHandler);
+}
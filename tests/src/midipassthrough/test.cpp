@@ -0,0 +1,156 @@
+#include "unity/src/unity.h"
+#include "unity/Helpers.h"
+#include <vector>
+#include "OpenDeck/MIDIPassthrough.h"
+
+namespace
+{
+    std::vector<MIDI::USBMIDIpacket_t> output;
+
+    MIDIPassthrough passthrough([](MIDI::USBMIDIpacket_t& packet) {
+        output.push_back(packet);
+        return true;
+    });
+
+    void writeData(std::vector<uint8_t> data)
+    {
+        for (size_t i = 0; i < data.size(); i++)
+            passthrough.process(data.at(i));
+    }
+
+    void verifyPacket(size_t index, uint8_t event, uint8_t data1, uint8_t data2, uint8_t data3)
+    {
+        TEST_ASSERT(index < output.size());
+        TEST_ASSERT(output.at(index).Event == event);
+        TEST_ASSERT(output.at(index).Data1 == data1);
+        TEST_ASSERT(output.at(index).Data2 == data2);
+        TEST_ASSERT(output.at(index).Data3 == data3);
+    }
+}    // namespace
+
+TEST_SETUP()
+{
+    output.clear();
+    passthrough.reset();
+    passthrough.setChannels(0, 0);
+}
+
+TEST_CASE(ChannelMessages)
+{
+    writeData({ 0x90, 0x3C, 0x7F, 0xC2, 0x05, 0xE0, 0x00, 0x40 });
+
+    TEST_ASSERT(output.size() == 3);
+    verifyPacket(0, 0x09, 0x90, 0x3C, 0x7F);
+    verifyPacket(1, 0x0C, 0xC2, 0x05, 0x00);
+    verifyPacket(2, 0x0E, 0xE0, 0x00, 0x40);
+
+    TEST_ASSERT(MIDIPassthrough::packetSize(output.at(0)) == 3);
+    TEST_ASSERT(MIDIPassthrough::packetSize(output.at(1)) == 2);
+}
+
+TEST_CASE(RunningStatus)
+{
+    writeData({ 0xB0, 0x07, 0x10, 0x07, 0x11, 0x08 });
+
+    //last message isn't complete
+    TEST_ASSERT(output.size() == 2);
+    verifyPacket(0, 0x0B, 0xB0, 0x07, 0x10);
+    verifyPacket(1, 0x0B, 0xB0, 0x07, 0x11);
+
+    //real-time messages don't cancel running status
+    writeData({ 0xF8, 0x12 });
+
+    TEST_ASSERT(output.size() == 4);
+    verifyPacket(2, 0x0F, 0xF8, 0x00, 0x00);
+    verifyPacket(3, 0x0B, 0xB0, 0x08, 0x12);
+
+    //system common messages do
+    writeData({ 0xF3, 0x01, 0x07, 0x13 });
+
+    TEST_ASSERT(output.size() == 5);
+    verifyPacket(4, 0x02, 0xF3, 0x01, 0x00);
+
+    //data without status is ignored
+    writeData({ 0x01, 0x02, 0x03 });
+    TEST_ASSERT(output.size() == 5);
+}
+
+TEST_CASE(SysEx)
+{
+    writeData({ 0xF0, 0x00, 0x53, 0x43, 0xF7 });
+
+    TEST_ASSERT(output.size() == 2);
+    verifyPacket(0, 0x04, 0xF0, 0x00, 0x53);
+    verifyPacket(1, 0x06, 0x43, 0xF7, 0x00);
+
+    output.clear();
+
+    //real-time message inside of sysex
+    writeData({ 0xF0, 0x01, 0xFA, 0x02, 0x03, 0x04, 0xF7 });
+
+    TEST_ASSERT(output.size() == 3);
+    verifyPacket(0, 0x0F, 0xFA, 0x00, 0x00);
+    verifyPacket(1, 0x04, 0xF0, 0x01, 0x02);
+    verifyPacket(2, 0x07, 0x03, 0x04, 0xF7);
+
+    output.clear();
+
+    //sysex with length divisible by 3
+    writeData({ 0xF0, 0x01, 0x02, 0xF7 });
+
+    TEST_ASSERT(output.size() == 2);
+    verifyPacket(0, 0x04, 0xF0, 0x01, 0x02);
+    verifyPacket(1, 0x05, 0xF7, 0x00, 0x00);
+}
+
+TEST_CASE(UnterminatedSysEx)
+{
+    //status byte terminates sysex - buffered bytes are sent with sysex end appended
+    writeData({ 0xF0, 0x01, 0x02, 0x03, 0x04, 0x90, 0x3C, 0x7F });
+
+    TEST_ASSERT(output.size() == 3);
+    verifyPacket(0, 0x04, 0xF0, 0x01, 0x02);
+    verifyPacket(1, 0x07, 0x03, 0x04, 0xF7);
+    verifyPacket(2, 0x09, 0x90, 0x3C, 0x7F);
+
+    output.clear();
+
+    //nothing buffered
+    writeData({ 0xF0, 0x01, 0x02, 0xF2, 0x10, 0x20 });
+
+    TEST_ASSERT(output.size() == 3);
+    verifyPacket(0, 0x04, 0xF0, 0x01, 0x02);
+    verifyPacket(1, 0x05, 0xF7, 0x00, 0x00);
+    verifyPacket(2, 0x03, 0xF2, 0x10, 0x20);
+}
+
+TEST_CASE(ChannelFilter)
+{
+    passthrough.setChannels(2, 0);
+
+    writeData({ 0x90, 0x3C, 0x7F, 0x91, 0x3C, 0x7F, 0x3D, 0x7F, 0xF8 });
+
+    TEST_ASSERT(output.size() == 3);
+    verifyPacket(0, 0x09, 0x91, 0x3C, 0x7F);
+    verifyPacket(1, 0x09, 0x91, 0x3D, 0x7F);
+    verifyPacket(2, 0x0F, 0xF8, 0x00, 0x00);
+}
+
+TEST_CASE(ChannelRemap)
+{
+    passthrough.setChannels(0, 16);
+
+    writeData({ 0x90, 0x3C, 0x7F, 0xB3, 0x07, 0x10 });
+
+    TEST_ASSERT(output.size() == 2);
+    verifyPacket(0, 0x09, 0x9F, 0x3C, 0x7F);
+    verifyPacket(1, 0x0B, 0xBF, 0x07, 0x10);
+
+    passthrough.setChannels(1, 5);
+    output.clear();
+
+    writeData({ 0x90, 0x3C, 0x7F, 0x91, 0x3C, 0x7F });
+
+    TEST_ASSERT(output.size() == 1);
+    verifyPacket(0, 0x09, 0x94, 0x3C, 0x7F);
+}
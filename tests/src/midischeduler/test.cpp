@@ -0,0 +1,334 @@
+#include "unity/src/unity.h"
+#include "unity/Helpers.h"
+#include <vector>
+#include "OpenDeck/MIDIScheduler.h"
+#include "core/src/general/Timing.h"
+
+namespace
+{
+    std::vector<uint8_t> output;
+    size_t               linkSpace;
+    size_t               linkAccepts;
+
+    MIDIScheduler scheduler(
+        [](uint8_t data) {
+            if (!linkAccepts)
+                return false;
+
+            linkAccepts--;
+            output.push_back(data);
+            return true;
+        },
+        []() {
+            //time passes while waiting for the link
+            core::timing::detail::rTime_ms++;
+            return linkSpace;
+        });
+
+    void writeMessage(std::vector<uint8_t> message)
+    {
+        for (size_t i = 0; i < message.size(); i++)
+            scheduler.write(message.at(i));
+    }
+}    // namespace
+
+TEST_SETUP()
+{
+    output.clear();
+    linkSpace   = 0;
+    linkAccepts = SIZE_MAX;
+    scheduler.reset();
+    scheduler.setRunningStatusState(false);
+}
+
+TEST_CASE(Passthrough)
+{
+    linkSpace = 100;
+
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(NoDataWithoutSpace)
+{
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0xB0, 0x07, 0x10 });
+    scheduler.update();
+
+    TEST_ASSERT(output.size() == 0);
+
+    //room for first message only
+    linkSpace = 3;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(ControlChangeCoalescing)
+{
+    writeMessage({ 0xB0, 0x07, 0x10 });
+    writeMessage({ 0xB0, 0x08, 0x05 });
+    writeMessage({ 0xB0, 0x07, 0x20 });
+    writeMessage({ 0xB1, 0x07, 0x30 });
+    writeMessage({ 0xB0, 0x07, 0x40 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    //latest value is sent in place of the first one, different channel is separate destination
+    std::vector<uint8_t> expected = { 0xB0, 0x07, 0x40, 0xB0, 0x08, 0x05, 0xB1, 0x07, 0x30 };
+    TEST_ASSERT(expected == output);
+
+    //once sent, same destination is queued again
+    output.clear();
+    writeMessage({ 0xB0, 0x07, 0x41 });
+    scheduler.update();
+
+    expected = { 0xB0, 0x07, 0x41 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(NotesAreNotCoalesced)
+{
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0x80, 0x3C, 0x00 });
+    writeMessage({ 0x90, 0x3C, 0x7F });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F, 0x80, 0x3C, 0x00, 0x90, 0x3C, 0x7F };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(RealTimeSkipsQueue)
+{
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0xB0, 0x07 });
+    writeMessage({ 0xF8 });
+    writeMessage({ 0x10 });
+
+    //real-time message is passed on immediately, even inside other message
+    std::vector<uint8_t> expected = { 0xF8 };
+    TEST_ASSERT(expected == output);
+
+    linkSpace = 100;
+    scheduler.update();
+
+    expected = { 0xF8, 0x90, 0x3C, 0x7F, 0xB0, 0x07, 0x10 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(PitchBendCoalescing)
+{
+    writeMessage({ 0xE2, 0x00, 0x40 });
+    writeMessage({ 0xE2, 0x01, 0x41 });
+    writeMessage({ 0xE2, 0x02, 0x42 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0xE2, 0x02, 0x42 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(NRPNCoalescing)
+{
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x10, 0xB0, 38, 0x11 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x20 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x30, 0xB0, 38, 0x31 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = {
+        0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x30, 0xB0, 38, 0x31,
+        0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x20
+    };
+
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(RunningStatus)
+{
+    scheduler.setRunningStatusState(true);
+
+    //input with running status
+    writeMessage({ 0x90, 0x3C, 0x7F, 0x3D, 0x7F });
+    writeMessage({ 0xB0, 0x07, 0x10 });
+    writeMessage({ 0xB0, 0x08, 0x10 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F, 0x3D, 0x7F, 0xB0, 0x07, 0x10, 0x08, 0x10 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(SysExIsKeptIntact)
+{
+    writeMessage({ 0xB0, 0x07, 0x10 });
+    writeMessage({ 0xF0, 0x00, 0x53, 0x43, 0xF7 });
+    writeMessage({ 0xB0, 0x07, 0x20 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    //newer value can't be sent ahead of sysex queued before it
+    std::vector<uint8_t> expected = { 0xF0, 0x00, 0x53, 0x43, 0xF7, 0xB0, 0x07, 0x20 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(CoalescedValueKeepsOrder)
+{
+    writeMessage({ 0xB0, 0x07, 0x10 });
+    writeMessage({ 0xB0, 0x08, 0x10 });
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0xB0, 0x07, 0x20 });
+    writeMessage({ 0xB0, 0x08, 0x20 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    //both controllers are updated after the note so they are sent after it, in order of the updates
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F, 0xB0, 0x07, 0x20, 0xB0, 0x08, 0x20 };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(FullQueueTimeout)
+{
+    for (int i = 0; i < MIDI_SCHEDULER_QUEUE_SIZE; i++)
+    {
+        TEST_ASSERT(scheduler.write(0x90) == true);
+        TEST_ASSERT(scheduler.write(i) == true);
+        TEST_ASSERT(scheduler.write(0x7F) == true);
+    }
+
+    //link doesn't accept anything: message is dropped once the timeout passes
+    uint32_t start = core::timing::detail::rTime_ms;
+
+    TEST_ASSERT(scheduler.write(0x90) == true);
+    TEST_ASSERT(scheduler.write(0x7E) == true);
+    TEST_ASSERT(scheduler.write(0x7F) == false);
+    TEST_ASSERT((core::timing::detail::rTime_ms - start) >= MIDI_SCHEDULER_PUSH_TIMEOUT);
+
+    linkSpace = 1000;
+    scheduler.update();
+
+    TEST_ASSERT(output.size() == (MIDI_SCHEDULER_QUEUE_SIZE * 3));
+    TEST_ASSERT(output.at(output.size() - 2) == (MIDI_SCHEDULER_QUEUE_SIZE - 1));
+}
+
+TEST_CASE(RefusedDataIsResent)
+{
+    scheduler.setRunningStatusState(true);
+
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0x90, 0x3D, 0x7F });
+
+    //link refuses last byte of second message
+    linkSpace   = 100;
+    linkAccepts = 4;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = { 0x90, 0x3C, 0x7F, 0x3D };
+    TEST_ASSERT(expected == output);
+
+    //message is sent again in full, with status byte
+    output.clear();
+    linkAccepts = SIZE_MAX;
+    scheduler.update();
+
+    expected = { 0x90, 0x3D, 0x7F };
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(NRPNDataEntryWithoutSelection)
+{
+    //parameter selection is skipped by the sender when the same parameter is already selected
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x10 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x20 });
+    writeMessage({ 0xB0, 6, 0x21 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = {
+        0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x10,
+        0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x21
+    };
+
+    TEST_ASSERT(expected == output);
+
+    //parameter is still selected on the link: selection isn't repeated
+    output.clear();
+    writeMessage({ 0xB0, 6, 0x22 });
+    scheduler.update();
+
+    expected = { 0xB0, 6, 0x22 };
+    TEST_ASSERT(expected == output);
+
+    //different parameter on the link is selected once data entry for it is sent
+    output.clear();
+    linkSpace = 0;
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x30 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x31 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x32 });
+    writeMessage({ 0xB0, 6, 0x33 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    expected = {
+        0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x33,
+        0xB0, 99, 0x01, 0xB0, 98, 0x03, 0xB0, 6, 0x31
+    };
+
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(RPNIsNotCoalesced)
+{
+    //data entry for different RPNs must reach the receiver after its own selection
+    writeMessage({ 0xB0, 101, 0x00, 0xB0, 100, 0x00, 0xB0, 6, 0x0C });
+    writeMessage({ 0xB0, 101, 0x00, 0xB0, 100, 0x01, 0xB0, 6, 0x40 });
+
+    linkSpace = 100;
+    scheduler.update();
+
+    std::vector<uint8_t> expected = {
+        0xB0, 101, 0x00, 0xB0, 100, 0x00, 0xB0, 6, 0x0C,
+        0xB0, 101, 0x00, 0xB0, 100, 0x01, 0xB0, 6, 0x40
+    };
+
+    TEST_ASSERT(expected == output);
+}
+
+TEST_CASE(PendingBytes)
+{
+    TEST_ASSERT(scheduler.pendingBytes() == 0);
+
+    writeMessage({ 0x90, 0x3C, 0x7F });
+    writeMessage({ 0xC0, 0x05 });
+    writeMessage({ 0xB0, 0x07, 0x10 });
+
+    //coalesced value doesn't add anything
+    writeMessage({ 0xB0, 0x07, 0x20 });
+    writeMessage({ 0xB0, 99, 0x01, 0xB0, 98, 0x02, 0xB0, 6, 0x10, 0xB0, 38, 0x11 });
+
+    TEST_ASSERT(scheduler.pendingBytes() == (3 + 2 + 3 + 12));
+
+    linkSpace = 5;
+    scheduler.update();
+
+    TEST_ASSERT(scheduler.pendingBytes() == (3 + 12));
+
+    linkSpace = 100;
+    scheduler.update();
+
+    TEST_ASSERT(scheduler.pendingBytes() == 0);
+}
@@ -14,6 +14,7 @@ namespace
 {
     auto                                   rebootType = Board::rebootType_t::rebootApp;
     core::RingBuffer<uint8_t, BUFFER_SIZE> buffer;
+    bool                                   txEmpty = true;
 }    // namespace
 
 namespace Board
@@ -46,6 +47,11 @@ namespace Board
             TEST_ASSERT(buffer.insert(data) == true);
             return true;
         }
+
+        bool isTxEmpty(uint8_t channel)
+        {
+            return txEmpty;
+        }
     }    // namespace UART
 }    // namespace Board
 
@@ -160,5 +166,209 @@ TEST_CASE(ManualPacketBuilding)
     rebootType = Board::rebootType_t::rebootBtldr;
 }
 
+TEST_CASE(Framing)
+{
+    MIDI::USBMIDIpacket_t            sending;
+    MIDI::USBMIDIpacket_t            receiving;
+    OpenDeckMIDIformat::packetType_t receivedPacketType;
+
+    buffer.reset();
+
+    //since uart is looped back, the same module negotiates with itself:
+    //request is answered with enable which switches both directions to framed format
+    OpenDeckMIDIformat::requestFraming(TEST_MIDI_CHANNEL);
+    TEST_ASSERT(buffer.count() == 6);
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receivedPacketType == OpenDeckMIDIformat::packetType_t::internalCommand);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::framingRequest));
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::framingEnable));
+
+    //no confirmation should be sent back since transmission has already been switched,
+    //only the initial credit
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receivedPacketType == OpenDeckMIDIformat::packetType_t::internalCommand);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::credit));
+    TEST_ASSERT(receiving.Data1 == OD_FORMAT_CREDIT_WINDOW);
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == false);
+    TEST_ASSERT(buffer.isEmpty() == true);
+
+    //link is busy - events should be queued until flush
+    txEmpty = false;
+
+    for (int i = 0; i < 3; i++)
+    {
+        sending.Event = static_cast<uint8_t>(MIDI::messageType_t::controlChange) >> 4;
+        sending.Data1 = static_cast<uint8_t>(MIDI::messageType_t::controlChange);
+        sending.Data2 = i;
+        sending.Data3 = 0x7F;
+
+        TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    }
+
+    TEST_ASSERT(buffer.isEmpty() == true);
+    OpenDeckMIDIformat::flush(TEST_MIDI_CHANNEL);
+
+    //type, 3 events and crc, 2 extra bytes for zero in first event and delimiter
+    TEST_ASSERT(buffer.count() == (1 + 12 + 1 + 2));
+
+    for (int i = 0; i < 3; i++)
+    {
+        TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+        TEST_ASSERT(receivedPacketType == OpenDeckMIDIformat::packetType_t::midi);
+        TEST_ASSERT(receiving.Data2 == i);
+        TEST_ASSERT(receiving.Data3 == 0x7F);
+    }
+
+    //half of the window has been read - credit should be granted
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::credit));
+    TEST_ASSERT(receiving.Data1 == 3);
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == false);
+
+    //corrupt one byte in a frame: entire frame should be dropped and the next one read correctly
+    sending.Data2 = 0x10;
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    OpenDeckMIDIformat::flush(TEST_MIDI_CHANNEL);
+
+    size_t  frameSize = buffer.count();
+    uint8_t data;
+
+    for (size_t i = 0; i < frameSize; i++)
+    {
+        TEST_ASSERT(buffer.remove(data) == true);
+
+        if (i == 3)
+            data ^= 0x01;
+
+        TEST_ASSERT(buffer.insert(data) == true);
+    }
+
+    sending.Data2 = 0x20;
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    OpenDeckMIDIformat::flush(TEST_MIDI_CHANNEL);
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receiving.Data2 == 0x20);
+
+    OpenDeckMIDIformat::stats_t local;
+    OpenDeckMIDIformat::stats_t remote;
+
+    OpenDeckMIDIformat::stats(TEST_MIDI_CHANNEL, local, remote);
+    TEST_ASSERT(local.invalid == 1);
+    TEST_ASSERT(local.overrun == 0);
+
+    //frame is sent immediately when the link is idle
+    txEmpty = true;
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    TEST_ASSERT(buffer.isEmpty() == false);
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+
+    //legacy internal command means that the other side has restarted - legacy format should be used again
+    rebootType = Board::rebootType_t::rebootBtldr;
+    sending.Event = static_cast<uint8_t>(OpenDeckMIDIformat::command_t::appReboot);
+
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, static_cast<uint8_t>(OpenDeckMIDIformat::packetType_t::internalCommand)));
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, sending.Event));
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, 0x00));
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, 0x00));
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, 0x00));
+    TEST_ASSERT(true == Board::UART::write(TEST_MIDI_CHANNEL, sending.Event));
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receivedPacketType == OpenDeckMIDIformat::packetType_t::internalCommand);
+    TEST_ASSERT(rebootType == Board::rebootType_t::rebootApp);
+
+    sending.Event = static_cast<uint8_t>(MIDI::messageType_t::noteOn);
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    TEST_ASSERT(buffer.count() == 6);
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(MIDI::messageType_t::noteOn));
+}
+
+TEST_CASE(Credits)
+{
+    MIDI::USBMIDIpacket_t            sending;
+    MIDI::USBMIDIpacket_t            receiving;
+    OpenDeckMIDIformat::packetType_t receivedPacketType;
+    OpenDeckMIDIformat::stats_t      local;
+    OpenDeckMIDIformat::stats_t      remote;
+
+    buffer.reset();
+
+    //request, enable and initial credit
+    OpenDeckMIDIformat::requestFraming(TEST_MIDI_CHANNEL);
+
+    for (int i = 0; i < 3; i++)
+        TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::credit));
+
+    OpenDeckMIDIformat::stats(TEST_MIDI_CHANNEL, local, remote);
+    uint16_t overrun = local.overrun;
+
+    txEmpty       = false;
+    sending.Event = static_cast<uint8_t>(MIDI::messageType_t::noteOn) >> 4;
+    sending.Data1 = static_cast<uint8_t>(MIDI::messageType_t::noteOn);
+    sending.Data3 = 0x7F;
+
+    for (int i = 0; i < OD_FORMAT_CREDIT_WINDOW; i++)
+    {
+        TEST_ASSERT(OpenDeckMIDIformat::canWrite(TEST_MIDI_CHANNEL) == true);
+        sending.Data2 = i;
+        TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+    }
+
+    //the other side could drop the event now, but it's still sent
+    TEST_ASSERT(OpenDeckMIDIformat::canWrite(TEST_MIDI_CHANNEL) == false);
+    sending.Data2 = OD_FORMAT_CREDIT_WINDOW;
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::midi) == true);
+
+    OpenDeckMIDIformat::stats(TEST_MIDI_CHANNEL, local, remote);
+    TEST_ASSERT(local.overrun == overrun + 1);
+
+    //internal commands don't need credit
+    sending.Event = static_cast<uint8_t>(OpenDeckMIDIformat::command_t::fwUpdated);
+    TEST_ASSERT(OpenDeckMIDIformat::write(TEST_MIDI_CHANNEL, sending, OpenDeckMIDIformat::packetType_t::internalCommand) == true);
+
+    OpenDeckMIDIformat::stats(TEST_MIDI_CHANNEL, local, remote);
+    TEST_ASSERT(local.overrun == overrun + 1);
+
+    for (int i = 0; i <= OD_FORMAT_CREDIT_WINDOW; i++)
+    {
+        TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+        TEST_ASSERT(receivedPacketType == OpenDeckMIDIformat::packetType_t::midi);
+        TEST_ASSERT(receiving.Data2 == i);
+    }
+
+    TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+    TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::fwUpdated));
+
+    //two credits have been granted while reading
+    for (int i = 0; i < 2; i++)
+    {
+        TEST_ASSERT(OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType) == true);
+        TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::credit));
+    }
+
+    TEST_ASSERT(OpenDeckMIDIformat::canWrite(TEST_MIDI_CHANNEL) == true);
+
+    //changed counters are reported on flush
+    OpenDeckMIDIformat::flush(TEST_MIDI_CHANNEL);
+
+    while (OpenDeckMIDIformat::read(TEST_MIDI_CHANNEL, receiving, receivedPacketType))
+        TEST_ASSERT(receiving.Event == static_cast<uint8_t>(OpenDeckMIDIformat::command_t::linkStats));
+
+    OpenDeckMIDIformat::stats(TEST_MIDI_CHANNEL, local, remote);
+    TEST_ASSERT(remote.overrun == local.overrun);
+    TEST_ASSERT(remote.invalid == local.invalid);
+
+    txEmpty = true;
+}
+
 #endif
 #endif
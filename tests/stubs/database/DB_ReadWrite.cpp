@@ -107,6 +107,8 @@ bool DBstorageMock::read(uint32_t address, int32_t& value, LESSDB::sectionParame
 
 bool DBstorageMock::write(uint32_t address, int32_t value, LESSDB::sectionParameterType_t type)
 {
+    writeCount++;
+
 #ifndef STM32_EMU_EEPROM
     switch (type)
     {
@@ -157,6 +159,8 @@ bool DBstorageMock::write(uint32_t address, int32_t value, LESSDB::sectionParame
 
 void DBstorageMock::clear()
 {
+    writeCount = 0;
+
 #ifndef STM32_EMU_EEPROM
     memset(memoryArray, 0x00, DATABASE_SIZE);
 #else
@@ -26,6 +26,9 @@ class DBstorageMock : public LESSDB::StorageAccess
     bool     read(uint32_t address, int32_t& value, LESSDB::sectionParameterType_t type) override;
     bool     write(uint32_t address, int32_t value, LESSDB::sectionParameterType_t type) override;
 
+    //number of write calls since the last clear, used to measure initialization cost
+    size_t writeCount = 0;
+
     private:
 #ifdef STM32_EMU_EEPROM
     class EmuEEPROMStorageAccess : public EmuEEPROM::StorageAccess